@@ -0,0 +1,24 @@
+# Converts a binary file to a C++ header containing its bytes.
+# Usage: cmake -DINPUT=<file> -DOUTPUT=<header> -DVAR_NAME=<name> -P cmake_embed_file.cmake
+
+if (NOT DEFINED INPUT OR NOT DEFINED OUTPUT OR NOT DEFINED VAR_NAME)
+  message(FATAL_ERROR "INPUT, OUTPUT and VAR_NAME must be defined!")
+endif()
+
+# Read the file as an hexadecimal string
+file(READ "${INPUT}" fileContent HEX)
+string(LENGTH "${fileContent}" fileSize)
+math(EXPR fileSize "${fileSize} / 2")
+# Transform each byte into '0x??,'
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," fileContent "${fileContent}")
+
+file(WRITE "${OUTPUT}"
+  "/** @file Generated by cmake_embed_file.cmake, DO NOT EDIT.\n*/\n\n"
+  "#ifndef HG_${VAR_NAME}\n"
+  "#define HG_${VAR_NAME}\n\n"
+  "/// @brief The embedded content of '${INPUT}'\n"
+  "alignas(16) inline constexpr unsigned char ${VAR_NAME}[] = { ${fileContent} };\n"
+  "/// @brief The size of the embedded content\n"
+  "inline constexpr unsigned long long ${VAR_NAME}_SIZE = ${fileSize};\n\n"
+  "#endif //!HG_${VAR_NAME}\n"
+)
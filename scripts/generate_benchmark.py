@@ -0,0 +1,71 @@
+# Generates large synthetic Colt programs used to benchmark the compiler.
+# The size of the programs is configurable: count of functions, count of
+# local variables and of literals per function, nesting depth of the
+# conditions and count of string literals.
+# Usage: python generate_benchmark.py -functions 100 -locals 50 -o bench.ct
+
+import argparse
+import random
+import sys
+
+
+def generate_function(out, index, locals, literals, depth, strings, rng):
+	out.append(f"fn f{index}(i64 a, i64 b)->i64\n{{\n")
+	locals = max(locals, 1)
+	for i in range(locals):
+		# Reading a previous local exercises the lookup of local variables
+		init = f"l{rng.randrange(i)} + a" if i != 0 else "a + b"
+		out.append(f"  var mut l{i} = {init};\n")
+
+	# The literals and strings are distributed in the innermost scope
+	indent = "  "
+	for level in range(depth):
+		out.append(f"{indent}if l{rng.randrange(locals)} < {rng.randrange(1000)}i64\n{indent}{{\n")
+		indent += "  "
+	for _ in range(literals):
+		dest = rng.randrange(locals)
+		source = rng.randrange(locals)
+		out.append(f"{indent}l{dest} = l{source} + {rng.randrange(1000)}i64;\n")
+	for i in range(strings):
+		out.append(f"{indent}_ColtPrintlstring(\"f{index}: string literal {i}\");\n")
+	for level in range(depth):
+		indent = indent[:-2]
+		out.append(f"{indent}}}\n")
+
+	# Calling the previous function exercises the lookup of functions
+	if index != 0:
+		out.append(f"  l0 = l0 + f{index - 1}(l{rng.randrange(locals)}, b);\n")
+	out.append(f"  return l{rng.randrange(locals)};\n}}\n\n")
+
+
+def generate_program(functions, locals, literals, depth, strings, seed=0):
+	"""Returns the source code of a synthetic program."""
+	rng = random.Random(seed)
+	functions = max(functions, 1)
+	out = ["//Generated by 'scripts/generate_benchmark.py'\n"]
+	out.append("extern fn _ColtPrintlstring(lstring a)->void;\n\n")
+	for i in range(functions):
+		# The string literals are spread over the functions
+		fn_strings = strings // functions + (1 if i < strings % functions else 0)
+		generate_function(out, i, locals, literals, depth, fn_strings, rng)
+	out.append(f"fn main()->i64: return f{functions - 1}(1i64, 2i64);\n")
+	return "".join(out)
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Generates a synthetic Colt program.")
+	parser.add_argument("-functions", type=int, default=100, help="count of functions")
+	parser.add_argument("-locals", type=int, default=16, help="count of local variables per function")
+	parser.add_argument("-literals", type=int, default=32, help="count of literals (assignments) per function")
+	parser.add_argument("-depth", type=int, default=2, help="nesting depth of the conditions of each function")
+	parser.add_argument("-strings", type=int, default=0, help="count of string literals in the program")
+	parser.add_argument("-seed", type=int, default=0, help="seed of the random generator")
+	parser.add_argument("-o", default=None, help="output file (standard output if not specified)")
+	args = parser.parse_args()
+
+	program = generate_program(args.functions, args.locals, args.literals, args.depth, args.strings, args.seed)
+	if args.o is None:
+		sys.stdout.write(program)
+	else:
+		with open(args.o, "w") as file:
+			file.write(program)
@@ -0,0 +1,166 @@
+# Times each phase of the compiler on large synthetic programs.
+# Each benchmark is compiled at its size and at twice its size: a phase whose
+# time grows faster than the size (quadratic behaviors) is reported.
+# The results are saved as '<out>/results/<commit>.json', which can be
+# compared with the results of another commit using '-baseline'.
+# Usage: python run_benchmarks.py -colt build/colt -out build/benchmarks [-baseline <file>]
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import time
+
+from generate_benchmark import generate_program
+
+# Each benchmark stresses one dimension of the programs, which is doubled
+# to measure the growth of the time of each phase
+BENCHMARKS = {
+	"functions": ("functions", dict(functions=2000, locals=4, literals=8, depth=1, strings=0)),
+	"locals":    ("locals", dict(functions=4, locals=2000, literals=16, depth=1, strings=0)),
+	"literals":  ("literals", dict(functions=8, locals=8, literals=10000, depth=1, strings=0)),
+	"nesting":   ("depth", dict(functions=32, locals=8, literals=16, depth=100, strings=0)),
+	"strings":   ("strings", dict(functions=32, locals=4, literals=8, depth=1, strings=10000)),
+}
+
+# The phases timed by the compiler ('-json-stats')
+PHASES = ["parse", "generate", "optimize", "emit"]
+
+# Growth exponents above this are reported as superlinear
+MAX_GROWTH = 1.5
+# Phases faster than this (in seconds) are too noisy to measure their growth
+MIN_GROWTH_TIME = 0.05
+
+
+def get_commit():
+	try:
+		return subprocess.check_output(["git", "rev-parse", "--short", "HEAD"], text=True).strip()
+	except (OSError, subprocess.CalledProcessError):
+		return "unknown"
+
+
+def scaled(config, scale):
+	return {key: max(int(value * scale), 1 if key != "strings" else 0) for key, value in config.items()}
+
+
+def compile_once(colt, source, out_dir):
+	stats_path = os.path.join(out_dir, "stats.json")
+	object_path = os.path.join(out_dir, "bench.o")
+	begin = time.perf_counter()
+	result = subprocess.run([colt, source, "-no-color", "-no-wait", "-no-warn",
+		"-json-stats", stats_path, "-o", object_path],
+		stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+	wall = time.perf_counter() - begin
+	stats = None
+	if os.path.exists(stats_path):
+		with open(stats_path) as file:
+			stats = json.load(file)
+		os.remove(stats_path)
+	# The statistics of the IR are only written if the program compiled
+	if result.returncode != 0 or stats is None or "optimized_ir" not in stats:
+		print(result.stdout)
+		sys.exit(f"-- FATAL: compilation of '{source}' failed!")
+	stats["seconds"]["wall"] = wall
+	return stats
+
+
+def run_benchmark(colt, name, config, out_dir, repeat):
+	source = os.path.join(out_dir, f"{name}.ct")
+	with open(source, "w") as file:
+		file.write(generate_program(**config))
+	# The minimum of each phase is the least noisy measure
+	best = None
+	for _ in range(repeat):
+		stats = compile_once(colt, source, out_dir)
+		if best is None:
+			best = stats
+		else:
+			for phase, seconds in stats["seconds"].items():
+				best["seconds"][phase] = min(best["seconds"][phase], seconds)
+	return {
+		"config": config,
+		"seconds": best["seconds"],
+		"tokens": best["tokens"],
+		"peak_rss_bytes": best["peak_rss_bytes"],
+		"instructions": best.get("optimized_ir", {}).get("instructions", 0),
+	}
+
+
+def print_growth(name, small, large):
+	superlinear = []
+	for phase in PHASES + ["wall"]:
+		t1 = small["seconds"][phase]
+		t2 = large["seconds"][phase]
+		if t2 < MIN_GROWTH_TIME or t1 <= 0:
+			continue
+		growth = math.log2(t2 / t1)
+		if growth > MAX_GROWTH:
+			superlinear.append(phase)
+			print(f"-- WARNING: '{name}': phase '{phase}' grows as size^{growth:.2f} ({t1:.4f}s -> {t2:.4f}s)")
+	return superlinear
+
+
+def compare(results, baseline, threshold):
+	regressions = []
+	for name, result in results["benchmarks"].items():
+		if name not in baseline["benchmarks"]:
+			continue
+		old = baseline["benchmarks"][name]
+		for phase in PHASES + ["wall"]:
+			t_new = result["large"]["seconds"][phase]
+			t_old = old["large"]["seconds"][phase]
+			if t_old < MIN_GROWTH_TIME and t_new < MIN_GROWTH_TIME:
+				continue
+			ratio = t_new / max(t_old, 1e-9)
+			print(f"-- {name:<10} {phase:<9} {t_old:9.4f}s -> {t_new:9.4f}s ({ratio:5.2f}x)")
+			if ratio > threshold:
+				regressions.append(f"{name}/{phase}")
+	return regressions
+
+
+if __name__ == "__main__":
+	parser = argparse.ArgumentParser(description="Times each phase of the Colt compiler on synthetic programs.")
+	parser.add_argument("-colt", required=True, help="path of the Colt executable")
+	parser.add_argument("-out", default="build/benchmarks", help="directory of the programs and of the results")
+	parser.add_argument("-baseline", default=None, help="results of another commit to compare with")
+	parser.add_argument("-threshold", type=float, default=1.2, help="slowdown ratio reported as a regression")
+	parser.add_argument("-scale", type=float, default=1.0, help="multiplies the size of the programs")
+	parser.add_argument("-repeat", type=int, default=3, help="count of compilations of each program")
+	args = parser.parse_args()
+
+	corpus_dir = os.path.join(args.out, "corpus")
+	results_dir = os.path.join(args.out, "results")
+	os.makedirs(corpus_dir, exist_ok=True)
+	os.makedirs(results_dir, exist_ok=True)
+
+	commit = get_commit()
+	results = {"commit": commit, "scale": args.scale, "benchmarks": {}}
+	superlinear = []
+	for name, (dimension, config) in BENCHMARKS.items():
+		print(f"-- Running benchmark '{name}'...")
+		config = scaled(config, args.scale)
+		doubled = dict(config, **{dimension: config[dimension] * 2})
+		small = run_benchmark(args.colt, name, config, corpus_dir, args.repeat)
+		large = run_benchmark(args.colt, name + "_x2", doubled, corpus_dir, args.repeat)
+		results["benchmarks"][name] = {"small": small, "large": large}
+		print("-- " + ", ".join(f"{phase} {large['seconds'][phase]:.4f}s" for phase in PHASES + ["wall"]))
+		superlinear += [f"{name}/{phase}" for phase in print_growth(name, small, large)]
+
+	results_path = os.path.join(results_dir, f"{commit}.json")
+	with open(results_path, "w") as file:
+		json.dump(results, file, indent=2)
+	print(f"-- Results written to '{results_path}'")
+
+	regressions = []
+	if args.baseline is not None:
+		with open(args.baseline) as file:
+			baseline = json.load(file)
+		print(f"-- Comparing with commit '{baseline['commit']}':")
+		regressions = compare(results, baseline, args.threshold)
+		for regression in regressions:
+			print(f"-- REGRESSION: {regression}")
+
+	if superlinear or regressions:
+		sys.exit(1)
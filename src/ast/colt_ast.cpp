@@ -3,12 +3,25 @@
 */
 
 #include "colt_ast.h"
+#include "colt_module.h"
 
 namespace colt::lang
 {
+  void AddModuleObject(StringView path, AST& ast) noexcept
+  {
+    for (size_t i = 0; i < ast.module_objects.get_size(); i++)
+      if (StringView{ ast.module_objects[i] } == path)
+        return;
+    String object;
+    object += path;
+    ast.module_objects.push_back(std::move(object));
+  }
+
   Expected<AST, u32> CreateAST(StringView from, COLTContext& ctx) noexcept
   {
     AST result = { ctx };
+    //Reports are written at once when parsing ends, sorted by location
+    ReportSink sink;
     ASTMaker ast = { from, result };
     if (ast.is_empty() || ast.get_error_count() != 0)
       return { Error, ast.get_error_count() };
@@ -19,6 +32,7 @@ namespace colt::lang
   bool CompileAndAdd(StringView str, AST& ast) noexcept
   {
     u64 crr = ast.expressions.get_size();
+    ReportSink sink;
     if (ASTMaker astm = { str, ast };
       astm.get_error_count() != 0)
     {
@@ -65,6 +79,19 @@ namespace colt::lang
       return isFnTerminated(cond->get_if_statement())
         && isFnTerminated(cond->get_else_statement());
     }
+    case Expr::EXPR_SWITCH:
+    {
+      PTR<const SwitchExpr> sw = as<PTR<const SwitchExpr>>(expr);
+
+      if (sw->get_default() == nullptr)
+        return false;
+      for (auto body : sw->get_case_bodies())
+      {
+        if (!isFnTerminated(body))
+          return false;
+      }
+      return isFnTerminated(sw->get_default());
+    }
     //TODO: add support for [[noreturn]]
     case Expr::EXPR_FN_CALL:
     default:
@@ -94,6 +121,19 @@ namespace colt::lang
       return isLoopTerminated(cond->get_if_statement())
         && isLoopTerminated(cond->get_else_statement());
     }
+    case Expr::EXPR_SWITCH:
+    {
+      PTR<const SwitchExpr> sw = as<PTR<const SwitchExpr>>(expr);
+
+      if (sw->get_default() == nullptr)
+        return false;
+      for (auto body : sw->get_case_bodies())
+      {
+        if (!isLoopTerminated(body))
+          return false;
+      }
+      return isLoopTerminated(sw->get_default());
+    }
     //TODO: add support for [[noreturn]]
     case Expr::EXPR_FN_CALL:
     default:
@@ -121,6 +161,19 @@ namespace colt::lang
       return isTerminated(cond->get_if_statement())
         && isTerminated(cond->get_else_statement());
     }
+    case Expr::EXPR_SWITCH:
+    {
+      PTR<const SwitchExpr> sw = as<PTR<const SwitchExpr>>(expr);
+
+      if (sw->get_default() == nullptr)
+        return false;
+      for (auto body : sw->get_case_bodies())
+      {
+        if (!isTerminated(body))
+          return false;
+      }
+      return isTerminated(sw->get_default());
+    }
     //TODO: add support for [[noreturn]]
     case Expr::EXPR_FN_CALL:
     default:
@@ -128,6 +181,48 @@ namespace colt::lang
     }
   }
 
+  bool isAddressable(PTR<const Expr> expr) noexcept
+  {
+    return is_a<VarReadExpr>(expr) || is_a<PtrLoadExpr>(expr);
+  }
+
+  bool isLiteralInRange(PTR<const Expr> expr, u64 max) noexcept
+  {
+    if (!is_a<LiteralExpr>(expr) || !expr->get_type()->is_semantically_integral())
+      return false;
+    u64 bit_size = expr->get_type()->get_sizeof() * 8;
+    if (bit_size > 64)
+      return false;
+    
+    u64 value = as<PTR<const LiteralExpr>>(expr)->get_value().as<u64>();
+    //Only keep the bits of the type of the literal
+    if (bit_size < 64)
+      value &= (1ULL << bit_size) - 1;
+    //Negative values are never in range
+    if (expr->get_type()->is_signed_int() && (value >> (bit_size - 1)) != 0)
+      return false;
+    return value < max;
+  }
+
+  Optional<VecIntrinsicExpr::VecIntrinsicID> StringToVecIntrinsic(StringView name) noexcept
+  {
+    using VecI = VecIntrinsicExpr;
+    const std::pair<StringView, VecIntrinsicExpr::VecIntrinsicID> table[] = {
+      { "shuffle", VecI::VEC_SHUFFLE },
+      { "reduce_add", VecI::VEC_REDUCE_ADD }, { "reduce_mul", VecI::VEC_REDUCE_MUL },
+      { "reduce_min", VecI::VEC_REDUCE_MIN }, { "reduce_max", VecI::VEC_REDUCE_MAX },
+      { "reduce_and", VecI::VEC_REDUCE_AND }, { "reduce_or", VecI::VEC_REDUCE_OR },
+      { "reduce_xor", VecI::VEC_REDUCE_XOR },
+      { "load_masked", VecI::VEC_LOAD_MASKED }, { "store_masked", VecI::VEC_STORE_MASKED }
+    };
+    for (auto& [str, intrinsic] : table)
+    {
+      if (str == name)
+        return intrinsic;
+    }
+    return None;
+  }
+
   SourceCodeExprInfo ConcatInfo(const SourceCodeExprInfo& lhs, const SourceCodeExprInfo& rhs) noexcept
   {
     return SourceCodeExprInfo{ lhs.line_begin, rhs.line_end,
@@ -175,11 +270,144 @@ namespace colt::lang
   }
 
   ASTMaker::ASTMaker(StringView strv, AST& ast) noexcept
-    : expressions(ast.expressions), lexer(strv), global_map(ast.global_map), str_table(ast.str_table), ctx(ast.ctx)
+    : expressions(ast.expressions), lexer(strv), global_map(ast.global_map), str_table(ast.str_table), ctx(ast.ctx), ast(ast)
+  {
+    //Expressions store their location relative to the sources of the context
+    ctx.add_source(strv);
+    current_tkn = lexer.get_next_token();
+    //With '-parallel-parse', the bodies are lexed by 'skip_scope' before
+    //being parsed by the workers: their tokens are only counted here
+    ON_EXIT{ ctx.add_token_count(lexer.get_token_count()); };
+    if (args::ParallelParse)
+    {
+      parse_parallel();
+      return;
+    }
+    //Stops early on hopeless inputs ('-error-limit')
+    while (current_tkn != TKN_EOF && !IsErrorLimitReached())
+    {
+      if (current_tkn == TKN_KEYWORD_IMPORT)
+        parse_import();
+      else
+        expressions.push_back(parse_global_declaration());
+    }
+  }
+
+  ASTMaker::ASTMaker(ASTMaker& parent, COLTContext& shard) noexcept
+    : expressions(parent.expressions), lexer(parent.lexer), global_map(parent.global_map),
+    str_table(parent.str_table), ctx(shard), ast(parent.ast), str_table_mutex(parent.str_table_mutex)
+  {
+    lexer.set_report_errors(true);
+  }
+
+  void ASTMaker::parse_parallel() noexcept
   {
+    is_deferring_bodies = true;
+    //Stops early on hopeless inputs ('-error-limit')
+    while (current_tkn != TKN_EOF && !IsErrorLimitReached())
+    {
+      if (current_tkn == TKN_KEYWORD_IMPORT)
+        parse_import();
+      else
+        expressions.push_back(parse_global_declaration());
+    }
+    is_deferring_bodies = false;
+    if (deferred_bodies.is_empty() || IsErrorLimitReached())
+      return;
+
+    size_t thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+      deferred_bodies.get_size());
+    //A COLTContext is not thread-safe: each thread stores its expressions in a shard
+    Vector<PTR<COLTContext>> shards;
+    for (size_t i = 0; i < thread_count; i++)
+      shards.push_back(&ctx.add_shard());
+
+    std::mutex mutex;
+    str_table_mutex = &mutex;
+    ON_EXIT{ str_table_mutex = nullptr; };
+
+    //Bodies are distributed one at a time, as their sizes vary
+    std::atomic<size_t> next_body = 0;
+    std::vector<std::pair<u16, u16>> counts(thread_count);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; i++)
+    {
+      threads.emplace_back([&, i]()
+        {
+          ASTMaker worker = { *this, *shards[i] };
+          for (size_t j = next_body++; j < deferred_bodies.get_size() && !IsErrorLimitReached(); j = next_body++)
+            worker.parse_deferred_body(deferred_bodies[j]);
+          counts[i] = { worker.error_count, worker.warn_count };
+        });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    for (auto& [errors, warnings] : counts)
+    {
+      error_count += errors;
+      warn_count += warnings;
+    }
+    for (auto shard : shards)
+      ctx.add_stats(shard->get_stats());
+  }
+
+  void ASTMaker::parse_deferred_body(const DeferredBody& body) noexcept
+  {
+    lexer.seek(body.offset, body.line_nb);
     current_tkn = lexer.get_next_token();
+    assert_true(is_valid_scope_begin(), "Invalid deferred body!");
+
+    current_function = body.definition->get_fn_decl();
+    ON_EXIT{ current_function = nullptr; };
+    body.definition->set_body(parse_fn_body(current_function));
+  }
+
+  void ASTMaker::skip_scope() noexcept
+  {
+    assert(is_valid_scope_begin());
+
+    //Errors of the lexer are reported when parsing the body
+    lexer.set_report_errors(false);
+    if (current_tkn == TKN_LEFT_CURLY)
+    {
+      u64 depth = 0;
+      while (current_tkn != TKN_EOF)
+      {
+        if (current_tkn == TKN_LEFT_CURLY)
+          ++depth;
+        else if (current_tkn == TKN_RIGHT_CURLY && --depth == 0)
+          break;
+        consume_current_tkn();
+      }
+      //The token following the body is reported normally
+      lexer.set_report_errors(true);
+      if (current_tkn == TKN_RIGHT_CURLY)
+        consume_current_tkn();
+      return;
+    }
+
+    consume_current_tkn(); // ':'
+    u64 depth = 0;
     while (current_tkn != TKN_EOF)
-      expressions.push_back(parse_global_declaration());
+    {
+      const bool is_end = (current_tkn == TKN_SEMICOLON && depth == 0)
+        || (current_tkn == TKN_RIGHT_CURLY && depth != 0 && --depth == 0);
+      if (current_tkn == TKN_LEFT_CURLY)
+        ++depth;
+      if (!is_end)
+      {
+        consume_current_tkn();
+        continue;
+      }
+      //The token following the body is reported normally
+      lexer.set_report_errors(true);
+      consume_current_tkn();
+      //The branches of a condition are part of the statement
+      if (current_tkn != TKN_KEYWORD_ELIF && current_tkn != TKN_KEYWORD_ELSE)
+        return;
+      lexer.set_report_errors(false);
+    }
+    lexer.set_report_errors(true);
   }
 
   void ASTMaker::consume_current_tkn() noexcept
@@ -209,7 +437,7 @@ namespace colt::lang
       //If the token is a string literal, we save it to
       //the global string table.
       if (current_tkn == TKN_STRING_L)
-        value = str_table.insert(lexer.get_string_literal()).first;
+        value = insert_str_literal(lexer.get_string_literal());
       else
         value = lexer.get_parsed_value();
 
@@ -272,6 +500,10 @@ namespace colt::lang
       to_ret = ErrorExpr::CreateExpr(ctx);
     }
 
+    //Postfix indexing: a[i][j]
+    while (current_tkn == TKN_LEFT_SQUARE)
+      to_ret = parse_index(to_ret, line_state);
+
     if (cnv && (current_tkn == TKN_KEYWORD_AS
       || current_tkn == TKN_KEYWORD_BIT_AS)) // EXPR as TYPE <- conversion
       return parse_conversion(to_ret, line_state);
@@ -304,9 +536,14 @@ namespace colt::lang
       PTR<Expr> rhs = parse_binary(getOpPrecedence(binary_op));
 
       //Pratt's parsing, which allows operators priority
-      lhs = create_binary(
-        isComparisonToken(binary_op) ? BuiltInType::CreateBool(false, ctx) : lhs->get_type(),
-        lhs, binary_op, rhs,
+      PTR<const Type> expr_type = lhs->get_type();
+      //Comparisons of vectors result in vectors of bool
+      if (isComparisonToken(binary_op))
+        expr_type = lhs->get_type()->is_vec()
+          ? VecType::CreateVec(BuiltInType::CreateBool(false, ctx),
+            as<PTR<const VecType>>(lhs->get_type())->get_count(), ctx)
+          : BuiltInType::CreateBool(false, ctx);
+      lhs = create_binary(expr_type, lhs, binary_op, rhs,
         line_state.to_src_info());
 
       //Update the Token
@@ -519,6 +756,27 @@ namespace colt::lang
     }
   }
 
+  void ASTMaker::parse_import() noexcept
+  {
+    SavedExprInfo line_state = { *this };
+
+    assert(current_tkn == TKN_KEYWORD_IMPORT);
+
+    consume_current_tkn();
+    auto module_name = lexer.get_parsed_identifier();
+
+    if (check_and_consume(TKN_IDENTIFIER, &ASTMaker::panic_consume_var_decl,
+      "Expected the name of a module, not '{}'!", lexer.get_current_lexeme()))
+      return;
+    if (check_and_consume(TKN_SEMICOLON, &ASTMaker::panic_consume_var_decl,
+      "Expected a ';'!"))
+      return;
+    
+    if (auto result = ImportModule(module_name, ast); result.is_error())
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Could not import module '{}': {}", module_name, result.get_error());
+  }
+
   PTR<Expr> ASTMaker::parse_fn_decl(bool is_extern) noexcept
   {
     SavedExprInfo line_state = { *this };
@@ -592,39 +850,32 @@ namespace colt::lang
     if (declaration->is_main()
       && !is_cpp_equivalent<i64(*)(void)>(fn_ptr_t))
     {
-      generate_any<report_as::ERROR>(declaration->get_src_code(), &ASTMaker::panic_consume_fn_decl,
+      generate_any<report_as::ERROR>(get_src_info(declaration), &ASTMaker::panic_consume_fn_decl,
         "Function 'main' should be declared as 'fn main()->i64'!");
       return ErrorExpr::CreateExpr(ctx);
     }
 
     if (is_valid_scope_begin() && !is_extern && !is_vararg)
     {
-      SavedLocalState local_state = { *this };
-      //Create arguments in local variables table
-      for (size_t i = 0; i < declaration->get_params_count(); i++)
-        local_var_table.push_back({ declaration->get_params_name()[i], declaration->get_params_type()[i] });
-
-      auto body = parse_scope();
-      if (!current_function->get_return_type()->is_void() && !declaration->is_main())
-        validate_all_path_return(body);
-      //If a return is not present at the end of the void function,
-      //add one. As parse_scope can return ErrorExpr or ScopeExpr,
-      //do necessary check
-      else if (is_a<ScopeExpr>(body) && !isFnTerminated(body))
-      {
-        //If main has no return, add 'return 0'
-        //If function is not main, (and returns void) add 'return void'
-        as<PTR<ScopeExpr>>(body)->push_back(FnReturnExpr::CreateExpr(
-          !declaration->is_main() ? nullptr :
-          LiteralExpr::CreateValue(0LL, ctx), {}, ctx)
-        );
+      //The body is parsed once all the declarations are known
+      if (is_deferring_bodies)
+      {
+        DeferredBody deferred = { nullptr, lexer.get_lexeme_offset(), lexer.get_current_line() };
+        skip_scope();
+        //The empty scope is replaced once the body is parsed
+        auto definition = FnDefExpr::CreateExpr(declaration,
+          ScopeExpr::CreateExpr(Vector<PTR<Expr>>{}, line_state.to_src_info(), ctx),
+          line_state.to_src_info(), ctx);
+        deferred.definition = as<PTR<FnDefExpr>>(definition);
+        deferred_bodies.push_back(deferred);
+        return definition;
       }
-
+      auto body = parse_fn_body(declaration);
       return FnDefExpr::CreateExpr(declaration, body, line_state.to_src_info(), ctx);
     }
     if (!is_extern && is_vararg)
     {
-      generate_any<report_as::ERROR>(declaration->get_src_code(), &ASTMaker::panic_consume_fn_decl,
+      generate_any<report_as::ERROR>(get_src_info(declaration), &ASTMaker::panic_consume_fn_decl,
         "Function using C-style variadic can only be extern!");
       return ErrorExpr::CreateExpr(ctx);
     }
@@ -632,7 +883,35 @@ namespace colt::lang
     return FnDefExpr::CreateExpr(declaration, line_state.to_src_info(), ctx);
   }
 
-  PTR<Expr> ASTMaker::parse_scope(bool one_expr) noexcept
+  PTR<Expr> ASTMaker::parse_fn_body(PTR<const FnDeclExpr> declaration) noexcept
+  {
+    SavedLocalState local_state = { *this };
+    //Create arguments in local variables table
+    for (size_t i = 0; i < declaration->get_params_count(); i++)
+      local_var_table.push_back({ InternSymbol(declaration->get_params_name()[i]), declaration->get_params_type()[i] });
+
+    const bool needs_return = !declaration->get_return_type()->is_void() && !declaration->is_main();
+    //If a return is not present at the end of the void function,
+    //parse_scope adds one
+    auto body = parse_scope(true, needs_return ? nullptr : declaration);
+    if (needs_return)
+      validate_all_path_return(body);
+    return body;
+  }
+
+  void ASTMaker::add_implicit_return(Vector<PTR<Expr>>& statements, PTR<const FnDeclExpr> fn_body) noexcept
+  {
+    if (fn_body == nullptr || isFnTerminated(statements.get_back()))
+      return;
+    //If main has no return, add 'return 0'
+    //If function is not main, (and returns void) add 'return void'
+    statements.push_back(FnReturnExpr::CreateExpr(
+      !fn_body->is_main() ? nullptr :
+      LiteralExpr::CreateValue(0LL, ctx), {}, ctx)
+    );
+  }
+
+  PTR<Expr> ASTMaker::parse_scope(bool one_expr, PTR<const FnDeclExpr> fn_body) noexcept
   {
     SavedExprInfo line_state = { *this };
     
@@ -642,6 +921,7 @@ namespace colt::lang
 
       Vector<PTR<Expr>> statements = {};
       statements.push_back(parse_statement());
+      add_implicit_return(statements, fn_body);
       //We still want to return a ScopeExpr even for a single expression
       return ScopeExpr::CreateExpr(std::move(statements),
         line_state.to_src_info(), ctx);
@@ -653,7 +933,7 @@ namespace colt::lang
       consume_current_tkn(); // '{'
 
       Vector<PTR<Expr>> statements = {};
-      while (current_tkn != TKN_RIGHT_CURLY && current_tkn != TKN_EOF)
+      while (current_tkn != TKN_RIGHT_CURLY && current_tkn != TKN_EOF && !IsErrorLimitReached())
       {
         auto stt = parse_statement();
         statements.push_back(stt);
@@ -672,6 +952,7 @@ namespace colt::lang
       //If empty scope, push a no-op
       if (statements.is_empty())
         statements.push_back(NoOpExpr::CreateExpr(line_state.to_src_info(), ctx));
+      add_implicit_return(statements, fn_body);
 
       return ScopeExpr::CreateExpr(std::move(statements),
         line_state.to_src_info(), ctx);
@@ -701,8 +982,12 @@ namespace colt::lang
       return parse_scope(false);
     case TKN_KEYWORD_IF:
       return parse_condition();
+    case TKN_KEYWORD_SWITCH:
+      return parse_switch();
     case TKN_KEYWORD_WHILE:
       return parse_while();
+    case TKN_KEYWORD_FOR:
+      return parse_for();
     break; case TKN_KEYWORD_RETURN:
       return parse_return();
 
@@ -718,7 +1003,7 @@ namespace colt::lang
       consume_current_tkn();
       if (!is_parsing_loop)
       {
-        generate_any<report_as::ERROR>(to_ret->get_src_code(), nullptr, "Statement 'continue' can only appear inside a loop!");
+        generate_any<report_as::ERROR>(get_src_info(to_ret), nullptr, "Statement 'continue' can only appear inside a loop!");
         is_valid = false;
       }
 
@@ -727,7 +1012,7 @@ namespace colt::lang
       consume_current_tkn();
       if (!is_parsing_loop)
       {
-        generate_any<report_as::ERROR>(to_ret->get_src_code(), nullptr, "Statement 'break' can only appear inside a loop!");
+        generate_any<report_as::ERROR>(get_src_info(to_ret), nullptr, "Statement 'break' can only appear inside a loop!");
         is_valid = false;
       }
 
@@ -781,6 +1066,128 @@ namespace colt::lang
       line_state.to_src_info(), ctx);
   }
 
+  PTR<Expr> ASTMaker::parse_switch() noexcept
+  {
+    assert(current_tkn == TKN_KEYWORD_SWITCH);
+    SavedExprInfo line_state = { *this };
+
+    consume_current_tkn(); //consume switch
+
+    PTR<Expr> value = parse_binary();
+    bool is_valid = !is_a<ErrorExpr>(value);
+    if (is_valid && !value->get_type()->is_integral())
+    {
+      generate_any<report_as::ERROR>(get_src_info(value), nullptr,
+        "'switch' expects a value of integral type, not '{}'!", value->get_type()->get_name());
+      is_valid = false;
+    }
+
+    //Save '{' informations
+    auto lexeme_info = get_expr_info();
+    if (check_and_consume(TKN_LEFT_CURLY, &ASTMaker::panic_consume_sttmnt,
+      "Expected the beginning of the cases of 'switch' ('{{')!"))
+      return ErrorExpr::CreateExpr(ctx);
+
+    Vector<std::pair<PTR<const LiteralExpr>, u64>> case_values = {};
+    Vector<PTR<Expr>> case_bodies = {};
+    PTR<Expr> default_body = nullptr;
+
+    while (current_tkn != TKN_RIGHT_CURLY && current_tkn != TKN_EOF)
+    {
+      SavedExprInfo case_state = { *this };
+      if (current_tkn == TKN_KEYWORD_DEFAULT)
+      {
+        consume_current_tkn(); //consume default
+        PTR<Expr> body = parse_scope();
+        if (default_body != nullptr)
+        {
+          generate_any<report_as::ERROR>(case_state.to_src_info(), nullptr,
+            "'switch' can only have one 'default' case!");
+          is_valid = false;
+        }
+        default_body = body;
+      }
+      else if (current_tkn == TKN_KEYWORD_CASE)
+      {
+        //The values are checked even if 'value' is invalid
+        if (!parse_case_values(is_valid ? value : nullptr, case_values, case_bodies.get_size()))
+          is_valid = false;
+        case_bodies.push_back(parse_scope());
+      }
+      else
+      {
+        generate_any_current<report_as::ERROR>(&ASTMaker::panic_consume_case,
+          "Expected 'case' or 'default'!");
+        is_valid = false;
+      }
+    }
+
+    if (current_tkn != TKN_RIGHT_CURLY)
+      generate_any<report_as::ERROR>(lexeme_info.to_src_info(), nullptr,
+        "Unclosed curly bracket delimiter!");
+    else //consume '}'
+      consume_current_tkn();
+
+    if (!is_valid)
+      return ErrorExpr::CreateExpr(ctx);
+    return SwitchExpr::CreateExpr(value, std::move(case_values), std::move(case_bodies),
+      default_body, line_state.to_src_info(), ctx);
+  }
+
+  bool ASTMaker::parse_case_values(PTR<const Expr> value, Vector<std::pair<PTR<const LiteralExpr>, u64>>& case_values, u64 body_index) noexcept
+  {
+    assert(current_tkn == TKN_KEYWORD_CASE);
+
+    consume_current_tkn(); //consume case
+
+    bool is_valid = true;
+    // case 1, 2, 3: ...
+    for (;;)
+    {
+      PTR<Expr> case_value = parse_binary();
+      if (is_a<ErrorExpr>(case_value))
+        is_valid = false;
+      else if (!is_a<LiteralExpr>(case_value))
+      {
+        generate_any<report_as::ERROR>(get_src_info(case_value), nullptr,
+          "Value of a 'case' should be known at compile time!");
+        is_valid = false;
+      }
+      else if (value != nullptr && !case_value->get_type()->is_equal(value->get_type()))
+      {
+        generate_any<report_as::ERROR>(get_src_info(case_value), nullptr,
+          "Value of a 'case' should be of type '{}', not '{}'!",
+          value->get_type()->get_name(), case_value->get_type()->get_name());
+        is_valid = false;
+      }
+      else if (value != nullptr)
+      {
+        //Only keep the bits of the type of the literals to compare them
+        u64 bit_size = value->get_type()->get_sizeof() * 8;
+        u64 mask = bit_size < 64 ? (1ULL << bit_size) - 1 : ~0ULL;
+        auto literal = as<PTR<const LiteralExpr>>(case_value);
+        
+        for (auto& [other, index] : case_values)
+        {
+          if ((other->get_value().as<u64>() & mask) == (literal->get_value().as<u64>() & mask))
+          {
+            generate_any<report_as::ERROR>(get_src_info(case_value), nullptr,
+              "Value '{}' is already handled by a previous 'case'!", get_src_info(case_value).expression);
+            is_valid = false;
+            break;
+          }
+        }
+        if (is_valid)
+          case_values.push_back({ literal, body_index });
+      }
+      
+      if (current_tkn != TKN_COMMA)
+        break;
+      consume_current_tkn(); //consume ','
+    }
+    return is_valid;
+  }
+
   PTR<Expr> ASTMaker::parse_while() noexcept
   {
     assert(current_tkn == TKN_KEYWORD_WHILE);
@@ -796,7 +1203,7 @@ namespace colt::lang
     PTR<Expr> body = parse_scope();
     if (isLoopTerminated(body))
     {
-      generate_any<report_as::WARNING>(body->get_src_code(), nullptr,
+      generate_any<report_as::WARNING>(get_src_info(body), nullptr,
         "Loop body is terminated!");
     }
 
@@ -811,6 +1218,116 @@ namespace colt::lang
       line_state.to_src_info(), ctx);
   }
 
+  PTR<Expr> ASTMaker::parse_for() noexcept
+  {
+    assert(current_tkn == TKN_KEYWORD_FOR);
+    SavedExprInfo line_state = { *this };
+
+    consume_current_tkn(); //consume for
+
+    if (check_and_consume(TKN_KEYWORD_VAR, &ASTMaker::panic_consume_sttmnt,
+      "Expected a loop variable declaration!"))
+      return ErrorExpr::CreateExpr(ctx);
+    
+    bool is_valid = true;
+    if (current_tkn == TKN_KEYWORD_MUT)
+    {
+      //Modifying the loop variable would prevent knowing the trip count
+      generate_any_current<report_as::ERROR>(nullptr,
+        "Loop variable of 'for' cannot be mutable!");
+      consume_current_tkn();
+      is_valid = false;
+    }
+
+    //The next token is also an identifier, so save the name before consuming
+    StringView var_name = lexer.get_parsed_identifier();
+    SymbolID var_symbol = lexer.get_parsed_symbol();
+    if (check_and_consume(TKN_IDENTIFIER, &ASTMaker::panic_consume_sttmnt,
+      "Expected an identifier!"))
+      return ErrorExpr::CreateExpr(ctx);
+
+    //'in' and 'range' are not keywords, so that they can still be used as identifiers
+    if (current_tkn != TKN_IDENTIFIER || lexer.get_parsed_identifier() != "in")
+    {
+      generate_any_current<report_as::ERROR>(&ASTMaker::panic_consume_sttmnt,
+        "Expected 'in'!");
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    consume_current_tkn(); //consume in
+    if (current_tkn != TKN_IDENTIFIER || lexer.get_parsed_identifier() != "range")
+    {
+      generate_any_current<report_as::ERROR>(&ASTMaker::panic_consume_sttmnt,
+        "Expected 'range'!");
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    consume_current_tkn(); //consume range
+
+    SavedExprInfo range_state = { *this };
+    PTR<Expr> begin = nullptr;
+    PTR<Expr> end = nullptr;
+    parse_parenthesis(&ASTMaker::parse_range_args, begin, end);
+
+    if (is_a<ErrorExpr>(begin) || (end != nullptr && is_a<ErrorExpr>(end)))
+      is_valid = false;
+    else if (!begin->get_type()->is_semantically_integral())
+    {
+      generate_any<report_as::ERROR>(get_src_info(begin), nullptr,
+        "'range' expects integral types, not '{}'!", begin->get_type()->get_name());
+      is_valid = false;
+    }
+    else if (end != nullptr && !end->get_type()->is_equal(begin->get_type()))
+    {
+      generate_any<report_as::ERROR>(range_state.to_src_info(), nullptr,
+        "Bounds of 'range' should be of same type!");
+      is_valid = false;
+    }
+    else if (end == nullptr) //range(end) is range(0, end)
+    {
+      end = begin;
+      begin = LiteralExpr::CreateExpr(QWORD{}, end->get_type(), get_src_info(end), ctx);
+    }
+
+    //The loop variable is not mutable
+    PTR<const Type> var_type = is_valid ? begin->get_type()->clone_as_const(ctx)
+      : ErrorType::CreateType(ctx);
+
+    PTR<Expr> body;
+    {
+      //Save loop state
+      ScopedSave loop_state = { is_parsing_loop, true };
+      //The loop variable is only visible in the body
+      SavedLocalState local_state = { *this };
+      local_var_table.push_back({ var_symbol, var_type });
+
+      //The range is used to remove bounds checks of indices in the body
+      if (is_valid)
+        loop_var_ranges.push_back({ local_var_table.get_size() - 1, begin, end });
+      body = parse_scope();
+      if (is_valid)
+        loop_var_ranges.pop_back();
+    }
+    if (isLoopTerminated(body))
+    {
+      generate_any<report_as::WARNING>(get_src_info(body), nullptr,
+        "Loop body is terminated!");
+    }
+
+    if (!is_valid)
+      return ErrorExpr::CreateExpr(ctx);
+
+    return ForLoopExpr::CreateExpr(var_name, var_type, begin, end, body,
+      line_state.to_src_info(), ctx);
+  }
+
+  void ASTMaker::parse_range_args(PTR<Expr>& begin, PTR<Expr>& end) noexcept
+  {
+    begin = parse_binary();
+    if (current_tkn != TKN_COMMA)
+      return;
+    consume_current_tkn(); //consume ','
+    end = parse_binary();
+  }
+
   PTR<Expr> ASTMaker::parse_var_decl(bool is_global) noexcept
   {
     SavedExprInfo line_state = { *this };
@@ -828,7 +1345,7 @@ namespace colt::lang
       "Expected an identifier!"))
       return ErrorExpr::CreateExpr(ctx);
 
-    StringView var_name = lexer.get_parsed_identifier();
+    SymbolID var_symbol = lexer.get_parsed_symbol();
 
     PTR<const Type> var_type = nullptr;
     if (current_tkn == TKN_COLON)
@@ -841,7 +1358,7 @@ namespace colt::lang
     if (current_tkn != TKN_SEMICOLON)
     {
       if (check_and_consume(TKN_EQUAL, &ASTMaker::panic_consume_var_decl, "Expected a '='!"))
-        return save_var_decl(is_global, ErrorType::CreateType(ctx), var_name,
+        return save_var_decl(is_global, ErrorType::CreateType(ctx), var_symbol,
           var_init, line_state.to_src_info());
       var_init = parse_binary();
     }
@@ -849,7 +1366,7 @@ namespace colt::lang
     {
       generate_any<report_as::ERROR>(line_state.to_src_info(), &ASTMaker::panic_consume_var_decl,
         "An uninitialized variable should specify its type!");
-      return save_var_decl(is_global, ErrorType::CreateType(ctx), var_name,
+      return save_var_decl(is_global, ErrorType::CreateType(ctx), var_symbol,
         var_init, line_state.to_src_info());
     }
     else //uninitialized variable with explicit type
@@ -871,11 +1388,11 @@ namespace colt::lang
     var_init = as_convert_to(var_init, var_type);
 
     if (check_and_consume(TKN_SEMICOLON, &ASTMaker::panic_consume_var_decl, "Expected a ';'!"))
-      return save_var_decl(is_global, var_type, var_name,
+      return save_var_decl(is_global, var_type, var_symbol,
         var_init, line_state.to_src_info());
 
   SAVE:
-    return save_var_decl(is_global, var_type, var_name,
+    return save_var_decl(is_global, var_type, var_symbol,
       var_init, line_state.to_src_info());
   }
 
@@ -892,7 +1409,7 @@ namespace colt::lang
     {
       if (lhs->get_type()->is_const())
       {
-        generate_any<report_as::ERROR>(lhs->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(lhs), nullptr,
           "Cannot assign to a non-mutable variable!");
         return ErrorExpr::CreateExpr(ctx);
       }
@@ -902,9 +1419,16 @@ namespace colt::lang
       auto read = as<PTR<const PtrLoadExpr>>(lhs);
       //The type of the PtrLoadExpr is the type
       //pointed to. So we can directly check for const here.
-      if (read->get_type()->is_const())
+      if (read->get_type()->is_const() && is_a<IndexExpr>(read->get_where()))
       {
-        generate_any<report_as::ERROR>(lhs->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(lhs), nullptr,
+          "Cannot write to an element of non-mutable '{}'!",
+          as<PTR<const IndexExpr>>(read->get_where())->get_where()->get_type()->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      else if (read->get_type()->is_const())
+      {
+        generate_any<report_as::ERROR>(get_src_info(lhs), nullptr,
           "Cannot write through pointer ('{}') to non-mutable type!",
           read->get_ptr_type()->get_name());
         return ErrorExpr::CreateExpr(ctx);
@@ -913,7 +1437,7 @@ namespace colt::lang
     else
     {
       //No need to consume as the whole expression was already parsed.
-      generate_any<report_as::ERROR>(lhs->get_src_code(), nullptr,
+      generate_any<report_as::ERROR>(get_src_info(lhs), nullptr,
         "Left hand side of an assignment should be a variable!");
       return ErrorExpr::CreateExpr(ctx);
     }
@@ -967,13 +1491,13 @@ namespace colt::lang
       }
       if (cnv_type->get_sizeof() > lhs->get_type()->get_sizeof())
       {
-        generate_any<report_as::ERROR>(lhs->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(lhs), nullptr,
           "'{}' too small to fit in '{}'!",
           lhs->get_type()->get_name(), cnv_type->get_name());
         return ErrorExpr::CreateExpr(ctx);
       }
       return ConvertExpr::CreateExpr(cnv_type, lhs, TKN_KEYWORD_BIT_AS,
-        lhs->get_src_code(), ctx);
+        get_src_info(lhs), ctx);
     }
 
     return as_convert_to(lhs, cnv_type);
@@ -1078,7 +1602,50 @@ namespace colt::lang
       }
     }
     break;
+    case TKN_LEFT_SQUARE: // [N]TYPE or []TYPE
+    {
+      consume_current_tkn();
+      bool is_slice = current_tkn == TKN_RIGHT_SQUARE;
+      u64 count = 0;
+      if (!is_slice)
+      {
+        if (current_tkn < TKN_I8_L || TKN_U64_L < current_tkn)
+        {
+          generate_any_current<report_as::ERROR>(panic,
+            "Expected an integral literal as size of the array!");
+          return ErrorType::CreateType(ctx);
+        }
+        count = lexer.get_parsed_value().as<u64>();
+        consume_current_tkn();
+      }
+      if (check_and_consume(TKN_RIGHT_SQUARE, panic, "Expected a ']'!"))
+        return ErrorType::CreateType(ctx);
+
+      PTR<const Type> type_of = parse_typename(panic);
+      if (is_a<ErrorType>(type_of))
+        return type_of;
+      if (type_of->is_void())
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), panic,
+          "Type of elements of arrays and slices cannot be 'void'!");
+        return ErrorType::CreateType(ctx);
+      }
+      if (is_slice) // 'mut' applies to the slice
+        return SliceType::CreateSlice(is_const, type_of, ctx);
+      if (count == 0)
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), panic,
+          "Size of an array cannot be zero!");
+        return ErrorType::CreateType(ctx);
+      }
+      // 'mut' applies to the elements of the array
+      return ArrayType::CreateArray(is_const ? type_of : type_of->clone_as_mut(ctx),
+        count, ctx);
+    }
     case TKN_IDENTIFIER:
+      //'vec' is not a keyword, so that it can still be used as a name
+      if (lexer.get_parsed_identifier() == "vec")
+        return parse_vec_typename(is_const, panic);
       //TODO: add
       colt_unreachable("not implemented");
     default:
@@ -1090,29 +1657,87 @@ namespace colt::lang
     return ErrorType::CreateType(ctx);
   }
 
+  PTR<const Type> ASTMaker::parse_vec_typename(bool is_const, panic_consume_t panic) noexcept
+  {
+    assert(current_tkn == TKN_IDENTIFIER);
+
+    //Save current expression state
+    SavedExprInfo line_state = { *this };
+    
+    consume_current_tkn(); //consume 'vec'
+    if (check_and_consume(TKN_LESS, panic, "Expected a '<'!"))
+      return ErrorType::CreateType(ctx);
+    
+    PTR<const Type> type_of = parse_typename(panic);
+    if (is_a<ErrorType>(type_of))
+      return type_of;
+    if (check_and_consume(TKN_COMMA, panic, "Expected a ','!"))
+      return ErrorType::CreateType(ctx);
+    
+    if (current_tkn < TKN_I8_L || TKN_U64_L < current_tkn)
+    {
+      generate_any_current<report_as::ERROR>(panic,
+        "Expected an integral literal as count of elements of the vector!");
+      return ErrorType::CreateType(ctx);
+    }
+    u64 count = lexer.get_parsed_value().as<u64>();
+    consume_current_tkn();
+
+    if (current_tkn == TKN_GREAT_GREAT) // '>>' is parsed as '>' '>'
+      current_tkn = TKN_GREAT;
+    if (check_and_consume(TKN_GREAT, panic, "Expected a '>'!"))
+      return ErrorType::CreateType(ctx);
+
+    if (!VecType::isValidElement(type_of))
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), panic,
+        "Type of elements of vectors must be 'bool', an integer or a floating point type, not '{}'!", type_of->get_name());
+      return ErrorType::CreateType(ctx);
+    }
+    if (!VecType::isValidCount(count))
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), panic,
+        "Count of elements of vectors must be a power of 2 in the range [2, {}]!", VecType::MaxCount);
+      return ErrorType::CreateType(ctx);
+    }
+    // 'mut' applies to the elements of the vector
+    return VecType::CreateVec(is_const ? type_of : type_of->clone_as_mut(ctx),
+      count, ctx);
+  }
+
   PTR<Expr> ASTMaker::parse_identifier(const SavedExprInfo& line_state) noexcept
   {
     assert(current_tkn == TKN_IDENTIFIER);
 
     StringView identifier = lexer.get_parsed_identifier();
+    SymbolID symbol = lexer.get_parsed_symbol();
     consume_current_tkn(); // consume identifier
     //The source code information of the identifier, done AFTER consuming
     SourceCodeExprInfo identifier_info = line_state.to_src_info();
 
+    //'len' and operations on vectors are not keywords, so that functions
+    //can still use these names
+    if (current_tkn == TKN_LEFT_PAREN && global_map.find(symbol) == nullptr)
+    {
+      if (identifier == "len")
+        return parse_len(line_state);
+      if (auto intrinsic = StringToVecIntrinsic(identifier); intrinsic.is_value())
+        return parse_vec_intrinsic(identifier, intrinsic.get_value(), line_state);
+    }
     if (current_tkn == TKN_LEFT_PAREN) // function call
-      return parse_fn_call(identifier, line_state);
+      return parse_fn_call(symbol, line_state);
 
     if (current_function != nullptr) //if parsing a function
     {
       //Search in local variables of function
       for (i64 i = as<i64>(local_var_table.get_size()) - 1; i >= 0; i--)
       {
-        if (local_var_table[i].first == identifier)
-          return VarReadExpr::CreateExpr(local_var_table[i].second, identifier, i,
+        if (local_var_table[i].first == symbol)
+          return VarReadExpr::CreateExpr(local_var_table[i].second, symbol, i,
             line_state.to_src_info(), ctx);
       }
     }
-    if (auto gvar = global_map.find(identifier); gvar != nullptr)
+    if (auto gvar = global_map.find(symbol); gvar != nullptr)
     {
       if (!is_a<VarDeclExpr>(gvar->second.get_front()))
       {
@@ -1120,7 +1745,7 @@ namespace colt::lang
           "'{}' is not a variable!", identifier);
         return ErrorExpr::CreateExpr(ctx);
       }
-      return VarReadExpr::CreateExpr(gvar->second.get_front()->get_type(), identifier,
+      return VarReadExpr::CreateExpr(gvar->second.get_front()->get_type(), symbol,
         line_state.to_src_info(), ctx);
     }
     else
@@ -1131,7 +1756,214 @@ namespace colt::lang
     }
   }
 
-  PTR<Expr> ASTMaker::parse_fn_call(StringView identifier, const SavedExprInfo& line_state) noexcept
+  PTR<Expr> ASTMaker::parse_index(PTR<Expr> where, const SavedExprInfo& line_state) noexcept
+  {
+    assert(current_tkn == TKN_LEFT_SQUARE);
+
+    consume_current_tkn(); //consume [
+    PTR<Expr> index = parse_binary();
+    if (check_and_consume(TKN_RIGHT_SQUARE, "Expected a ']'!"))
+      return ErrorExpr::CreateExpr(ctx);
+    
+    //Propagate error
+    if (is_a<ErrorExpr>(where) || is_a<ErrorExpr>(index))
+      return ErrorExpr::CreateExpr(ctx);
+
+    PTR<const Type> where_t = where->get_type();
+    if (!where_t->is_array() && !where_t->is_slice())
+    {
+      generate_any<report_as::ERROR>(get_src_info(where), nullptr,
+        "Only arrays and slices can be indexed, not '{}'!", where_t->get_name());
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    //The address of the array is needed
+    if (where_t->is_array() && !isAddressable(where))
+    {
+      generate_any<report_as::ERROR>(get_src_info(where), nullptr,
+        "Only variables of array type can be indexed!");
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    if (!index->get_type()->is_semantically_integral())
+    {
+      generate_any<report_as::ERROR>(get_src_info(index), nullptr,
+        "Index should be of integral type, not '{}'!", index->get_type()->get_name());
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    //Constant indices into arrays are checked at compile time
+    if (where_t->is_array() && is_a<LiteralExpr>(index)
+      && !isLiteralInRange(index, as<PTR<const ArrayType>>(where_t)->get_count()))
+    {
+      generate_any<report_as::ERROR>(get_src_info(index), nullptr,
+        "Index is out of bounds of '{}'!", where_t->get_name());
+      return ErrorExpr::CreateExpr(ctx);
+    }
+
+    bool is_checked = !args::NoBoundsCheck && !is_index_in_bounds(where, index);
+    PTR<Expr> address = IndexExpr::CreateExpr(where, index, is_checked,
+      line_state.to_src_info(), ctx);
+    return PtrLoadExpr::CreateExpr(address, line_state.to_src_info(), ctx);
+  }
+
+  PTR<Expr> ASTMaker::parse_len(const SavedExprInfo& line_state) noexcept
+  {
+    assert(current_tkn == TKN_LEFT_PAREN);
+
+    PTR<Expr> what = parse_parenthesis(&ASTMaker::parse_binary, static_cast<u8>(0));
+    if (is_a<ErrorExpr>(what))
+      return what;
+
+    //The length of an array is known at compile time
+    if (what->get_type()->is_array())
+      return LiteralExpr::CreateExpr(QWORD{ as<PTR<const ArrayType>>(what->get_type())->get_count() },
+        BuiltInType::CreateU64(true, ctx), line_state.to_src_info(), ctx);
+    if (what->get_type()->is_slice())
+      return SliceLenExpr::CreateExpr(what, line_state.to_src_info(), ctx);
+    
+    generate_any<report_as::ERROR>(get_src_info(what), nullptr,
+      "'len' expects an array or a slice, not '{}'!", what->get_type()->get_name());
+    return ErrorExpr::CreateExpr(ctx);
+  }
+
+  PTR<Expr> ASTMaker::parse_vec_intrinsic(StringView name, VecIntrinsicExpr::VecIntrinsicID intrinsic, const SavedExprInfo& line_state) noexcept
+  {
+    assert(current_tkn == TKN_LEFT_PAREN);
+
+    using VecI = VecIntrinsicExpr;
+
+    Vector<PTR<Expr>> outer_scope = {};
+    SmallVector<PTR<Expr>, 4> arguments;
+    parse_parenthesis(&ASTMaker::parse_fn_call_args, arguments, outer_scope);
+
+    //Propagate error
+    for (size_t i = 0; i < arguments.get_size(); i++)
+    {
+      if (is_a<ErrorExpr>(arguments[i]))
+        return arguments[i];
+    }
+    if (outer_scope.is_not_empty())
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Arguments of '{}' cannot be of type 'void'!", name);
+      return ErrorExpr::CreateExpr(ctx);
+    }
+
+    PTR<const Type> type;
+    switch (intrinsic)
+    {
+    break; case VecI::VEC_SHUFFLE:
+    {
+      if (arguments.get_size() < 3)
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+          "'shuffle' expects two vectors followed by the indices of the elements!");
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      PTR<const Type> vec_t = arguments[0]->get_type();
+      if (!vec_t->is_vec() || !vec_t->is_equal(arguments[1]->get_type()))
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+          "'shuffle' expects two vectors of the same type!");
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      u64 count = arguments.get_size() - 2;
+      if (!VecType::isValidCount(count))
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+          "Count of elements of vectors must be a power of 2 in the range [2, {}]!", VecType::MaxCount);
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      //The indices select from the elements of both vectors
+      u64 max = 2 * as<PTR<const VecType>>(vec_t)->get_count();
+      for (size_t i = 2; i < arguments.get_size(); i++)
+      {
+        if (!isLiteralInRange(arguments[i], max))
+        {
+          generate_any<report_as::ERROR>(get_src_info(arguments[i]), nullptr,
+            "Indices of 'shuffle' should be integral literals in the range [0, {})!", max);
+          return ErrorExpr::CreateExpr(ctx);
+        }
+      }
+      type = VecType::CreateVec(as<PTR<const VecType>>(vec_t)->get_type_of(), count, ctx);
+    }
+    break;
+    case VecI::VEC_REDUCE_ADD:
+    case VecI::VEC_REDUCE_MUL:
+    case VecI::VEC_REDUCE_MIN:
+    case VecI::VEC_REDUCE_MAX:
+    case VecI::VEC_REDUCE_AND:
+    case VecI::VEC_REDUCE_OR:
+    case VecI::VEC_REDUCE_XOR:
+    {
+      if (arguments.get_size() != 1 || !arguments[0]->get_type()->is_vec())
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+          "'{}' expects a vector!", name);
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      PTR<const Type> type_of = as<PTR<const VecType>>(arguments[0]->get_type())->get_type_of();
+      //Arithmetic reductions are not supported on masks, and bitwise
+      //reductions are not supported on floating points.
+      bool is_bitwise = intrinsic == VecI::VEC_REDUCE_AND
+        || intrinsic == VecI::VEC_REDUCE_OR || intrinsic == VecI::VEC_REDUCE_XOR;
+      if (is_bitwise ? type_of->is_floating() : type_of->is_bool())
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+          "'{}' does not support vectors of '{}'!", name, type_of->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      type = type_of;
+    }
+    break;
+    case VecI::VEC_LOAD_MASKED:
+    case VecI::VEC_STORE_MASKED:
+    {
+      //load_masked(ptr, mask, passthru) and store_masked(ptr, mask, value)
+      if (arguments.get_size() != 3 || !arguments[2]->get_type()->is_vec())
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+          "'{}' expects a pointer, a mask and a vector!", name);
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      auto vec_t = as<PTR<const VecType>>(arguments[2]->get_type());
+      PTR<const Type> mask_t = VecType::CreateVec(BuiltInType::CreateBool(true, ctx),
+        vec_t->get_count(), ctx);
+      if (!arguments[1]->get_type()->is_equal(mask_t))
+      {
+        generate_any<report_as::ERROR>(get_src_info(arguments[1]), nullptr,
+          "Mask of '{}' should be of type '{}', not '{}'!",
+          name, mask_t->get_name(), arguments[1]->get_type()->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      PTR<const Type> ptr_t = arguments[0]->get_type();
+      if (!ptr_t->is_ptr()
+        || !as<PTR<const PtrType>>(ptr_t)->get_type_to()->is_equal(vec_t->get_type_of()))
+      {
+        generate_any<report_as::ERROR>(get_src_info(arguments[0]), nullptr,
+          "'{}' expects a pointer to '{}', not '{}'!",
+          name, vec_t->get_type_of()->get_name(), ptr_t->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      if (intrinsic == VecI::VEC_LOAD_MASKED)
+      {
+        type = vec_t;
+        break;
+      }
+      if (as<PTR<const PtrType>>(ptr_t)->get_type_to()->is_const())
+      {
+        generate_any<report_as::ERROR>(get_src_info(arguments[0]), nullptr,
+          "Cannot write through pointer to non-mutable type '{}'!", ptr_t->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      type = VoidType::CreateType(ctx);
+    }
+    break; default:
+      colt_unreachable("Invalid vector operation!");
+    }
+    return VecIntrinsicExpr::CreateExpr(type, intrinsic, std::move(arguments),
+      line_state.to_src_info(), ctx);
+  }
+
+  PTR<Expr> ASTMaker::parse_fn_call(SymbolID symbol, const SavedExprInfo& line_state) noexcept
   {
     assert(current_tkn == TKN_LEFT_PAREN);
 
@@ -1142,7 +1974,7 @@ namespace colt::lang
     SmallVector<PTR<Expr>, 4> arguments;
     parse_parenthesis(&ASTMaker::parse_fn_call_args, arguments, outer_scope);
 
-    auto call_expr = handle_function_call(identifier, std::move(arguments),
+    auto call_expr = handle_function_call(symbol, std::move(arguments),
       identifier_location, line_state.to_src_info());
     if (is_a<ErrorExpr>(call_expr) || outer_scope.is_empty())
       return call_expr;
@@ -1204,7 +2036,7 @@ namespace colt::lang
     PTR<Expr> ret_val = parse_binary();
     if (!ret_val->get_type()->is_equal(current_function->get_return_type()))
     {
-      generate_any<report_as::ERROR>(ret_val->get_src_code(), nullptr,
+      generate_any<report_as::ERROR>(get_src_info(ret_val), nullptr,
         "Type of return value ({}) does not match function return type ({})!",
         ret_val->get_type()->get_name(),
         current_function->get_return_type()->get_name());
@@ -1251,7 +2083,7 @@ namespace colt::lang
     {
       if (!arguments[i]->get_type()->is_equal(decl->get_params_type()[i]))
       {
-        generate_any<report_as::ERROR>(arguments[i]->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(arguments[i]), nullptr,
           "Type of argument ({}) does not match that of declaration ({})!",
           arguments[i]->get_type()->get_name(), decl->get_params_type()[i]->get_name());
         ret = false;
@@ -1260,9 +2092,10 @@ namespace colt::lang
     return ret;
   }
 
-  PTR<Expr> ASTMaker::handle_function_call(StringView identifier, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& identifier_loc, const SourceCodeExprInfo& fn_call) noexcept
+  PTR<Expr> ASTMaker::handle_function_call(SymbolID symbol, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& identifier_loc, const SourceCodeExprInfo& fn_call) noexcept
   {
-    auto ptr = global_map.find(identifier);
+    StringView identifier = GetSymbolName(symbol);
+    auto ptr = global_map.find(symbol);
     if (ptr == nullptr)
     {
       generate_any<report_as::ERROR>(identifier_loc, nullptr,
@@ -1318,14 +2151,56 @@ namespace colt::lang
   void ASTMaker::handle_unreachable_code() noexcept
   {
     PTR<const Expr> stt = parse_statement();
-    SourceCodeExprInfo stt_info = stt->get_src_code();
+    SourceCodeExprInfo stt_info = get_src_info(stt);
     while (current_tkn != TKN_RIGHT_CURLY && current_tkn != TKN_EOF)
       stt = parse_statement();
 
-    generate_any<report_as::WARNING>(ConcatInfo(stt_info, stt->get_src_code()),
+    generate_any<report_as::WARNING>(ConcatInfo(stt_info, get_src_info(stt)),
       nullptr, "Unreachable code!");
   }
 
+  bool ASTMaker::is_index_in_bounds(PTR<const Expr> where, PTR<const Expr> index) const noexcept
+  {
+    //Constant index into an array
+    if (where->get_type()->is_array()
+      && isLiteralInRange(index, as<PTR<const ArrayType>>(where->get_type())->get_count()))
+      return true;
+
+    //Variable of a 'for' loop: its value is in [begin, end)
+    if (!is_a<VarReadExpr>(index) || as<PTR<const VarReadExpr>>(index)->is_global())
+      return false;
+    u64 local_ID = as<PTR<const VarReadExpr>>(index)->get_local_ID();
+    for (size_t i = 0; i < loop_var_ranges.get_size(); i++)
+    {
+      const LoopVarRange& range = loop_var_ranges[i];
+      if (range.local_ID != local_ID)
+        continue;
+      
+      //'begin' cannot be negative
+      if (!range.begin->get_type()->is_unsigned_int()
+        && !isLiteralInRange(range.begin, std::numeric_limits<u64>::max()))
+        return false;
+      //'end' cannot be greater than the size of the array
+      if (where->get_type()->is_array())
+        return isLiteralInRange(range.end,
+          as<PTR<const ArrayType>>(where->get_type())->get_count() + 1);
+      
+      //'end' should be the length of the same non-mutable slice variable
+      if (!is_a<SliceLenExpr>(range.end) || !is_a<VarReadExpr>(where)
+        || !where->get_type()->is_const())
+        return false;
+      auto slice = as<PTR<const SliceLenExpr>>(range.end)->get_slice();
+      if (!is_a<VarReadExpr>(slice))
+        return false;
+      auto a = as<PTR<const VarReadExpr>>(slice);
+      auto b = as<PTR<const VarReadExpr>>(where);
+      if (a->is_global() || b->is_global())
+        return a->is_global() && b->is_global() && a->get_name() == b->get_name();
+      return a->get_local_ID() == b->get_local_ID();
+    }
+    return false;
+  }
+
   void ASTMaker::validate_all_path_return(PTR<const Expr> expr) noexcept
   {
     switch (expr->classof())
@@ -1341,30 +2216,31 @@ namespace colt::lang
       PTR<const ConditionExpr> cond = as<PTR<const ConditionExpr>>(expr);
       validate_all_path_return(cond->get_if_statement());
       if (cond->get_else_statement() == nullptr)
-        generate_any<report_as::ERROR>(expr->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(expr), nullptr,
           "Missing 'else' branch with 'return' statement, as path must return a value!");
       else
         validate_all_path_return(cond->get_else_statement());
       return;
     }
     default:
-      generate_any<report_as::ERROR>(expr->get_src_code(), nullptr,
+      generate_any<report_as::ERROR>(get_src_info(expr), nullptr,
         "Expected a 'return' statement, as path must return a value!");
     }
   }
 
-  PTR<Expr> ASTMaker::save_var_decl(bool is_global, PTR<const Type> var_type, StringView var_name, PTR<Expr> var_init, const SourceCodeExprInfo& src_info) noexcept
+  PTR<Expr> ASTMaker::save_var_decl(bool is_global, PTR<const Type> var_type, SymbolID var_symbol, PTR<Expr> var_init, const SourceCodeExprInfo& src_info) noexcept
   {
+    StringView var_name = GetSymbolName(var_symbol);
     if (is_global)
     {
-      auto var_expr = VarDeclExpr::CreateExpr(var_type, var_name, var_init, true,
+      auto var_expr = VarDeclExpr::CreateExpr(var_type, var_symbol, var_init, true,
         src_info, ctx);
-      if (auto gptr = global_map.find(var_name); gptr == nullptr)
+      if (auto gptr = global_map.find(var_symbol); gptr == nullptr)
       {
         SmallVector<PTR<Expr>> to_push;
         to_push.push_back(var_expr);
         //TODO: move
-        global_map.insert(var_name, to_push);
+        global_map.insert(var_symbol, to_push);
         return var_expr;
       }
       else
@@ -1379,25 +2255,26 @@ namespace colt::lang
       }
     }
 
-    local_var_table.push_back({ var_name, var_type });
-    return VarDeclExpr::CreateExpr(var_type, var_name, var_init, false,
+    local_var_table.push_back({ var_symbol, var_type });
+    return VarDeclExpr::CreateExpr(var_type, var_symbol, var_init, false,
       src_info, ctx);
   }
 
   void ASTMaker::add_fn_to_global_table(PTR<FnDefExpr> expr) noexcept
   {
-    auto ptr = global_map.find(expr->get_name());
+    SymbolID symbol = InternSymbol(expr->get_name());
+    auto ptr = global_map.find(symbol);
     if (ptr == nullptr)
     {
       SmallVector<PTR<Expr>> exprs;
       exprs.push_back(expr);
       //TODO: move
-      global_map.insert(expr->get_name(), exprs);
+      global_map.insert(symbol, exprs);
       return;
     }
     if (is_a<VarDeclExpr>(ptr->second.get_front()))
     {
-      generate_any<report_as::ERROR>(expr->get_src_code(), nullptr,
+      generate_any<report_as::ERROR>(get_src_info(expr), nullptr,
         "Global variable of name '{}' already exist!", expr->get_name());
       return;
     }
@@ -1407,12 +2284,12 @@ namespace colt::lang
       {
         if (!expr->get_type()->is_equal(ptr->second.get_front()->get_type()))
         {
-          generate_any<report_as::ERROR>(expr->get_src_code(), nullptr,
+          generate_any<report_as::ERROR>(get_src_info(expr), nullptr,
             "Cannot overload 'extern' functions!", expr->get_name());
         }
         return;
       }
-      generate_any<report_as::ERROR>(expr->get_src_code(), nullptr,
+      generate_any<report_as::ERROR>(get_src_info(expr), nullptr,
         "Cannot overload non-'extern' with 'extern' functions!", expr->get_name());
       return;
     }
@@ -1436,14 +2313,14 @@ namespace colt::lang
       {
         if (fn->has_body() && expr->has_body())
         {
-          generate_any<report_as::ERROR>(expr->get_src_code(), nullptr,
+          generate_any<report_as::ERROR>(get_src_info(expr), nullptr,
             "Function of name '{}' already has a body!", expr->get_name());
           return;
         }
       }
       else //same arguments but different return types
       {
-        generate_any<report_as::ERROR>(expr->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(expr), nullptr,
           "Cannot overload functions solely on return type!", expr->get_name());
         return;
       }
@@ -1465,6 +2342,14 @@ namespace colt::lang
         "Operands should be of same type!");
       return ErrorExpr::CreateExpr(ctx);
     }
+    else if (!is_a<BuiltInType>(lhs->get_type()) && !is_a<VecType>(lhs->get_type()))
+    {
+      //Operands of errors were already reported
+      if (!lhs->get_type()->is_error())
+        generate_any<report_as::ERROR>(src_info, nullptr,
+          "Type '{}' does not support operator '{}'!", lhs->get_type()->get_name(), BinaryOperatorToString(bin_op));
+      return ErrorExpr::CreateExpr(ctx);
+    }
     else if (bin_op != BinaryOperator::OP_ASSIGN && is_a<BuiltInType>(rhs->get_type())
       && !as<PTR<const BuiltInType>>(rhs->get_type())->supports(bin_op))
     {
@@ -1472,6 +2357,13 @@ namespace colt::lang
         "Type '{}' does not support operator '{}'!", rhs->get_type()->get_name(), BinaryOperatorToString(bin_op));
       return ErrorExpr::CreateExpr(ctx);
     }
+    else if (bin_op != BinaryOperator::OP_ASSIGN && is_a<VecType>(rhs->get_type())
+      && !as<PTR<const VecType>>(rhs->get_type())->supports(bin_op))
+    {
+      generate_any<report_as::ERROR>(src_info, nullptr,
+        "Type '{}' does not support operator '{}'!", rhs->get_type()->get_name(), BinaryOperatorToString(bin_op));
+      return ErrorExpr::CreateExpr(ctx);
+    }
 
     //Check for division by zero and constant fold expression
     //if possible.
@@ -1529,6 +2421,15 @@ namespace colt::lang
     return LiteralExpr::CreateExpr(res, ret, src_info, ctx);
   }
 
+  QWORD ASTMaker::insert_str_literal(String&& str) noexcept
+  {
+    //The table is shared by the threads parsing bodies
+    std::unique_lock<std::mutex> lock;
+    if (str_table_mutex != nullptr)
+      lock = std::unique_lock<std::mutex>{ *str_table_mutex };
+    return str_table.insert(std::move(str)).first;
+  }
+
   PTR<Expr> ASTMaker::constant_fold_lstring(PTR<const LiteralExpr> a, BinaryOperator op, PTR<const LiteralExpr> b, const SourceCodeExprInfo& src_info) noexcept
   {
     //If the expression is 2 lstring to add, create lstring
@@ -1537,7 +2438,7 @@ namespace colt::lang
     {
       String concat = { *a->get_value().as<PTR<String>>() };
       concat += *b->get_value().as<PTR<String>>();
-      QWORD res = str_table.insert(std::move(concat)).first;
+      QWORD res = insert_str_literal(std::move(concat));
       return LiteralExpr::CreateExpr(res, a->get_type(), src_info, ctx);
     }
     if (op == BinaryOperator::OP_EQUAL)
@@ -1559,7 +2460,7 @@ namespace colt::lang
 
     if (!condition->get_type()->is_equal(BuiltInType::CreateBool(false, ctx)))
     {
-      generate_any<report_as::ERROR>(condition->get_src_code(), nullptr,
+      generate_any<report_as::ERROR>(get_src_info(condition), nullptr,
         "Expression should be of type 'bool'!");
       return ErrorExpr::CreateExpr(ctx);
     }
@@ -1569,11 +2470,45 @@ namespace colt::lang
     else if (!is_a<BinaryExpr>(condition))
     {
       condition = create_binary(condition->get_type(), condition, TKN_EQUAL_EQUAL,
-        LiteralExpr::CreateValue(true, ctx), condition->get_src_code());
+        LiteralExpr::CreateValue(true, ctx), get_src_info(condition));
     }
     return condition;
   }  
 
+  PTR<Expr> ASTMaker::as_convert_vec(PTR<Expr> what, PTR<const Type> to) noexcept
+  {
+    using VecI = VecIntrinsicExpr;
+
+    PTR<const Type> from = what->get_type();
+    //The type of the elements and the count of elements of the vector
+    PTR<const VecType> vec_t = as<PTR<const VecType>>(to->is_vec() ? to : from);
+    PTR<const Type> other_t = to->is_vec() ? from : to;
+    
+    if (other_t->is_vec() && other_t->is_equal(vec_t))
+      return what;
+    
+    //Kind of conversion
+    VecI::VecIntrinsicID intrinsic;
+    if (other_t->is_builtin() && to->is_vec()
+      && other_t->is_equal(vec_t->get_type_of()))
+      intrinsic = VecI::VEC_SPLAT;
+    else if (other_t->is_array()
+      && as<PTR<const ArrayType>>(other_t)->get_count() == vec_t->get_count()
+      && as<PTR<const ArrayType>>(other_t)->get_type_of()->is_equal(vec_t->get_type_of()))
+      intrinsic = to->is_vec() ? VecI::VEC_FROM_ARRAY : VecI::VEC_TO_ARRAY;
+    else
+    {
+      generate_any<report_as::ERROR>(get_src_info(what), nullptr,
+        "Cannot convert from '{}' to '{}'!",
+        from->get_name(), to->get_name());
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    SmallVector<PTR<Expr>, 4> arguments;
+    arguments.push_back(what);
+    return VecIntrinsicExpr::CreateExpr(to, intrinsic, std::move(arguments),
+      get_src_info(what), ctx);
+  }
+
   PTR<Expr> ASTMaker::as_convert_to(PTR<Expr> what, PTR<const Type> to) noexcept
   {
     if (is_a<ErrorExpr>(what))
@@ -1586,7 +2521,57 @@ namespace colt::lang
         return what;
       //Create conversion.
       return ConvertExpr::CreateExpr(to, what, TKN_KEYWORD_AS,
-        what->get_src_code(), ctx);
+        get_src_info(what), ctx);
+    }
+    else if (from->is_vec() || to->is_vec())
+      return as_convert_vec(what, to);
+    else if (from->is_array() && to->is_slice())
+    {
+      auto to_s = as<PTR<const SliceType>>(to);
+      auto from_a = as<PTR<const ArrayType>>(from);
+      if (!from_a->get_type_of()->is_equal(to_s->get_type_of()))
+      {
+        generate_any<report_as::ERROR>(get_src_info(what), nullptr,
+          "Cannot convert from '{}' to '{}'!",
+          from->get_name(), to->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      if (!to_s->get_type_of()->is_const() && from_a->get_type_of()->is_const())
+      {
+        generate_any<report_as::ERROR>(get_src_info(what), nullptr,
+          "Cannot convert from non-mutable '{}' to mutable slice '{}'!",
+          from->get_name(), to->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      //The slice points to the array
+      if (!isAddressable(what))
+      {
+        generate_any<report_as::ERROR>(get_src_info(what), nullptr,
+          "Only variables of array type can be converted to slices!");
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      return ToSliceExpr::CreateExpr(to, what, get_src_info(what), ctx);
+    }
+    else if ((from->is_array() && to->is_array())
+      || (from->is_slice() && to->is_slice()))
+    {
+      if (!from->is_equal(to))
+      {
+        generate_any<report_as::ERROR>(get_src_info(what), nullptr,
+          "Cannot convert from '{}' to '{}'!",
+          from->get_name(), to->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
+      //Arrays are copied, but slices point to the same elements
+      if (from->is_slice()
+        && !as<PTR<const SliceType>>(to)->get_type_of()->is_const()
+        && as<PTR<const SliceType>>(from)->get_type_of()->is_const())
+      {
+        generate_any<report_as::ERROR>(get_src_info(what), nullptr,
+          "Cannot convert from non-mutable '{}' to mutable slice '{}'!",
+          from->get_name(), to->get_name());
+        return ErrorExpr::CreateExpr(ctx);
+      }
     }
     else if (from->is_ptr() && to->is_ptr()) //both are pointers
     {
@@ -1601,7 +2586,7 @@ namespace colt::lang
       
       if (!from_p->get_type_to()->is_equal(to_p->get_type_to()))
       {
-        generate_any<report_as::ERROR>(what->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(what), nullptr,
           "Cannot convert from '{}' to '{}'!",
           from->get_name(), to->get_name());
         return ErrorExpr::CreateExpr(ctx);
@@ -1609,7 +2594,7 @@ namespace colt::lang
       if (!to_p->get_type_to()->is_const()
         && from_p->get_type_to()->is_const())
       {
-        generate_any<report_as::ERROR>(what->get_src_code(), nullptr,
+        generate_any<report_as::ERROR>(get_src_info(what), nullptr,
           "Cannot convert from non-mutable '{}' to mutable pointer '{}'!",
           from->get_name(), to->get_name());
         return ErrorExpr::CreateExpr(ctx);
@@ -1617,7 +2602,7 @@ namespace colt::lang
     }
     else
     {
-      generate_any<report_as::ERROR>(what->get_src_code(), nullptr,
+      generate_any<report_as::ERROR>(get_src_info(what), nullptr,
         "Cannot convert from '{}' to '{}'!",
         from->get_name(), to->get_name());
       return ErrorExpr::CreateExpr(ctx);
@@ -1634,14 +2619,16 @@ namespace colt::lang
 
   void ASTMaker::panic_consume_decl() noexcept
   {
-    while (current_tkn != TKN_KEYWORD_VAR && current_tkn != TKN_KEYWORD_FN && current_tkn != TKN_EOF)
+    while (current_tkn != TKN_KEYWORD_VAR && current_tkn != TKN_KEYWORD_FN
+      && current_tkn != TKN_KEYWORD_IMPORT && current_tkn != TKN_EOF)
       consume_current_tkn();
   }
 
   void ASTMaker::panic_consume_sttmnt() noexcept
   {
     while (current_tkn != TKN_SEMICOLON && current_tkn != TKN_RIGHT_CURLY && current_tkn != TKN_EOF
-      && current_tkn != TKN_KEYWORD_IF && current_tkn != TKN_KEYWORD_WHILE && current_tkn != TKN_KEYWORD_VAR)
+      && current_tkn != TKN_KEYWORD_IF && current_tkn != TKN_KEYWORD_WHILE && current_tkn != TKN_KEYWORD_FOR
+      && current_tkn != TKN_KEYWORD_VAR)
       consume_current_tkn();
     if (current_tkn == TKN_SEMICOLON)
       consume_current_tkn();
@@ -1650,7 +2637,15 @@ namespace colt::lang
   void ASTMaker::panic_consume_return() noexcept
   {
     while (current_tkn != TKN_SEMICOLON && current_tkn != TKN_RIGHT_CURLY && current_tkn != TKN_EOF
-      && current_tkn != TKN_KEYWORD_IF && current_tkn != TKN_KEYWORD_WHILE && current_tkn != TKN_KEYWORD_VAR)
+      && current_tkn != TKN_KEYWORD_IF && current_tkn != TKN_KEYWORD_WHILE && current_tkn != TKN_KEYWORD_FOR
+      && current_tkn != TKN_KEYWORD_VAR)
+      consume_current_tkn();
+  }
+
+  void ASTMaker::panic_consume_case() noexcept
+  {
+    while (current_tkn != TKN_KEYWORD_CASE && current_tkn != TKN_KEYWORD_DEFAULT
+      && current_tkn != TKN_RIGHT_CURLY && current_tkn != TKN_EOF)
       consume_current_tkn();
   }
 
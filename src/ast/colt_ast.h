@@ -40,6 +40,23 @@ namespace colt::lang
   /// @return True if represents a terminated expression
   bool isTerminated(PTR<const Expr> expr) noexcept;
 
+  /// @brief Check if the address of the value of 'expr' can be taken.
+  /// Variables and values loaded from pointers are addressable.
+  /// @param expr The expression to check for
+  /// @return True if 'expr' is a VarReadExpr or a PtrLoadExpr
+  bool isAddressable(PTR<const Expr> expr) noexcept;
+
+  /// @brief Check if 'expr' is an integral literal whose value is in [0, max)
+  /// @param expr The expression to check for
+  /// @param max The value past the greatest valid value
+  /// @return True if 'expr' is a literal in range
+  bool isLiteralInRange(PTR<const Expr> expr, u64 max) noexcept;
+
+  /// @brief Converts the name of a vector operation to its VecIntrinsicID
+  /// @param name The name of the operation ('shuffle', 'reduce_add', ...)
+  /// @return The VecIntrinsicID or None if 'name' is not a vector operation
+  Optional<VecIntrinsicExpr::VecIntrinsicID> StringToVecIntrinsic(StringView name) noexcept;
+
   /// @brief Concatenate two adjacent SourceCodeExprInfo
   /// @param lhs The left hand side
   /// @param rhs The right hand side
@@ -67,6 +84,28 @@ namespace colt::lang
       SourceCodeExprInfo to_src_info() const noexcept;
     };
 
+    /// @brief POD for the range of values of the variable of a 'for' loop
+    struct LoopVarRange
+    {
+      /// @brief The local ID of the loop variable
+      u64 local_ID;
+      /// @brief The first value of the loop variable
+      PTR<const Expr> begin;
+      /// @brief The value past the last value of the loop variable
+      PTR<const Expr> end;
+    };
+
+    /// @brief The body of a function whose parsing was deferred
+    struct DeferredBody
+    {
+      /// @brief The function definition whose body to parse
+      PTR<FnDefExpr> definition;
+      /// @brief The offset of the '{' or ':' beginning the body
+      size_t offset;
+      /// @brief The line number of the '{' or ':' beginning the body
+      u32 line_nb;
+    };
+
     /************* MEMBERS ************/
 
     /// @brief The array of expressions
@@ -84,19 +123,29 @@ namespace colt::lang
     /// @brief True if parsing a PTR
     bool is_parsing_ptr = false;
     /// @brief The table storing local variables informations
-    Vector<std::pair<StringView, PTR<const Type>>> local_var_table = {};
+    Vector<std::pair<SymbolID, PTR<const Type>>> local_var_table = {};
+    /// @brief The ranges of the variables of the 'for' loops being parsed
+    Vector<LoopVarRange> loop_var_ranges = {};
     /// @brief The current expression informations
     SourceCodeLexemeInfo current_lexeme_info = {};
     /// @brief The last parsed lexeme informations
     SourceCodeLexemeInfo last_lexeme_info = {};
     /// @brief The current function being parsed
     PTR<const FnDeclExpr> current_function = nullptr;
-    /// @brief Map responsible of storing global state (functions, global variables)
-    Map<StringView, SmallVector<PTR<Expr>>>& global_map;
+    /// @brief Map responsible of storing global state (functions, global variables), by symbol
+    Map<SymbolID, SmallVector<PTR<Expr>>>& global_map;
     /// @brief Table of String literals
     StableSet<String>& str_table;
     /// @brief The context storing types and expressions
     COLTContext& ctx;
+    /// @brief The AST being produced (to which imported modules are added)
+    AST& ast;
+    /// @brief If true, the bodies of functions ('{...}' or ': ...;') are skipped and parsed after all the declarations
+    bool is_deferring_bodies = false;
+    /// @brief The bodies whose parsing was deferred
+    Vector<DeferredBody> deferred_bodies = {};
+    /// @brief The mutex protecting 'str_table' when bodies are parsed in parallel, or nullptr
+    PTR<std::mutex> str_table_mutex = nullptr;
 
     /************* STATE HANDLING HELPERS ************/
 
@@ -158,6 +207,11 @@ namespace colt::lang
     /// @param strv The StringView to parse
     /// @param ast The AST in which to store the result
     ASTMaker(StringView strv, AST& ast) noexcept;
+    /// @brief Creates an ASTMaker parsing deferred bodies on another thread.
+    /// The global table must not be modified while the bodies are parsed.
+    /// @param parent The ASTMaker that parsed the declarations
+    /// @param shard The context in which to store the expressions of the bodies
+    ASTMaker(ASTMaker& parent, COLTContext& shard) noexcept;
     //No default move constructor
     ASTMaker(ASTMaker&&) = delete;
     //No default copy constructor
@@ -213,6 +267,11 @@ namespace colt::lang
     /// @return Resulting expression or ErrorExpr on errors
     PTR<Expr> parse_global_declaration() noexcept;
 
+    /// @brief Parses an import of a module ('import name;').
+    /// Precondition: current_tkn == TKN_KEYWORD_IMPORT
+    /// The declarations of the module are added to the AST.
+    void parse_import() noexcept;
+
     /// @brief Parses a function declaration/definition (FnDefExpr).    
     /// Precondition: current_tkn == TKN_KEYWORD_FN
     /// This function will return a FnDefExpr even if the parsed expression
@@ -220,13 +279,44 @@ namespace colt::lang
     /// @return Resulting expression or ErrorExpr on errors
     PTR<Expr> parse_fn_decl(bool is_extern) noexcept;
 
+    /// @brief Parses the body of a function, adding its parameters to the local variables.
+    /// Precondition: is_valid_scope_begin() and current_function == declaration
+    /// @param declaration The declaration of the function
+    /// @return ScopeExpr or ErrorExpr
+    PTR<Expr> parse_fn_body(PTR<const FnDeclExpr> declaration) noexcept;
+
+    /// @brief Consumes a scope ('{...}' or ': ...;') without parsing it.
+    /// A single statement scope ends with the ';' or '}' that is not
+    /// followed by an 'elif' or 'else'.
+    /// Precondition: is_valid_scope_begin()
+    void skip_scope() noexcept;
+
+    /// @brief Parses the declarations, deferring the parsing of the bodies of functions,
+    /// then parses the bodies concurrently ('-parallel-parse').
+    /// As all the declarations are known before parsing the bodies, a function
+    /// can call functions (and use global variables) declared after it.
+    void parse_parallel() noexcept;
+
+    /// @brief Parses a deferred body, and sets it as the body of its function
+    /// @param body The deferred body
+    void parse_deferred_body(const DeferredBody& body) noexcept;
+
     /// @brief Parses a scope.
     /// If 'one_expr' is true, accepts a single statement scope
     /// (starting with ':', not '{').
     /// Even only one statement is contained inside the scope, the returned
     /// expression will be a ScopeExpr.
+    /// @param one_expr True to accept a single statement scope
+    /// @param fn_body The function whose body is parsed, to which a return is added if missing (or null)
     /// @return ScopeExpr or ErrorExpr
-    PTR<Expr> parse_scope(bool one_expr = true) noexcept;
+    PTR<Expr> parse_scope(bool one_expr = true, PTR<const FnDeclExpr> fn_body = nullptr) noexcept;
+
+    /// @brief Adds the implicit return of a function to the statements of its body,
+    /// if they do not terminate the function.
+    /// 'return 0' is added for 'main', 'return void' for the other functions.
+    /// @param statements The statements of the body of the function
+    /// @param fn_body The function whose body is parsed (or null to not add anything)
+    void add_implicit_return(Vector<PTR<Expr>>& statements, PTR<const FnDeclExpr> fn_body) noexcept;
 
     /// @brief Parses a statement.
     /// @return Resulting expression or ErrorExpr
@@ -237,11 +327,35 @@ namespace colt::lang
     /// @return ConditionExpr or ErrorExpr
     PTR<Expr> parse_condition() noexcept;
 
+    /// @brief Parses a 'switch' expression.
+    /// Precondition: current_tkn == TKN_KEYWORD_SWITCH
+    /// @return SwitchExpr or ErrorExpr
+    PTR<Expr> parse_switch() noexcept;
+
+    /// @brief Parses the values of a 'case', and adds them to 'case_values'.
+    /// Precondition: current_tkn == TKN_KEYWORD_CASE
+    /// @param value The value switched on
+    /// @param case_values The values of the previous cases
+    /// @param body_index The index of the body of the case
+    /// @return True if the values are valid
+    bool parse_case_values(PTR<const Expr> value, Vector<std::pair<PTR<const LiteralExpr>, u64>>& case_values, u64 body_index) noexcept;
+
     /// @brief Parses a 'while' expression.
     /// Precondition: current_tkn == TKN_KEYWORD_WHILE
     /// @return WhileExpr or ErrorExpr
     PTR<Expr> parse_while() noexcept;
 
+    /// @brief Parses a 'for' expression: 'for var i in range(begin, end)'.
+    /// Precondition: current_tkn == TKN_KEYWORD_FOR
+    /// @return ForLoopExpr or ErrorExpr
+    PTR<Expr> parse_for() noexcept;
+
+    /// @brief Parses the arguments of 'range': '(end)' or '(begin, end)'.
+    /// If a single argument is parsed, it is written to 'begin' and 'end' is set to null.
+    /// @param begin The first argument
+    /// @param end The second argument or null
+    void parse_range_args(PTR<Expr>& begin, PTR<Expr>& end) noexcept;
+
     /// @brief Parses a variable declaration (global or local)
     /// @param is_global True if the variable declaration should is global
     /// @return VarDeclExpr or ErrorExpr
@@ -261,16 +375,44 @@ namespace colt::lang
     /// @return Parsed typename or ErrorType
     PTR<const Type> parse_typename(panic_consume_t panic = nullptr) noexcept;
 
+    /// @brief Parses a vector typename: 'vec<TYPE, N>'.
+    /// Precondition: current_tkn == TKN_IDENTIFIER ('vec')
+    /// @param is_const True if the elements are const
+    /// @param panic The panic consume function
+    /// @return Parsed VecType or ErrorType
+    PTR<const Type> parse_vec_typename(bool is_const, panic_consume_t panic) noexcept;
+
     /// @brief Handles an identifier in a primary expression.
     /// The identifier could represent a variable, or a function call
     /// @return VarReadExpr, FnCallExpr, or ErrorExpr
     PTR<Expr> parse_identifier(const SavedExprInfo& line_state) noexcept;
 
+    /// @brief Parses an index into an array or a slice: 'where[index]'.
+    /// Precondition: current_tkn == TKN_LEFT_SQUARE
+    /// @param where The array or slice to index
+    /// @param line_state The line state of the function calling this function
+    /// @return PtrLoadExpr of an IndexExpr, or ErrorExpr
+    PTR<Expr> parse_index(PTR<Expr> where, const SavedExprInfo& line_state) noexcept;
+
+    /// @brief Parses the builtin 'len(...)' of arrays and slices.
+    /// Precondition: current_tkn == TKN_LEFT_PAREN
+    /// @param line_state The line state of the function calling this function
+    /// @return LiteralExpr for arrays, SliceLenExpr for slices, or ErrorExpr
+    PTR<Expr> parse_len(const SavedExprInfo& line_state) noexcept;
+
+    /// @brief Parses the builtin operations on vectors ('shuffle(...)', 'reduce_add(...)', ...).
+    /// Precondition: current_tkn == TKN_LEFT_PAREN
+    /// @param name The name of the operation
+    /// @param intrinsic The operation
+    /// @param line_state The line state of the function calling this function
+    /// @return VecIntrinsicExpr or ErrorExpr
+    PTR<Expr> parse_vec_intrinsic(StringView name, VecIntrinsicExpr::VecIntrinsicID intrinsic, const SavedExprInfo& line_state) noexcept;
+
     /// @brief Handles a function call, with overload resolution
-    /// @param identifier The function name
+    /// @param symbol The function name
     /// @param line_state The line state from of the function calling this function
     /// @return FnCallExpr, or ErrorExpr
-    PTR<Expr> parse_fn_call(StringView identifier, const SavedExprInfo& line_state) noexcept;
+    PTR<Expr> parse_fn_call(SymbolID symbol, const SavedExprInfo& line_state) noexcept;
 
     /// @brief Parses a 'return' statement.
     /// Precondition: current_tkn == TKN_KEYWORD_RETURN.
@@ -294,12 +436,28 @@ namespace colt::lang
     /// @return True if valid
     bool validate_fn_call(const SmallVector<PTR<Expr>, 4>& arguments, PTR<const FnDeclExpr> decl, StringView identifier, const SourceCodeExprInfo& info) noexcept;
 
+    /// @brief Check if indexing 'where' by 'index' can never be out of bounds.
+    /// This is the case for constant indices into arrays, and for variables of
+    /// 'for' loops whose range is contained in the bounds of 'where'.
+    /// @param where The array or slice being indexed
+    /// @param index The index
+    /// @return True if no bounds check is needed
+    bool is_index_in_bounds(PTR<const Expr> where, PTR<const Expr> index) const noexcept;
+
+    /// @brief Rebuilds the source code information of an expression
+    /// @param expr The expression
+    /// @return The source code information of 'expr'
+    SourceCodeExprInfo get_src_info(PTR<const Expr> expr) const noexcept
+    {
+      return ctx.to_src_info(expr->get_src_loc());
+    }
+
     /// @brief Check recursively and prints errors if 'expr' does not end with a return
     void validate_all_path_return(PTR<const Expr> expr) noexcept;
 
-    PTR<Expr> handle_function_call(StringView identifier, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo&  identifier_loc, const SourceCodeExprInfo& fn_call) noexcept;
+    PTR<Expr> handle_function_call(SymbolID symbol, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo&  identifier_loc, const SourceCodeExprInfo& fn_call) noexcept;
 
-    PTR<Expr> save_var_decl(bool is_global, PTR<const Type> var_type, StringView var_name, PTR<Expr> var_init, const SourceCodeExprInfo& src_info) noexcept;
+    PTR<Expr> save_var_decl(bool is_global, PTR<const Type> var_type, SymbolID var_symbol, PTR<Expr> var_init, const SourceCodeExprInfo& src_info) noexcept;
 
     //PTR<Expr> generate_move();
 
@@ -345,6 +503,11 @@ namespace colt::lang
     /// @return LiteralExpr or ErrorExpr
     PTR<Expr> constant_fold(PTR<const LiteralExpr> a, BinaryOperator op, PTR<const LiteralExpr> b, PTR<const BuiltInType> ret, const SourceCodeExprInfo& src_info) noexcept;
 
+    /// @brief Inserts a String in the table of String literals
+    /// @param str The String to insert
+    /// @return Pointer to the String in the table (as a QWORD)
+    QWORD insert_str_literal(String&& str) noexcept;
+
     PTR<Expr> constant_fold_lstring(PTR<const LiteralExpr> a, BinaryOperator op, PTR<const LiteralExpr> b, const SourceCodeExprInfo& src_info) noexcept;
 
     /// @brief Converts 'what' to type 'to', and prints error
@@ -353,6 +516,13 @@ namespace colt::lang
     /// @return Converted expression or ErrorExpr on errors
     PTR<Expr> as_convert_to(PTR<Expr> what, PTR<const Type> to) noexcept;
 
+    /// @brief Converts 'what' to type 'to', where 'to' or the type of 'what' is a vector.
+    /// Scalars are broadcast to all the elements, and arrays are converted element-wise.
+    /// @param what The expression to convert
+    /// @param to The type to convert to
+    /// @return Converted expression or ErrorExpr on errors
+    PTR<Expr> as_convert_vec(PTR<Expr> what, PTR<const Type> to) noexcept;
+
     /************* PEEKING HELPERS ************/
 
     /// @brief Check if the current token is the beginning of a scope
@@ -366,9 +536,9 @@ namespace colt::lang
 
     /// @brief Consumes all tokens till a TKN_SEMICOLON or TKN_EOF is hit
     void panic_consume_semicolon() noexcept;
-    /// @brief Consumes all tokens till a TKN_KEYWORD_VAR, TKN_KEYWORD_FN or TKN_EOF is hit
+    /// @brief Consumes all tokens till a TKN_KEYWORD_VAR, TKN_KEYWORD_FN, TKN_KEYWORD_IMPORT or TKN_EOF is hit
     void panic_consume_decl() noexcept;
-    /// @brief Consumes all tokens till a TKN_KEYWORD_VAR/IF/WHILE/SEMICOLON/EOF is hit, consuming the SEMICOLON
+    /// @brief Consumes all tokens till a TKN_KEYWORD_VAR/IF/WHILE/FOR/SEMICOLON/EOF is hit, consuming the SEMICOLON
     void panic_consume_sttmnt() noexcept;
     /// @brief Consumes all tokens till a TKN_SEMICOLON or TKN_EOF is hit and consumes the TKN_SEMICOLON
     void panic_consume_var_decl() noexcept;
@@ -378,6 +548,8 @@ namespace colt::lang
     void panic_consume_rparen() noexcept;
     /// @brief Consumes the same tokens as panic_consume_sttmnt(), without consuming the SEMICOLON
     void panic_consume_return() noexcept;
+    /// @brief Consumes all tokens till a TKN_KEYWORD_CASE/DEFAULT, TKN_RIGHT_CURLY or TKN_EOF is hit
+    void panic_consume_case() noexcept;
 
     template<typename... Args>
     /// @brief Validates that the current token is 'expected' and consumes it, else generates 'error'
@@ -425,10 +597,18 @@ namespace colt::lang
   {
     /// @brief The array of expressions
     Vector<PTR<Expr>> expressions = {};
-    /// @brief The global function/variable table
-    Map<StringView, SmallVector<PTR<Expr>>> global_map = {};
+    /// @brief The global function/variable table, by symbol
+    Map<SymbolID, SmallVector<PTR<Expr>>> global_map = {};
     /// @brief The table of String literals
     StableSet<String> str_table = {};
+    /// @brief The declarations imported from other modules (without bodies)
+    Vector<PTR<Expr>> imports = {};
+    /// @brief The names of the modules whose declarations were imported
+    Vector<String> imported_modules = {};
+    /// @brief The object files of the imported modules (and of the modules they import)
+    Vector<String> module_objects = {};
+    /// @brief The name and the hash of the source of the imported modules (and of the modules they import)
+    Vector<std::pair<String, u64>> module_hashes = {};
     /// @brief The context storing type and expression informations
     COLTContext& ctx;
 
@@ -438,6 +618,11 @@ namespace colt::lang
       : ctx(ctx) {}
    };
 
+  /// @brief Adds the path of an object file to link to the AST, if not already present
+  /// @param path The path of the object file of a module
+  /// @param ast The AST to which to add the path
+  void AddModuleObject(StringView path, AST& ast) noexcept;
+
   /// @brief Creates an Abstract Syntax Tree by parsing a StringView
   /// @param from The StringView to parse
   /// @param ctx The COLTContext where to store the expressions
@@ -4,36 +4,142 @@
 * and types. It also provides the `add_str` methods which saves
 * a String and returns a StringView of it that follows the lifetime
 * of the COLTContext.
+* Expressions, and the arrays of their children, are stored contiguously
+* in blocks owned by the COLTContext: as expressions are trivially
+* destructible, the blocks are released without visiting the expressions.
+* Expressions store their location as offsets in the sources of the
+* COLTContext, from which their source code information is rebuilt.
 */
 
 #ifndef HG_COLT_CONTEXT
 #define HG_COLT_CONTEXT
 
 #include <util/colt_pch.h>
+#include <new>
 
 #include <ast/colt_expr.h>
 #include <type/colt_type.h>
 
 namespace colt::lang
 {
+  /// @brief Counters of what was stored in a COLTContext (printed by '-stats')
+  struct ContextStats
+  {
+    /// @brief The count of expressions of each kind
+    u64 expr_count[Expr::EXPR_VEC_INTRINSIC + 1] = {};
+    /// @brief The bytes used by the expressions of each kind
+    u64 expr_bytes[Expr::EXPR_VEC_INTRINSIC + 1] = {};
+    /// @brief The bytes used by the arrays of children of expressions
+    u64 array_bytes = 0;
+    /// @brief The bytes of the blocks storing expressions and arrays
+    u64 block_bytes = 0;
+    /// @brief The count of types
+    u64 type_count = 0;
+    /// @brief The count of saved String
+    u64 str_count = 0;
+    /// @brief The bytes of the saved String
+    u64 str_bytes = 0;
+    /// @brief The count of tokens lexed to fill the context
+    u64 token_count = 0;
+
+    /// @brief Adds the counters of other statistics
+    /// @param other The statistics to add
+    /// @return Self
+    ContextStats& operator+=(const ContextStats& other) noexcept
+    {
+      for (size_t i = 0; i < Expr::EXPR_VEC_INTRINSIC + 1; i++)
+      {
+        expr_count[i] += other.expr_count[i];
+        expr_bytes[i] += other.expr_bytes[i];
+      }
+      array_bytes += other.array_bytes;
+      block_bytes += other.block_bytes;
+      type_count += other.type_count;
+      str_count += other.str_count;
+      str_bytes += other.str_bytes;
+      token_count += other.token_count;
+      return *this;
+    }
+  };
+
   /// @brief Class responsible of holding Type and Expr used in the AST
   class COLTContext
   {
+    /// @brief The size of the blocks storing expressions
+    static constexpr size_t EXPR_BLOCK_SIZE = 64 * 1024;
+
     /// @brief Saved String
     FlatList<String, 256> saved_str;
     /// @brief StableSet of types
     FlatList<UniquePtr<Type>, 256> type_set;
-    /// @brief StableSet of expressions
-    FlatList<UniquePtr<Expr>, 256> expr_set;
+    /// @brief Blocks storing the expressions and the arrays of their children
+    FlatList<std::unique_ptr<u64[]>, 64> expr_blocks;
+    /// @brief The next free byte of the last block
+    PTR<u8> block_next = nullptr;
+    /// @brief The count of free bytes in the last block
+    size_t block_free = 0;
+    /// @brief Saved buffers (contents of serialized AST files)
+    FlatList<std::unique_ptr<u64[]>, 16> saved_buffer;
+    /// @brief Contexts used by other threads, whose lifetimes are the one of this context
+    FlatList<std::unique_ptr<COLTContext>, 16> shards;
+    /// @brief The sources parsed into this context, and the offset of their beginning.
+    /// The offsets of the sources follow each other, as if the sources were contiguous.
+    Vector<std::pair<StringView, u32>> sources;
+    /// @brief The statistics of this context (shards add theirs once done)
+    ContextStats stats = {};
+
+    /// @brief Allocates memory in the blocks storing expressions
+    /// @param size The size of the memory (aligned on 8 bytes)
+    /// @return Pointer to the memory
+    PTR<void> allocate(size_t size) noexcept
+    {
+      size = (size + 7) & ~static_cast<size_t>(7);
+      if (size > block_free)
+      {
+        //Arrays bigger than a block are stored in their own block
+        size_t block_size = std::max(size, EXPR_BLOCK_SIZE);
+        expr_blocks.push_back(std::unique_ptr<u64[]>(new u64[block_size / sizeof(u64)]));
+        block_next = reinterpret_cast<PTR<u8>>(expr_blocks.get_back().get());
+        block_free = block_size;
+        stats.block_bytes += block_size;
+      }
+      auto ptr = block_next;
+      block_next += size;
+      block_free -= size;
+      return ptr;
+    }
 
   public:
-    /// @brief Save an expression and returns a pointer to it
-    /// @param expr The expression to add
-    /// @return Pointer to the unique expression
-    PTR<Expr> add_expr(UniquePtr<Expr>&& expr) noexcept
+    template<typename T, typename... Args>
+    /// @brief Constructs an expression and returns a pointer to it
+    /// @tparam T The type of the expression
+    /// @tparam ...Args The types of the arguments of the constructor
+    /// @param ...args The arguments of the constructor
+    /// @return Pointer to the expression, which lives as long as the context
+    PTR<Expr> add_expr(Args&&... args) noexcept
+    {
+      static_assert(std::is_base_of_v<Expr, T>, "T must be an expression!");
+      static_assert(std::is_trivially_destructible_v<T>, "Expressions are never destroyed!");
+      stats.expr_count[T::classof_v] += 1;
+      stats.expr_bytes[T::classof_v] += sizeof(T);
+      return new(allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    /// @brief Copies an array of children (or any trivial data) of an expression
+    /// @tparam T The type of the elements
+    /// @param array The array to copy
+    /// @return View over the copy, which lives as long as the context
+    ContiguousView<T> add_array(ContiguousView<T> array) noexcept
     {
-      expr_set.push_back(std::move(expr));
-      return expr_set.get_back().get_ptr();
+      static_assert(std::is_trivially_destructible_v<T>, "Arrays are never destroyed!");
+      static_assert(alignof(T) <= alignof(u64), "Invalid alignment!");
+      stats.array_bytes += sizeof(T) * array.get_size();
+      auto ptr = static_cast<PTR<T>>(allocate(sizeof(T) * array.get_size()));
+      size_t i = 0;
+      for (const auto& value : array)
+        new(ptr + i++) T(value);
+      return ContiguousView<T>{ ptr, array.get_size() };
     }
 
     /// @brief Save an type and returns a pointer to it
@@ -41,6 +147,7 @@ namespace colt::lang
     /// @return Pointer to the unique type
     PTR<Type> add_type(UniquePtr<Type>&& type) noexcept
     {
+      stats.type_count += 1;
       type_set.push_back(std::move(type));
       return type_set.get_back().get_ptr();
     }
@@ -50,9 +157,109 @@ namespace colt::lang
     /// @return StringView over the saved String
     StringView add_str(String&& str) noexcept
     {
+      stats.str_count += 1;
+      stats.str_bytes += str.get_size();
       saved_str.push_back(std::move(str));
       return saved_str.get_back();
     }
+
+    /// @brief Saves a buffer and returns a pointer to its content.
+    /// This allows StringView to point inside the buffer.
+    /// @param buffer The buffer to save
+    /// @return Pointer to the beginning of the saved buffer
+    const u64* add_buffer(std::unique_ptr<u64[]>&& buffer) noexcept
+    {
+      saved_buffer.push_back(std::move(buffer));
+      return saved_buffer.get_back().get();
+    }
+
+    /// @brief Creates a context whose lifetime is the one of this context.
+    /// As a COLTContext is not thread-safe, each thread adding expressions
+    /// or types in parallel must use its own shard.
+    /// The shard shares the sources of this context.
+    /// @return The new context
+    COLTContext& add_shard() noexcept
+    {
+      shards.push_back(std::make_unique<COLTContext>());
+      auto& shard = *shards.get_back();
+      for (size_t i = 0; i < sources.get_size(); i++)
+        shard.sources.push_back(sources[i]);
+      return shard;
+    }
+
+    /// @brief Adds a source whose expressions are stored in this context.
+    /// The source must live as long as the expressions.
+    /// @param source The source code
+    void add_source(StringView source) noexcept
+    {
+      u32 offset = 0;
+      if (!sources.is_empty())
+        offset = sources.get_back().second + as<u32>(sources.get_back().first.get_size());
+      sources.push_back({ source, offset });
+    }
+
+    /// @brief Converts source code information to the location stored by an expression
+    /// @param info The source code information
+    /// @return The location, without offset if the expression is not in a source of this context
+    SourceCodeLocation to_src_loc(const SourceCodeExprInfo& info) const noexcept
+    {
+      SourceCodeLocation loc = { info.line_begin, info.line_end };
+      if (info.expression.get_data() == nullptr)
+        return loc;
+      //The expressions are most likely in the last source
+      for (size_t i = sources.get_size(); i-- != 0;)
+      {
+        const auto& [source, offset] = sources[i];
+        if (source.begin() <= info.expression.begin() && info.expression.end() <= source.end())
+        {
+          loc.offset = offset + as<u32>(info.expression.begin() - source.begin());
+          loc.size = as<u32>(info.expression.get_size());
+          break;
+        }
+      }
+      return loc;
+    }
+
+    /// @brief Rebuilds the source code information of an expression from its location
+    /// @param loc The location of the expression
+    /// @return The source code information (only the line numbers if the source is unknown)
+    SourceCodeExprInfo to_src_info(SourceCodeLocation loc) const noexcept
+    {
+      SourceCodeExprInfo info = { loc.line_begin, loc.line_end };
+      if (loc.offset == SourceCodeLocation::NO_SOURCE)
+        return info;
+      for (size_t i = sources.get_size(); i-- != 0;)
+      {
+        const auto& [source, offset] = sources[i];
+        if (loc.offset < offset || as<u64>(loc.offset) + loc.size > as<u64>(offset) + source.get_size())
+          continue;
+        const char* begin = source.begin() + (loc.offset - offset);
+        const char* end = begin + loc.size;
+        //The lines on which the expression spans, without their '\n'
+        const char* line_begin = begin;
+        while (line_begin > source.begin() && line_begin[-1] != '\n')
+          --line_begin;
+        const char* line_end = end;
+        while (line_end < source.end() && *line_end != '\n')
+          ++line_end;
+        info.lines = StringView{ line_begin, line_end };
+        info.expression = StringView{ begin, end };
+        break;
+      }
+      return info;
+    }
+
+    /// @brief Counts tokens lexed to fill this context
+    /// @param count The count of tokens
+    void add_token_count(u64 count) noexcept { stats.token_count += count; }
+
+    /// @brief Adds the statistics of a shard to the statistics of this context
+    /// @param shard_stats The statistics of the shard
+    void add_stats(const ContextStats& shard_stats) noexcept { stats += shard_stats; }
+
+    /// @brief Returns the statistics of this context
+    /// @return The statistics
+    const ContextStats& get_stats() const noexcept { return stats; }
   };
 }
 
@@ -9,7 +9,7 @@ namespace colt::lang
 { 
   PTR<Expr> LiteralExpr::CreateExpr(QWORD value, PTR<const Type> type, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<LiteralExpr>(value, type, src_info));
+    return ctx.add_expr<LiteralExpr>(value, type, ctx.to_src_loc(src_info));
   }
 
   PTR<Expr> LiteralExpr::CreateExpr(QWORD value, Token tkn, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
@@ -33,88 +33,88 @@ namespace colt::lang
     break; case TKN_STRING_L: type = PtrType::CreateLString(true, ctx);
     break; default: colt_unreachable("Invalid Literal Token!");
     }
-    return ctx.add_expr(make_unique<LiteralExpr>(value, type, src_info));
+    return ctx.add_expr<LiteralExpr>(value, type, ctx.to_src_loc(src_info));
   }
   
   PTR<Expr> UnaryExpr::CreateExpr(PTR<const Type> type, Token tkn, PTR<Expr> child, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<UnaryExpr>(type, tkn, child, src_info));
+    return ctx.add_expr<UnaryExpr>(type, tkn, child, ctx.to_src_loc(src_info));
   }
 
   PTR<Expr> BinaryExpr::CreateExpr(PTR<const Type> type, PTR<Expr> lhs, Token op, PTR<Expr> rhs, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<BinaryExpr>(type, lhs, op, rhs, src_info));
+    return ctx.add_expr<BinaryExpr>(type, lhs, op, rhs, ctx.to_src_loc(src_info));
   }
   
   PTR<Expr> ConvertExpr::CreateExpr(PTR<const Type> type, PTR<Expr> to_convert, Token cnv, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
     assert_true(cnv == TKN_KEYWORD_AS || cnv == TKN_KEYWORD_BIT_AS, "Expected a conversion token!");
-    return ctx.add_expr(make_unique<ConvertExpr>(type, to_convert, 
-      cnv == TKN_KEYWORD_AS ? CNV_AS : CNV_BIT_AS, src_info));
+    return ctx.add_expr<ConvertExpr>(type, to_convert, 
+      cnv == TKN_KEYWORD_AS ? CNV_AS : CNV_BIT_AS, ctx.to_src_loc(src_info));
   }
   
-  PTR<Expr> VarDeclExpr::CreateExpr(PTR<const Type> type, StringView name, PTR<Expr> init_value, bool is_global, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  PTR<Expr> VarDeclExpr::CreateExpr(PTR<const Type> type, SymbolID symbol, PTR<Expr> init_value, bool is_global, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<VarDeclExpr>(type, name, init_value, is_global, src_info));
+    return ctx.add_expr<VarDeclExpr>(type, symbol, init_value, is_global, ctx.to_src_loc(src_info));
   }
   
-  PTR<Expr> VarReadExpr::CreateExpr(PTR<const Type> type, StringView name, u64 ID, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  PTR<Expr> VarReadExpr::CreateExpr(PTR<const Type> type, SymbolID symbol, u64 ID, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<VarReadExpr>(type, name, ID, src_info));
+    return ctx.add_expr<VarReadExpr>(type, symbol, ID, ctx.to_src_loc(src_info));
   }
   
-  PTR<Expr> VarReadExpr::CreateExpr(PTR<const Type> type, StringView name, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  PTR<Expr> VarReadExpr::CreateExpr(PTR<const Type> type, SymbolID symbol, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<VarReadExpr>(type, name, src_info));
+    return ctx.add_expr<VarReadExpr>(type, symbol, ctx.to_src_loc(src_info));
   }
   
   PTR<Expr> VarWriteExpr::CreateExpr(PTR<const VarReadExpr> var, PTR<Expr> value, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<VarWriteExpr>(var->get_type(), var->get_name(), value, var->unsafe_get_local_id(), src_info));
+    return ctx.add_expr<VarWriteExpr>(var->get_type(), var->get_symbol(), value, var->unsafe_get_local_id(), ctx.to_src_loc(src_info));
   }
   
   PTR<Expr> FnReturnExpr::CreateExpr(PTR<Expr> to_ret, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<FnReturnExpr>(
-      to_ret ? to_ret->get_type() : VoidType::CreateType(ctx), to_ret, src_info
-      ));
+    return ctx.add_expr<FnReturnExpr>(
+      to_ret ? to_ret->get_type() : VoidType::CreateType(ctx), to_ret, ctx.to_src_loc(src_info)
+      );
   }
   
   PTR<Expr> FnDeclExpr::CreateExpr(PTR<const Type> type, StringView name, SmallVector<StringView, 4>&& arguments_name, bool is_extern, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<FnDeclExpr>(
-      type, name, std::move(arguments_name), is_extern, src_info
-      ));
+    return ctx.add_expr<FnDeclExpr>(
+      type, name, ctx.add_array<StringView>(arguments_name.to_view()), is_extern, ctx.to_src_loc(src_info)
+      );
   }
 
   PTR<Expr> FnDefExpr::CreateExpr(PTR<FnDeclExpr> decl, PTR<Expr> body, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
     assert(is_a<FnDeclExpr>(static_cast<Expr*>(decl)));
-    return ctx.add_expr(make_unique<FnDefExpr>(
-      decl->get_type(), decl, body, src_info
-      ));
+    return ctx.add_expr<FnDefExpr>(
+      decl->get_type(), decl, body, ctx.to_src_loc(src_info)
+      );
   }
   
   PTR<Expr> FnDefExpr::CreateExpr(PTR<FnDeclExpr> decl, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
     assert(is_a<FnDeclExpr>(static_cast<Expr*>(decl)));
-    return ctx.add_expr(make_unique<FnDefExpr>(
-      decl->get_type(), decl, nullptr, src_info
-      ));
+    return ctx.add_expr<FnDefExpr>(
+      decl->get_type(), decl, nullptr, ctx.to_src_loc(src_info)
+      );
   }
 
   PTR<Expr> FnCallExpr::CreateExpr(PTR<const FnDeclExpr> decl, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<FnCallExpr>(
-      decl, std::move(arguments), src_info
-      ));
+    return ctx.add_expr<FnCallExpr>(
+      decl, ctx.add_array<PTR<Expr>>(arguments.to_view()), ctx.to_src_loc(src_info)
+      );
   }
   
   PTR<Expr> ScopeExpr::CreateExpr(Vector<PTR<Expr>>&& body, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<ScopeExpr>(
-      VoidType::CreateType(ctx), std::move(body), src_info
-      ));
+    return ctx.add_expr<ScopeExpr>(
+      VoidType::CreateType(ctx), ctx.add_array<PTR<Expr>>(body.to_view()), ctx.to_src_loc(src_info)
+      );
   }
 
   PTR<Expr> ScopeExpr::CreateExpr(std::initializer_list<PTR<Expr>> list, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
@@ -127,37 +127,51 @@ namespace colt::lang
   
   PTR<Expr> ConditionExpr::CreateExpr(PTR<Expr> if_cond, PTR<Expr> if_stmt, PTR<Expr> else_stmt, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<ConditionExpr>(
-      VoidType::CreateType(ctx), if_cond, if_stmt, else_stmt, src_info
-      ));
+    return ctx.add_expr<ConditionExpr>(
+      VoidType::CreateType(ctx), if_cond, if_stmt, else_stmt, ctx.to_src_loc(src_info)
+      );
+  }
+
+  PTR<Expr> SwitchExpr::CreateExpr(PTR<Expr> value, Vector<std::pair<PTR<const LiteralExpr>, u64>>&& case_values, Vector<PTR<Expr>>&& case_bodies, PTR<Expr> default_body, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  {
+    return ctx.add_expr<SwitchExpr>(
+      VoidType::CreateType(ctx), value, ctx.add_array<std::pair<PTR<const LiteralExpr>, u64>>(case_values.to_view()), ctx.add_array<PTR<Expr>>(case_bodies.to_view()), default_body, ctx.to_src_loc(src_info)
+      );
+  }
+
+  PTR<Expr> ForLoopExpr::CreateExpr(StringView var_name, PTR<const Type> var_type, PTR<Expr> begin, PTR<Expr> end, PTR<Expr> body, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  {
+    return ctx.add_expr<ForLoopExpr>(
+      VoidType::CreateType(ctx), var_name, var_type, begin, end, body, ctx.to_src_loc(src_info)
+      );
   }
 
   PTR<Expr> WhileLoopExpr::CreateExpr(PTR<Expr> condition, PTR<Expr> body, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<WhileLoopExpr>(
-      VoidType::CreateType(ctx), condition, body, src_info
-      ));
+    return ctx.add_expr<WhileLoopExpr>(
+      VoidType::CreateType(ctx), condition, body, ctx.to_src_loc(src_info)
+      );
   }
 
   PTR<Expr> BreakContinueExpr::CreateExpr(bool is_break, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<BreakContinueExpr>(
-      VoidType::CreateType(ctx), is_break, src_info
-      ));
+    return ctx.add_expr<BreakContinueExpr>(
+      VoidType::CreateType(ctx), is_break, ctx.to_src_loc(src_info)
+      );
   }
   
   PTR<Expr> ErrorExpr::CreateExpr(COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<ErrorExpr>(
+    return ctx.add_expr<ErrorExpr>(
       ctx.add_type(make_unique<ErrorType>())
-      ));
+      );
   }  
   
   PTR<Expr> NoOpExpr::CreateExpr(const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
-    return ctx.add_expr(make_unique<NoOpExpr>(
-      VoidType::CreateType(ctx), src_info
-      ));
+    return ctx.add_expr<NoOpExpr>(
+      VoidType::CreateType(ctx), ctx.to_src_loc(src_info)
+      );
   }
   
   PTR<Expr> PtrStoreExpr::CreateExpr(PTR<Expr> where, PTR<Expr> value, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
@@ -166,16 +180,47 @@ namespace colt::lang
     assert_true(!as<PTR<const PtrType>>(where->get_type())->get_type_to()->is_const(),
       "Cannot write to pointer to const type!");
     
-    return ctx.add_expr(make_unique<PtrStoreExpr>(
-      as<PTR<const PtrType>>(where->get_type()), where, value, src_info
-      ));
+    return ctx.add_expr<PtrStoreExpr>(
+      as<PTR<const PtrType>>(where->get_type()), where, value, ctx.to_src_loc(src_info)
+      );
   }
   
   PTR<Expr> PtrLoadExpr::CreateExpr(PTR<Expr> where, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
   {
     assert_true(where->get_type()->is_ptr(), "Expected a pointer type!");
-    return ctx.add_expr(make_unique<PtrLoadExpr>(
-      as<PTR<const PtrType>>(where->get_type()), where, src_info
-      ));
+    return ctx.add_expr<PtrLoadExpr>(
+      as<PTR<const PtrType>>(where->get_type()), where, ctx.to_src_loc(src_info)
+      );
+  }
+  
+  PTR<Expr> IndexExpr::CreateExpr(PTR<Expr> where, PTR<Expr> index, bool is_checked, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  {
+    PTR<const Type> type_of = where->get_type()->is_array()
+      ? as<PTR<const ArrayType>>(where->get_type())->get_type_of()
+      : as<PTR<const SliceType>>(where->get_type())->get_type_of();
+    return ctx.add_expr<IndexExpr>(
+      PtrType::CreatePtr(true, type_of, ctx), where, index, is_checked, ctx.to_src_loc(src_info)
+      );
+  }
+  
+  PTR<Expr> SliceLenExpr::CreateExpr(PTR<Expr> slice, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  {
+    return ctx.add_expr<SliceLenExpr>(
+      BuiltInType::CreateU64(true, ctx), slice, ctx.to_src_loc(src_info)
+      );
+  }
+  
+  PTR<Expr> ToSliceExpr::CreateExpr(PTR<const Type> type, PTR<Expr> array, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  {
+    return ctx.add_expr<ToSliceExpr>(
+      type, array, ctx.to_src_loc(src_info)
+      );
+  }
+  
+  PTR<Expr> VecIntrinsicExpr::CreateExpr(PTR<const Type> type, VecIntrinsicID intrinsic, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  {
+    return ctx.add_expr<VecIntrinsicExpr>(
+      type, intrinsic, ctx.add_array<PTR<Expr>>(arguments.to_view()), ctx.to_src_loc(src_info)
+      );
   }
-}
\ No newline at end of file
+}
@@ -9,6 +9,7 @@
 
 #include <util/colt_pch.h>
 #include <io/colt_error_report.h>
+#include <lexer/colt_symbol.h>
 #include <type/colt_type.h>
 #include <ast/colt_operators.h>
 
@@ -86,6 +87,8 @@ namespace colt::lang
       EXPR_SCOPE,
       /// @brief ConditionExpr
       EXPR_CONDITION,
+      /// @brief SwitchExpr
+      EXPR_SWITCH,
       /// @brief ForLoopExpr
       EXPR_FOR_LOOP,
       /// @brief WhileLoopExpr
@@ -97,7 +100,15 @@ namespace colt::lang
       /// @brief PtrStoreExpr
       EXPR_PTR_STORE,
       /// @brief PtrLoadExpr
-      EXPR_PTR_LOAD
+      EXPR_PTR_LOAD,
+      /// @brief IndexExpr
+      EXPR_INDEX,
+      /// @brief SliceLenExpr
+      EXPR_SLICE_LEN,
+      /// @brief ToSliceExpr
+      EXPR_TO_SLICE,
+      /// @brief VecIntrinsicExpr
+      EXPR_VEC_INTRINSIC
     };
 
     /// @brief Helper for dyn_cast and is_a
@@ -109,8 +120,8 @@ namespace colt::lang
     ExprID ID;
     /// @brief The type of the expression
     PTR<const Type> type;
-    /// @brief The source code information of the current expression
-    SourceCodeExprInfo src_info;
+    /// @brief The location of the expression in the source code
+    SourceCodeLocation src_loc;
 
   public:
     Expr() = delete;
@@ -120,12 +131,14 @@ namespace colt::lang
     /// @brief Constructor
     /// @param ID The expression ID
     /// @param type The type of the expression	
-    /// @param src_info The source code information
-    Expr(ExprID ID, PTR<const Type> type, const SourceCodeExprInfo& src_info) noexcept
-      : ID(ID), type(type), src_info(src_info) {}
+    /// @param src_loc The location in the source code
+    Expr(ExprID ID, PTR<const Type> type, SourceCodeLocation src_loc) noexcept
+      : ID(ID), type(type), src_loc(src_loc) {}
     
-    /// @brief Destructor
-    virtual ~Expr() noexcept = default;
+    /// @brief Destructor.
+    /// Expressions are never destroyed (their memory is owned by the COLTContext),
+    /// so they must be trivially destructible: no virtual functions are needed.
+    ~Expr() noexcept = default;
 
     /// @brief Returns the actual type of the Expr
     /// @return The ExprID of the current expression
@@ -139,9 +152,10 @@ namespace colt::lang
     /// @param ntype The new type of the expression
     constexpr void set_type(PTR<const Type> ntype) noexcept { type = ntype; }
 
-    /// @brief Returns the source code information of the expressions
-    /// @return The source code information of the expression
-    constexpr const SourceCodeExprInfo& get_src_code() const noexcept { return src_info; }
+    /// @brief Returns the location of the expression in the source code.
+    /// The source code information is rebuilt by COLTContext::to_src_info.
+    /// @return The location of the expression
+    constexpr SourceCodeLocation get_src_loc() const noexcept { return src_loc; }
   };
 
   /// @brief Represents a literal expression
@@ -156,7 +170,7 @@ namespace colt::lang
     ErrorExpr(PTR<const Type> type)
       : Expr(EXPR_ERROR, type, {}) {}
     /// @brief Destructor
-    ~ErrorExpr() noexcept override = default;
+    ~ErrorExpr() noexcept = default;
 
     /// @brief Returns an error type
     /// @return ErrorType
@@ -185,14 +199,14 @@ namespace colt::lang
     /// @brief No default constructor
     LiteralExpr() = delete;
     /// @brief Destructor
-    ~LiteralExpr() noexcept override = default;
+    ~LiteralExpr() noexcept = default;
 
     /// @brief Constructor
     /// @param value The value of the literal expression
     /// @param type The type of the resulting expression
-    /// @param src_info The source code information
-    LiteralExpr(QWORD value, PTR<const Type> type, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_LITERAL, type, src_info), value(value)
+    /// @param src_loc The location in the source code
+    LiteralExpr(QWORD value, PTR<const Type> type, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_LITERAL, type, src_loc), value(value)
     {
       assert_true(type->is_builtin()
         || type->is_lstring(), "Type of LiteralExpr should be BuiltInType || lstring");
@@ -253,14 +267,21 @@ namespace colt::lang
     //No default constructor
     UnaryExpr() = delete;
     /// @brief Destructor
-    ~UnaryExpr() noexcept override = default;
+    ~UnaryExpr() noexcept = default;
     /// @brief Constructor
     /// @param type The type of the resulting expression
     /// @param tkn_op The unary operator of the expression
     /// @param child The expression on which the operator is applied
-    /// @param src_info The source code information
-    UnaryExpr(PTR<const Type> type, Token tkn_op, PTR<Expr> child, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_UNARY, type, src_info), operation(TokenToUnaryOperator(tkn_op)), child(child) {}
+    /// @param src_loc The location in the source code
+    UnaryExpr(PTR<const Type> type, Token tkn_op, PTR<Expr> child, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_UNARY, type, src_loc), operation(TokenToUnaryOperator(tkn_op)), child(child) {}
+    /// @brief Constructor
+    /// @param type The type of the resulting expression
+    /// @param op The unary operator of the expression
+    /// @param child The expression on which the operator is applied
+    /// @param src_loc The location in the source code
+    UnaryExpr(PTR<const Type> type, UnaryOperator op, PTR<Expr> child, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_UNARY, type, src_loc), operation(op), child(child) {}
 
     /// @brief Returns the child of the unary expression
     /// @return Pointer to the child
@@ -302,15 +323,23 @@ namespace colt::lang
     //No default constructor
     BinaryExpr() = delete;
     /// @brief Destructor
-    ~BinaryExpr() noexcept override = default;		
+    ~BinaryExpr() noexcept = default;		
     /// @brief Creates a binary expression of 'lhs' 'operation' 'rhs'
     /// @param type The type of the expression
     /// @param lhs The left hand side of the expression
     /// @param operation The binary operator token
     /// @param rhs The right hand side of the expression
-    /// @param src_info The source code information
-    BinaryExpr(PTR<const Type> type, PTR<Expr> lhs, Token operation, PTR<Expr> rhs, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_BINARY, type, src_info), lhs(lhs), operation(TokenToBinaryOperator(operation)), rhs(rhs) {}
+    /// @param src_loc The location in the source code
+    BinaryExpr(PTR<const Type> type, PTR<Expr> lhs, Token operation, PTR<Expr> rhs, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_BINARY, type, src_loc), lhs(lhs), operation(TokenToBinaryOperator(operation)), rhs(rhs) {}
+    /// @brief Creates a binary expression of 'lhs' 'operation' 'rhs'
+    /// @param type The type of the expression
+    /// @param lhs The left hand side of the expression
+    /// @param operation The binary operator
+    /// @param rhs The right hand side of the expression
+    /// @param src_loc The location in the source code
+    BinaryExpr(PTR<const Type> type, PTR<Expr> lhs, BinaryOperator operation, PTR<Expr> rhs, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_BINARY, type, src_loc), lhs(lhs), operation(operation), rhs(rhs) {}
 
     /// @brief Returns the left hand side of the unary expression
     /// @return Pointer to the lhs
@@ -361,13 +390,13 @@ namespace colt::lang
     /// @brief No default constructor
     ConvertExpr() = delete;
     /// @brief Destructor
-    ~ConvertExpr() noexcept override = default;
+    ~ConvertExpr() noexcept = default;
     /// @brief Constructor
     /// @param type The new type of the expression
     /// @param to_convert The expression to convert
-    /// @param src_info The source code information
-    ConvertExpr(PTR<const Type> type, PTR<Expr> to_convert, ConversionType cnv, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_CONVERT, type, src_info), to_convert(to_convert), cnv(cnv)
+    /// @param src_loc The location in the source code
+    ConvertExpr(PTR<const Type> type, PTR<Expr> to_convert, ConversionType cnv, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_CONVERT, type, src_loc), to_convert(to_convert), cnv(cnv)
     {
       assert_true(type->is_builtin(), "Type of ConvertExpr should be BuiltInType");
     }
@@ -412,7 +441,7 @@ namespace colt::lang
     /// @brief The initial value of the variable, can be null
     PTR<Expr> init_value;
     /// @brief The name of the variable
-    StringView name;
+    SymbolID symbol;
   
   public:
     //No default copy constructor 
@@ -420,15 +449,15 @@ namespace colt::lang
     //No default constructor
     VarDeclExpr() = delete;
     /// @brief Destructor
-    ~VarDeclExpr() noexcept override = default;
+    ~VarDeclExpr() noexcept = default;
     /// @brief Constructs a variable declaration expression
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable
+    /// @param symbol The name of the variable
     /// @param init_value The initial value of the variable, can be null
     /// @param is_global True if the variable is global
-    /// @param src_info The source code information
-    VarDeclExpr(PTR<const Type> type, StringView name, PTR<Expr> init_value, bool is_global, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_VAR_DECL, type, src_info), is_global_v(is_global), init_value(init_value), name(name) {}
+    /// @param src_loc The location in the source code
+    VarDeclExpr(PTR<const Type> type, SymbolID symbol, PTR<Expr> init_value, bool is_global, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_VAR_DECL, type, src_loc), is_global_v(is_global), init_value(init_value), symbol(symbol) {}
 
     /// @brief Get the initial value of the variable
     /// @return Null or pointer to the initial value
@@ -439,7 +468,10 @@ namespace colt::lang
 
     /// @brief Returns the name of the global variable
     /// @return The name of the variable
-    StringView get_name() const noexcept { return name; }
+    StringView get_name() const noexcept { return GetSymbolName(symbol); }
+    /// @brief Returns the interned name of the variable
+    /// @return The symbol of the variable
+    SymbolID get_symbol() const noexcept { return symbol; }
 
     /// @brief Check if the variable is global or not
     /// @return True if the variable is global
@@ -451,13 +483,13 @@ namespace colt::lang
 
     /// @brief Creates a VarDeclExpr
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable
+    /// @param symbol The name of the variable
     /// @param init_value The value of the variable, which can be null
     /// @param is_global True if the variable is global
     /// @param src_info The source code information
     /// @param ctx The COLTContext to store the resulting expression
     /// @return Pointer to the created expression
-    static PTR<Expr> CreateExpr(PTR<const Type> type, StringView name, PTR<Expr> init_value, bool is_global, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+    static PTR<Expr> CreateExpr(PTR<const Type> type, SymbolID symbol, PTR<Expr> init_value, bool is_global, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
   };
 
   /// @brief Represents a read from a variable
@@ -472,7 +504,7 @@ namespace colt::lang
     /// @brief True if the variable is global
     u64 local_ID;
     /// @brief The name of the variable
-    StringView name;
+    SymbolID symbol;
 
   public:
     //No default copy constructor 
@@ -480,24 +512,27 @@ namespace colt::lang
     //No default constructor
     VarReadExpr() = delete;
     /// @brief Destructor
-    ~VarReadExpr() noexcept override = default;
+    ~VarReadExpr() noexcept = default;
     /// @brief Constructs a read from a global variable of name 'name'
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable
-    /// @param src_info The source code information
-    VarReadExpr(PTR<const Type> type, StringView name, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_VAR_READ, type, src_info), local_ID(std::numeric_limits<u64>::max()), name(name) {}
+    /// @param symbol The name of the variable
+    /// @param src_loc The location in the source code
+    VarReadExpr(PTR<const Type> type, SymbolID symbol, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_VAR_READ, type, src_loc), local_ID(std::numeric_limits<u64>::max()), symbol(symbol) {}
     /// @brief Constructs a read from a local variable of name 'name'
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable
+    /// @param symbol The name of the variable
     /// @param local_ID The local ID of the variable
-    /// @param src_info The source code information
-    VarReadExpr(PTR<const Type> type, StringView name, u64 local_ID, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_VAR_READ, type, src_info), local_ID(local_ID), name(name) { assert_true(!is_global(), "Invalid local ID!"); }
+    /// @param src_loc The location in the source code
+    VarReadExpr(PTR<const Type> type, SymbolID symbol, u64 local_ID, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_VAR_READ, type, src_loc), local_ID(local_ID), symbol(symbol) { assert_true(!is_global(), "Invalid local ID!"); }
 
     /// @brief Returns the name of the global variable
     /// @return The name of the variable
-    StringView get_name() const noexcept { return name; }
+    StringView get_name() const noexcept { return GetSymbolName(symbol); }
+    /// @brief Returns the interned name of the variable
+    /// @return The symbol of the variable
+    SymbolID get_symbol() const noexcept { return symbol; }
 
     /// @brief Check if the variable is global
     /// @return True if the variable is global
@@ -514,19 +549,19 @@ namespace colt::lang
 
     /// @brief Creates a VarReadExpr
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable
+    /// @param symbol The name of the variable
     /// @param ID The local ID of the variable
     /// @param src_info The source code information
     /// @param ctx The COLTContext to store the resulting expression
     /// @return Pointer to the created expression
-    static PTR<Expr> CreateExpr(PTR<const Type> type, StringView name, u64 ID, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+    static PTR<Expr> CreateExpr(PTR<const Type> type, SymbolID symbol, u64 ID, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
     /// @brief Creates a VarReadExpr of a global variables
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable
+    /// @param symbol The name of the variable
     /// @param src_info The source code information
     /// @param ctx The COLTContext to store the resulting expression
     /// @return Pointer to the created expression
-    static PTR<Expr> CreateExpr(PTR<const Type> type, StringView name, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+    static PTR<Expr> CreateExpr(PTR<const Type> type, SymbolID symbol, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
   };
 
   /// @brief Represents a write to a variable
@@ -543,7 +578,7 @@ namespace colt::lang
     /// @brief The value of the variable at initialization
     PTR<Expr> value;
     /// @brief The name of the variable
-    StringView name;
+    SymbolID symbol;
 
   public:
     //No default copy constructor 
@@ -551,22 +586,22 @@ namespace colt::lang
     //No default constructor
     VarWriteExpr() = delete;
     /// @brief Destructor
-    ~VarWriteExpr() noexcept override = default;
+    ~VarWriteExpr() noexcept = default;
     /// @brief Constructs a write to a global variable
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable to write to
+    /// @param symbol The name of the variable to write to
     /// @param value The value to write to the variable
-    /// @param src_info The source code information
-    VarWriteExpr(PTR<const Type> type, StringView name, PTR<Expr> value, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_VAR_WRITE, type, src_info), local_ID(std::numeric_limits<u64>::max()), value(value), name(name) {}
+    /// @param src_loc The location in the source code
+    VarWriteExpr(PTR<const Type> type, SymbolID symbol, PTR<Expr> value, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_VAR_WRITE, type, src_loc), local_ID(std::numeric_limits<u64>::max()), value(value), symbol(symbol) {}
     /// @brief Constructs a write to a local variable
     /// @param type The type of the resulting expression
-    /// @param name The name of the variable to write to
+    /// @param symbol The name of the variable to write to
     /// @param value The value to write to the variable
     /// @param local_ID The local ID of the variable
-    /// @param src_info The source code information
-    VarWriteExpr(PTR<const Type> type, StringView name, PTR<Expr> value, u64 local_ID, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_VAR_WRITE, type, src_info), local_ID(local_ID), value(value), name(name) {}
+    /// @param src_loc The location in the source code
+    VarWriteExpr(PTR<const Type> type, SymbolID symbol, PTR<Expr> value, u64 local_ID, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_VAR_WRITE, type, src_loc), local_ID(local_ID), value(value), symbol(symbol) {}
 
     /// @brief Get the expression to convert
     /// @return The expression to converse
@@ -574,7 +609,10 @@ namespace colt::lang
 
     /// @brief Returns the name of the global variable
     /// @return The name of the variable
-    StringView get_name() const noexcept { return name; }
+    StringView get_name() const noexcept { return GetSymbolName(symbol); }
+    /// @brief Returns the interned name of the variable
+    /// @return The symbol of the variable
+    SymbolID get_symbol() const noexcept { return symbol; }
 
     /// @brief Check if the variable is global
     /// @return True if the variable is global
@@ -616,13 +654,13 @@ namespace colt::lang
     //No default constructor
     FnReturnExpr() = delete;
     /// @brief Destructor
-    ~FnReturnExpr() noexcept override = default;
+    ~FnReturnExpr() noexcept = default;
     /// @brief Constructs a function return
     /// @param type The type of the resulting expression
     /// @param to_ret The value to return, can be null
-    /// @param src_info The source code information
-    FnReturnExpr(PTR<const Type> type, PTR<Expr> to_ret, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_FN_RETURN, type, src_info), to_ret(to_ret) {}
+    /// @param src_loc The location in the source code
+    FnReturnExpr(PTR<const Type> type, PTR<Expr> to_ret, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_FN_RETURN, type, src_loc), to_ret(to_ret) {}
 
     /// @brief Get the return value
     /// @return The value
@@ -645,8 +683,8 @@ namespace colt::lang
     static constexpr ExprID classof_v = EXPR_FN_DECL;
 
   private:
-    /// @brief The argument of the function
-    SmallVector<StringView, 4> arguments_name;
+    /// @brief The argument of the function (stored in the COLTContext)
+    ContiguousView<StringView> arguments_name;
     /// @brief The name of the function
     StringView name;
     /// @brief True if the function is 'extern'
@@ -658,15 +696,15 @@ namespace colt::lang
     //No default constructor
     FnDeclExpr() = delete;
     /// @brief Destructor
-    ~FnDeclExpr() noexcept override = default;
+    ~FnDeclExpr() noexcept = default;
     /// @brief Creates function definition
     /// @param type The function type
     /// @param name The name of the function
     /// @param arguments_name The arguments name
     /// @param is_extern_v True if the function is extern
-    /// @param src_info The source code information
-    FnDeclExpr(PTR<const Type> type, StringView name, SmallVector<StringView, 4>&& arguments_name, bool is_extern_v, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_FN_DECL, type, src_info), arguments_name(std::move(arguments_name)), name(name), is_extern_v(is_extern_v)
+    /// @param src_loc The location in the source code
+    FnDeclExpr(PTR<const Type> type, StringView name, ContiguousView<StringView> arguments_name, bool is_extern_v, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_FN_DECL, type, src_loc), arguments_name(arguments_name), name(name), is_extern_v(is_extern_v)
     {
       assert_true(type->is_fn(), "Expected a function type!");
     }
@@ -683,7 +721,7 @@ namespace colt::lang
     size_t get_params_count() const noexcept { return arguments_name.get_size(); }
     /// @brief Returns the parameter names
     /// @return View over the parameter names
-    ContiguousView<StringView> get_params_name() const noexcept { return arguments_name.to_view(); }
+    ContiguousView<StringView> get_params_name() const noexcept { return arguments_name; }
     /// @brief Returns the parameter types
     /// @return View over the parameter types
     ContiguousView<PTR<const Type>> get_params_type() const noexcept { return as<PTR<const FnType>>(Expr::get_type())->get_params_type(); }
@@ -736,14 +774,14 @@ namespace colt::lang
     //No default constructor
     FnDefExpr() = delete;
     /// @brief Destructor
-    ~FnDefExpr() noexcept override = default;    
+    ~FnDefExpr() noexcept = default;    
     /// @brief Creates function definition
     /// @param type The function type
     /// @param decl The declaration of the function
     /// @param body The body of the function
-    /// @param src_info The source code information
-    FnDefExpr(PTR<const Type> type, PTR<FnDeclExpr> decl, PTR<Expr> body, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_FN_DEF, type, src_info), body(body), declaration(decl)
+    /// @param src_loc The location in the source code
+    FnDefExpr(PTR<const Type> type, PTR<FnDeclExpr> decl, PTR<Expr> body, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_FN_DEF, type, src_loc), body(body), declaration(decl)
     {
       assert_true(type->is_fn(), "Expected a function type!");
     }
@@ -822,8 +860,8 @@ namespace colt::lang
     static constexpr ExprID classof_v = EXPR_FN_CALL;
 
   private:
-    /// @brief The arguments of the function
-    SmallVector<PTR<Expr>, 4> arguments;
+    /// @brief The arguments of the function (stored in the COLTContext)
+    ContiguousView<PTR<Expr>> arguments;
     /// @brief The function's declaration
     PTR<const FnDeclExpr> declaration;
 
@@ -833,13 +871,13 @@ namespace colt::lang
     //No default constructor
     FnCallExpr() = delete;
     /// @brief Destructor
-    ~FnCallExpr() noexcept override = default;
+    ~FnCallExpr() noexcept = default;
     /// @brief Creates function definition
     /// @param decl The declaration of the function being called
     /// @param arguments The arguments to pass to the function
-    /// @param src_info The source code information
-    FnCallExpr(PTR<const FnDeclExpr> decl, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_FN_CALL, decl->get_return_type(), src_info), arguments(std::move(arguments)), declaration(decl)
+    /// @param src_loc The location in the source code
+    FnCallExpr(PTR<const FnDeclExpr> decl, ContiguousView<PTR<Expr>> arguments, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_FN_CALL, decl->get_return_type(), src_loc), arguments(arguments), declaration(decl)
     {}
 
     /// @brief Returns declaration of the function
@@ -848,7 +886,7 @@ namespace colt::lang
 
     /// @brief Returns the arguments of the function call
     /// @return View over the arguments
-    ContiguousView<PTR<Expr>> get_arguments() const noexcept { return arguments.to_view(); }
+    ContiguousView<PTR<Expr>> get_arguments() const noexcept { return arguments; }
 
     /// @brief Creates a function call
     /// @param decl The declaration of the function being called
@@ -868,8 +906,8 @@ namespace colt::lang
     static constexpr ExprID classof_v = EXPR_SCOPE;
 
   private:
-    /// @brief The argument of the function
-    Vector<PTR<Expr>> body_expr;
+    /// @brief The expressions of the scope (stored in the COLTContext)
+    ContiguousView<PTR<Expr>> body_expr;
 
   public:
     //No default copy constructor 
@@ -877,25 +915,17 @@ namespace colt::lang
     //No default constructor
     ScopeExpr() = delete;
     /// @brief Destructor
-    ~ScopeExpr() noexcept override = default;		
+    ~ScopeExpr() noexcept = default;		
     /// @brief Constructs a ScopeExpr from an array of Expr*
     /// @param type The type of the resulting expression
-    /// @param body_expr The Vector of expressions contained in the scope
-    /// @param src_info The source code information
-    ScopeExpr(PTR<const Type> type, Vector<PTR<Expr>>&& body_expr, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_SCOPE, type, src_info), body_expr(std::move(body_expr)) {}
-
-    /// @brief Sets the body of the scope to 'body'
-    /// @param body The new body
-    void set_body_array(Vector<PTR<Expr>>&& body) noexcept { body_expr = std::move(body); }
+    /// @param body_expr The expressions contained in the scope (stored in the COLTContext)
+    /// @param src_loc The location in the source code
+    ScopeExpr(PTR<const Type> type, ContiguousView<PTR<Expr>> body_expr, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_SCOPE, type, src_loc), body_expr(body_expr) {}
 
     /// @brief Get the expression to convert
     /// @return The expression to converse
-    ContiguousView<PTR<Expr>> get_body_array() const noexcept { return body_expr.to_view(); }
-
-    /// @brief Pushes an expression to the end of the scope
-    /// @param expr The expression to push
-    void push_back(PTR<Expr> expr) noexcept { body_expr.push_back(expr); }
+    ContiguousView<PTR<Expr>> get_body_array() const noexcept { return body_expr; }
 
     /// @brief Creates a ScopeExpr
     /// @param body The body of the ScopeExpr
@@ -934,15 +964,15 @@ namespace colt::lang
     //No default constructor
     ConditionExpr() = delete;
     /// @brief Destructor
-    ~ConditionExpr() noexcept override = default;
+    ~ConditionExpr() noexcept = default;
     /// @brief Constructs a condition expression
     /// @param type The type of the resulting expression
     /// @param if_cond The if condition
     /// @param if_stmt The statement to evaluate if the if condition is true
     /// @param else_stmt The else statement, which can be null
-    /// @param src_info The source code information
-    ConditionExpr(PTR<const Type> type, PTR<Expr> if_cond, PTR<Expr> if_stmt, PTR<Expr> else_stmt, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_CONDITION, type, src_info), if_cond(if_cond), if_stmt(if_stmt), else_stmt(else_stmt)
+    /// @param src_loc The location in the source code
+    ConditionExpr(PTR<const Type> type, PTR<Expr> if_cond, PTR<Expr> if_stmt, PTR<Expr> else_stmt, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_CONDITION, type, src_loc), if_cond(if_cond), if_stmt(if_stmt), else_stmt(else_stmt)
     {
       assert_true(if_cond->get_type()->is_builtin(), "Type of 'if_cond' should be BuiltInType");
     }
@@ -969,6 +999,148 @@ namespace colt::lang
     static PTR<Expr> CreateExpr(PTR<Expr> if_cond, PTR<Expr> if_stmt, PTR<Expr> else_stmt, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
   };
 
+  /// @brief Represents a switch over an integral value.
+  /// The values of the cases are literals, so that the switch can be
+  /// lowered to a jump table. There is no fallthrough between cases.
+  class SwitchExpr
+    final : public Expr
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr ExprID classof_v = EXPR_SWITCH;
+
+  private:
+    /// @brief The value to switch on
+    PTR<Expr> value;
+    /// @brief The values of the cases, with the index of their body in 'case_bodies'
+    ContiguousView<std::pair<PTR<const LiteralExpr>, u64>> case_values;
+    /// @brief The bodies of the cases (stored in the COLTContext)
+    ContiguousView<PTR<Expr>> case_bodies;
+    /// @brief The body of the 'default' case, can be null
+    PTR<Expr> default_body;
+
+  public:
+    //No default copy constructor 
+    SwitchExpr(const SwitchExpr&) = delete;
+    //No default constructor
+    SwitchExpr() = delete;
+    /// @brief Destructor
+    ~SwitchExpr() noexcept = default;
+    /// @brief Constructs a switch expression
+    /// @param type The type of the resulting expression
+    /// @param value The value to switch on
+    /// @param case_values The values of the cases, with the index of their body
+    /// @param case_bodies The bodies of the cases
+    /// @param default_body The body of the 'default' case, which can be null
+    /// @param src_loc The location in the source code
+    SwitchExpr(PTR<const Type> type, PTR<Expr> value, ContiguousView<std::pair<PTR<const LiteralExpr>, u64>> case_values, ContiguousView<PTR<Expr>> case_bodies, PTR<Expr> default_body, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_SWITCH, type, src_loc), value(value), case_values(case_values), case_bodies(case_bodies), default_body(default_body)
+    {
+      assert_true(value->get_type()->is_integral(), "Type of 'value' should be integral!");
+    }
+
+    /// @brief Get the value to switch on
+    /// @return The value to switch on
+    PTR<const Expr> get_value() const noexcept { return value; }
+
+    /// @brief Get the values of the cases, with the index of their body
+    /// @return View over the values of the cases
+    ContiguousView<std::pair<PTR<const LiteralExpr>, u64>> get_case_values() const noexcept { return case_values; }
+
+    /// @brief Get the bodies of the cases
+    /// @return View over the bodies of the cases
+    ContiguousView<PTR<Expr>> get_case_bodies() const noexcept { return case_bodies; }
+
+    /// @brief Get the body of the 'default' case
+    /// @return The body of the 'default' case or null
+    PTR<const Expr> get_default() const noexcept { return default_body; }
+
+    /// @brief Creates a SwitchExpr
+    /// @param value The value to switch on
+    /// @param case_values The values of the cases, with the index of their body
+    /// @param case_bodies The bodies of the cases
+    /// @param default_body The body of the 'default' case, which can be null
+    /// @param src_info The source code information
+    /// @param ctx The COLTContext to store the resulting expression
+    /// @return Pointer to the created expression
+    static PTR<Expr> CreateExpr(PTR<Expr> value, Vector<std::pair<PTR<const LiteralExpr>, u64>>&& case_values, Vector<PTR<Expr>>&& case_bodies, PTR<Expr> default_body, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+  };
+
+  /// @brief Represents a for loop over a range: 'for var i in range(begin, end)'.
+  /// The loop variable is not mutable, which means the trip count of the
+  /// loop is known before entering it.
+  class ForLoopExpr
+    final : public Expr
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr ExprID classof_v = EXPR_FOR_LOOP;
+
+  private:
+    /// @brief The name of the loop variable
+    StringView var_name;
+    /// @brief The type of the loop variable
+    PTR<const Type> var_type;
+    /// @brief The beginning of the range (included)
+    PTR<Expr> begin;
+    /// @brief The end of the range (excluded)
+    PTR<Expr> end;
+    /// @brief The for body
+    PTR<Expr> body;
+
+  public:
+    //No default copy constructor
+    ForLoopExpr(const ForLoopExpr&) = delete;
+    //No default constructor
+    ForLoopExpr() = delete;
+    /// @brief Destructor
+    ~ForLoopExpr() noexcept = default;
+    /// @brief Constructs a for loop expression
+    /// @param type The type of the resulting expression
+    /// @param var_name The name of the loop variable
+    /// @param var_type The type of the loop variable
+    /// @param begin The beginning of the range (included)
+    /// @param end The end of the range (excluded)
+    /// @param body The body of the loop
+    /// @param src_loc The location in the source code
+    ForLoopExpr(PTR<const Type> type, StringView var_name, PTR<const Type> var_type, PTR<Expr> begin, PTR<Expr> end, PTR<Expr> body, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_FOR_LOOP, type, src_loc), var_name(var_name), var_type(var_type), begin(begin), end(end), body(body)
+    {
+      assert_true(var_type->is_builtin(), "Type of loop variable should be BuiltInType");
+    }
+
+    /// @brief Returns the name of the loop variable
+    /// @return The name of the loop variable
+    StringView get_var_name() const noexcept { return var_name; }
+
+    /// @brief Returns the type of the loop variable
+    /// @return The built-in type of the loop variable
+    PTR<const BuiltInType> get_var_type() const noexcept { return as<PTR<const BuiltInType>>(var_type); }
+
+    /// @brief Get the beginning of the range
+    /// @return The first value of the loop variable
+    PTR<const Expr> get_begin() const noexcept { return begin; }
+
+    /// @brief Get the end of the range
+    /// @return The value (excluded) at which the loop stops
+    PTR<const Expr> get_end() const noexcept { return end; }
+
+    /// @brief Get the body of the loop
+    /// @return The body of the loop
+    PTR<const Expr> get_body() const noexcept { return body; }
+
+    /// @brief Constructs a for loop expression
+    /// @param var_name The name of the loop variable
+    /// @param var_type The type of the loop variable
+    /// @param begin The beginning of the range (included)
+    /// @param end The end of the range (excluded)
+    /// @param body The body of the loop
+    /// @param src_info The source code information
+    /// @param ctx The COLTContext to store the resulting expression
+    /// @return Pointer to the created expression
+    static PTR<Expr> CreateExpr(StringView var_name, PTR<const Type> var_type, PTR<Expr> begin, PTR<Expr> end, PTR<Expr> body, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+  };
+
   /// @brief Represents a while loop
   class WhileLoopExpr
     final : public Expr
@@ -989,14 +1161,14 @@ namespace colt::lang
     //No default constructor
     WhileLoopExpr() = delete;
     /// @brief Destructor
-    ~WhileLoopExpr() noexcept override = default;
+    ~WhileLoopExpr() noexcept = default;
     /// @brief Constructs a while loop expression
     /// @param type The type of the resulting expression
     /// @param condition The while condition
     /// @param body The body of the condition
-    /// @param src_info The source code information
-    WhileLoopExpr(PTR<const Type> type, PTR<Expr> condition, PTR<Expr> body, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_WHILE_LOOP, type, src_info), condition(condition), body(body)
+    /// @param src_loc The location in the source code
+    WhileLoopExpr(PTR<const Type> type, PTR<Expr> condition, PTR<Expr> body, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_WHILE_LOOP, type, src_loc), condition(condition), body(body)
     {
       assert_true(condition->get_type()->is_builtin(), "Type of 'condition' should be BuiltInType");
     }
@@ -1036,13 +1208,13 @@ namespace colt::lang
     //No default constructor
     BreakContinueExpr() = delete;
     /// @brief Destructor
-    ~BreakContinueExpr() noexcept override = default;
+    ~BreakContinueExpr() noexcept = default;
     /// @brief Constructs a while loop expression
     /// @param type The type of the resulting expression
     /// @param is_break_v True if break, false if continue
-    /// @param src_info The source code information
-    BreakContinueExpr(PTR<const Type> type, bool is_break_v, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_BREAK_CONTINUE, type, src_info), is_break_v(is_break_v) {}
+    /// @param src_loc The location in the source code
+    BreakContinueExpr(PTR<const Type> type, bool is_break_v, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_BREAK_CONTINUE, type, src_loc), is_break_v(is_break_v) {}
 
     /// @brief Returns true if the expression represents a break
     /// @return True if break (or !is_continue)
@@ -1072,12 +1244,12 @@ namespace colt::lang
     //No default constructor
     NoOpExpr() = delete;
     /// @brief Destructor
-    ~NoOpExpr() noexcept override = default;
+    ~NoOpExpr() noexcept = default;
     /// @brief Constructs a while loop expression
     /// @param type The type of the resulting expression
-    /// @param src_info The source code information
-    NoOpExpr(PTR<const Type> type, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_NOP, type, src_info) {}
+    /// @param src_loc The location in the source code
+    NoOpExpr(PTR<const Type> type, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_NOP, type, src_loc) {}
     
     static PTR<Expr> CreateExpr(const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
   };
@@ -1097,10 +1269,10 @@ namespace colt::lang
     //No default constructor
     PtrStoreExpr() = delete;
     /// @brief Destructor
-    ~PtrStoreExpr() noexcept override = default;
+    ~PtrStoreExpr() noexcept = default;
 
-    PtrStoreExpr(PTR<const PtrType> ptr_type, PTR<Expr> where, PTR<Expr> value, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_PTR_STORE, ptr_type->get_type_to(), src_info), to_where(where), to_write(value) {}
+    PtrStoreExpr(PTR<const PtrType> ptr_type, PTR<Expr> where, PTR<Expr> value, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_PTR_STORE, ptr_type->get_type_to(), src_loc), to_where(where), to_write(value) {}
 
     PTR<const PtrType> get_ptr_type() const noexcept { return as<PTR<const PtrType>>(to_where->get_type()); }
     
@@ -1124,10 +1296,10 @@ namespace colt::lang
     //No default constructor
     PtrLoadExpr() = delete;
     /// @brief Destructor
-    ~PtrLoadExpr() noexcept override = default;
+    ~PtrLoadExpr() noexcept = default;
 
-    PtrLoadExpr(PTR<const PtrType> ptr_type, PTR<Expr> from, const SourceCodeExprInfo& src_info) noexcept
-      : Expr(EXPR_PTR_LOAD, ptr_type->get_type_to(), src_info), from(from) {}
+    PtrLoadExpr(PTR<const PtrType> ptr_type, PTR<Expr> from, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_PTR_LOAD, ptr_type->get_type_to(), src_loc), from(from) {}
 
     PTR<const PtrType> get_ptr_type() const noexcept { return as<PTR<const PtrType>>(from->get_type()); }
     PTR<Expr> get_where() const noexcept { return from; }
@@ -1135,6 +1307,227 @@ namespace colt::lang
     static PTR<Expr> CreateExpr(PTR<Expr> where, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
   };
   
+  /// @brief Represents the address of an element of an array or a slice.
+  /// Reading or writing the element is done through PtrLoadExpr and PtrStoreExpr.
+  class IndexExpr
+    final : public Expr
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr ExprID classof_v = EXPR_INDEX;
+
+  private:
+    /// @brief The array or slice to index
+    PTR<Expr> where;
+    /// @brief The index of the element
+    PTR<Expr> index;
+    /// @brief True if the index should be checked at runtime
+    bool is_checked_v;
+
+  public:
+    //No default copy constructor 
+    IndexExpr(const IndexExpr&) = delete;
+    //No default constructor
+    IndexExpr() = delete;
+    /// @brief Destructor
+    ~IndexExpr() noexcept = default;
+    /// @brief Constructs an index expression
+    /// @param type The pointer to the element type
+    /// @param where The array or slice to index
+    /// @param index The index of the element
+    /// @param is_checked True if the index should be checked at runtime
+    /// @param src_loc The location in the source code
+    IndexExpr(PTR<const Type> type, PTR<Expr> where, PTR<Expr> index, bool is_checked, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_INDEX, type, src_loc), where(where), index(index), is_checked_v(is_checked)
+    {
+      assert_true(where->get_type()->is_array() || where->get_type()->is_slice(), "Expected an array or a slice!");
+    }
+
+    /// @brief Get the array or slice being indexed
+    /// @return The indexed expression
+    PTR<const Expr> get_where() const noexcept { return where; }
+    /// @brief Get the index of the element
+    /// @return The index
+    PTR<const Expr> get_index() const noexcept { return index; }
+    /// @brief Check if the index was not proven to be in bounds
+    /// @return True if a bounds check should be generated
+    bool is_checked() const noexcept { return is_checked_v; }
+
+    /// @brief Constructs an index expression
+    /// @param where The array or slice to index
+    /// @param index The index of the element
+    /// @param is_checked True if the index should be checked at runtime
+    /// @param src_info The source code information
+    /// @param ctx The COLTContext to store the resulting expression
+    /// @return Pointer to the created expression
+    static PTR<Expr> CreateExpr(PTR<Expr> where, PTR<Expr> index, bool is_checked, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+  };
+
+  /// @brief Represents the length of a slice
+  class SliceLenExpr
+    final : public Expr
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr ExprID classof_v = EXPR_SLICE_LEN;
+
+  private:
+    /// @brief The slice whose length to return
+    PTR<Expr> slice;
+
+  public:
+    //No default copy constructor 
+    SliceLenExpr(const SliceLenExpr&) = delete;
+    //No default constructor
+    SliceLenExpr() = delete;
+    /// @brief Destructor
+    ~SliceLenExpr() noexcept = default;
+    /// @brief Constructs a slice length expression
+    /// @param type The type of the resulting expression
+    /// @param slice The slice whose length to return
+    /// @param src_loc The location in the source code
+    SliceLenExpr(PTR<const Type> type, PTR<Expr> slice, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_SLICE_LEN, type, src_loc), slice(slice)
+    {
+      assert_true(slice->get_type()->is_slice(), "Expected a slice!");
+    }
+
+    /// @brief Get the slice whose length is returned
+    /// @return The slice
+    PTR<const Expr> get_slice() const noexcept { return slice; }
+
+    /// @brief Constructs a slice length expression
+    /// @param slice The slice whose length to return
+    /// @param src_info The source code information
+    /// @param ctx The COLTContext to store the resulting expression
+    /// @return Pointer to the created expression
+    static PTR<Expr> CreateExpr(PTR<Expr> slice, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+  };
+  
+  /// @brief Represents the conversion of an array to a slice over its elements
+  class ToSliceExpr
+    final : public Expr
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr ExprID classof_v = EXPR_TO_SLICE;
+
+  private:
+    /// @brief The array to convert
+    PTR<Expr> array;
+
+  public:
+    //No default copy constructor 
+    ToSliceExpr(const ToSliceExpr&) = delete;
+    //No default constructor
+    ToSliceExpr() = delete;
+    /// @brief Destructor
+    ~ToSliceExpr() noexcept = default;
+    /// @brief Constructs a conversion from an array to a slice
+    /// @param type The slice type
+    /// @param array The array to convert
+    /// @param src_loc The location in the source code
+    ToSliceExpr(PTR<const Type> type, PTR<Expr> array, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_TO_SLICE, type, src_loc), array(array)
+    {
+      assert_true(type->is_slice() && array->get_type()->is_array(), "Expected a conversion from array to slice!");
+    }
+
+    /// @brief Get the array to convert
+    /// @return The array
+    PTR<const Expr> get_array() const noexcept { return array; }
+
+    /// @brief Returns the count of elements of the array
+    /// @return The length of the resulting slice
+    u64 get_count() const noexcept { return as<PTR<const ArrayType>>(array->get_type())->get_count(); }
+
+    /// @brief Constructs a conversion from an array to a slice
+    /// @param type The slice type
+    /// @param array The array to convert
+    /// @param src_info The source code information
+    /// @param ctx The COLTContext to store the resulting expression
+    /// @return Pointer to the created expression
+    static PTR<Expr> CreateExpr(PTR<const Type> type, PTR<Expr> array, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+  };
+  
+  /// @brief Represents an operation on SIMD vectors that is not an operator
+  class VecIntrinsicExpr
+    final : public Expr
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr ExprID classof_v = EXPR_VEC_INTRINSIC;
+
+    /// @brief The operations on vectors
+    enum VecIntrinsicID
+      : u8
+    {
+      /// @brief Broadcasts a scalar to all the elements: 'x as vec<T, N>'
+      VEC_SPLAT,
+      /// @brief Converts an array to a vector: 'a as vec<T, N>'
+      VEC_FROM_ARRAY,
+      /// @brief Converts a vector to an array: 'v as [N]T'
+      VEC_TO_ARRAY,
+      /// @brief 'shuffle(a, b, i0, ..., iM)', where the indices are literals
+      VEC_SHUFFLE,
+      /// @brief 'reduce_add(v)'
+      VEC_REDUCE_ADD,
+      /// @brief 'reduce_mul(v)'
+      VEC_REDUCE_MUL,
+      /// @brief 'reduce_min(v)'
+      VEC_REDUCE_MIN,
+      /// @brief 'reduce_max(v)'
+      VEC_REDUCE_MAX,
+      /// @brief 'reduce_and(v)'
+      VEC_REDUCE_AND,
+      /// @brief 'reduce_or(v)'
+      VEC_REDUCE_OR,
+      /// @brief 'reduce_xor(v)'
+      VEC_REDUCE_XOR,
+      /// @brief 'load_masked(ptr, mask, passthru)'
+      VEC_LOAD_MASKED,
+      /// @brief 'store_masked(ptr, mask, value)'
+      VEC_STORE_MASKED
+    };
+
+  private:
+    /// @brief The arguments of the operation (stored in the COLTContext)
+    ContiguousView<PTR<Expr>> arguments;
+    /// @brief The operation
+    VecIntrinsicID intrinsic;
+
+  public:
+    //No default copy constructor 
+    VecIntrinsicExpr(const VecIntrinsicExpr&) = delete;
+    //No default constructor
+    VecIntrinsicExpr() = delete;
+    /// @brief Destructor
+    ~VecIntrinsicExpr() noexcept = default;
+    /// @brief Constructs an operation on vectors
+    /// @param type The type of the result
+    /// @param intrinsic The operation
+    /// @param arguments The arguments of the operation
+    /// @param src_loc The location in the source code
+    VecIntrinsicExpr(PTR<const Type> type, VecIntrinsicID intrinsic, ContiguousView<PTR<Expr>> arguments, SourceCodeLocation src_loc) noexcept
+      : Expr(EXPR_VEC_INTRINSIC, type, src_loc), arguments(arguments), intrinsic(intrinsic) {}
+
+    /// @brief Returns the operation
+    /// @return The operation
+    VecIntrinsicID get_intrinsic() const noexcept { return intrinsic; }
+    /// @brief Returns the arguments of the operation
+    /// @return View over the arguments
+    ContiguousView<PTR<Expr>> get_arguments() const noexcept { return arguments; }
+
+    /// @brief Constructs an operation on vectors
+    /// @param type The type of the result
+    /// @param intrinsic The operation
+    /// @param arguments The arguments of the operation
+    /// @param src_info The source code information
+    /// @param ctx The COLTContext to store the resulting expression
+    /// @return Pointer to the created expression
+    static PTR<Expr> CreateExpr(PTR<const Type> type, VecIntrinsicID intrinsic, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+  };
+  
   template<typename T, typename>
   PTR<Expr> LiteralExpr::CreateValue(T value, COLTContext& ctx) noexcept
   {
@@ -0,0 +1,287 @@
+/** @file colt_module.cpp
+* Contains definition of functions declared in 'colt_module.h'.
+*/
+
+#include "colt_module.h"
+#include "colt_serialize.h"
+
+namespace colt::lang
+{
+  /// @brief The function generating the object file of a module
+  static ModuleCodeGenFn module_codegen_fn = nullptr;
+
+  /// @brief The modules being compiled by the current thread, to detect circular imports
+  static thread_local Vector<String> modules_in_progress = {};
+
+  /// @brief Returns the symbol of the name of a global declaration
+  /// @param expr The FnDefExpr or VarDeclExpr
+  /// @return The symbol of the function or variable
+  static SymbolID GetGlobalSymbol(PTR<const Expr> expr) noexcept
+  {
+    if (auto fn = dyn_cast<PTR<const FnDefExpr>>(expr))
+      return InternSymbol(fn->get_name());
+    return as<PTR<const VarDeclExpr>>(expr)->get_symbol();
+  }
+
+  /// @brief Adds a global declaration to a global table
+  /// @param global_map The global table
+  /// @param expr The FnDefExpr or VarDeclExpr to add
+  static void AddToGlobalMap(Map<SymbolID, SmallVector<PTR<Expr>>>& global_map, PTR<Expr> expr) noexcept
+  {
+    SymbolID symbol = GetGlobalSymbol(expr);
+    if (auto ptr = global_map.find(symbol); ptr != nullptr)
+    {
+      ptr->second.push_back(expr);
+      return;
+    }
+    SmallVector<PTR<Expr>> to_push;
+    to_push.push_back(expr);
+    global_map.insert(symbol, to_push);
+  }
+
+  /// @brief Adds the hash of the source of a module, if not already present
+  /// @param name The name of the module
+  /// @param hash The hash of its source
+  /// @param ast The AST to which to add the hash
+  static void AddModuleHash(StringView name, u64 hash, AST& ast) noexcept
+  {
+    for (size_t i = 0; i < ast.module_hashes.get_size(); i++)
+      if (StringView{ ast.module_hashes[i].first } == name)
+        return;
+    String module_name;
+    module_name += name;
+    ast.module_hashes.push_back({ std::move(module_name), hash });
+  }
+
+  /// @brief Hashes the source of a module (FNV-1a)
+  /// @param source The source of the module
+  /// @return The hash of the source
+  static u64 HashSource(StringView source) noexcept
+  {
+    u64 hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < source.get_size(); i++)
+    {
+      hash ^= as<u8>(source.get_data()[i]);
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  /// @brief Returns the path of a file of a module in the import directory
+  /// @param name The name of the module
+  /// @param extension The extension of the file
+  /// @return The path of the file
+  static std::string GetModulePath(StringView name, const char* extension) noexcept
+  {
+    return (std::filesystem::path(args::ImportDir) / std::string(name.get_data(), name.get_size()))
+      .replace_extension(extension).string();
+  }
+
+  /// @brief Returns a unique path of a temporary file next to a file,
+  /// to which to write before renaming it to the file
+  /// @param path The path of the file
+  /// @return The path of the temporary file
+  static std::string GetTemporaryPath(const std::string& path) noexcept
+  {
+    return fmt::format("{}.{:016x}.tmp", path, colt::rand(0, std::numeric_limits<u64>::max()));
+  }
+
+  /// @brief Renames a temporary file to its final path, or removes it on failure
+  /// @param temporary The path of the temporary file
+  /// @param path The final path of the file
+  /// @return True on success
+  static bool RenameTemporary(const std::string& temporary, const std::string& path) noexcept
+  {
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec)
+      std::filesystem::remove(temporary, ec);
+    return !ec;
+  }
+
+  /// @brief Checks if an interface is up to date: the sources of the module and
+  /// of all the modules it imports (directly or not) must not have changed.
+  /// @param interface_path The path of the interface
+  /// @return True if the interface can be used
+  static bool IsUpToDate(const std::string& interface_path) noexcept
+  {
+    COLTContext ctx;
+    AST interface = { ctx };
+    if (DeserializeAST(interface_path.c_str(), interface).is_error())
+      return false;
+    for (size_t i = 0; i < interface.module_hashes.get_size(); i++)
+    {
+      auto source = GetModulePath(interface.module_hashes[i].first, ".ct");
+      //Modules distributed without their sources cannot be outdated
+      std::error_code ec;
+      if (!std::filesystem::exists(source, ec))
+        continue;
+      auto content = String::getFileContent(source.c_str());
+      if (content.is_error() || HashSource(content.get_value()) != interface.module_hashes[i].second)
+        return false;
+    }
+    return true;
+  }
+
+  /// @brief Compiles a module, writing its object file and its interface
+  /// @param name The name of the module
+  /// @param source The path of the source of the module
+  /// @param interface_path The path of the interface to write
+  /// @param object_path The path of the object file to write
+  /// @return Error message or true
+  static Expected<bool, const char*> CompileModule(StringView name, const std::string& source, const std::string& interface_path, const std::string& object_path) noexcept
+  {
+    auto content = String::getFileContent(source.c_str());
+    if (content.is_error())
+      return { Error, "Could not read the module!" };
+
+    COLTContext ctx;
+    auto module = CreateAST(content.get_value(), ctx);
+    if (module.is_error())
+      return { Error, "The module contains errors!" };
+
+    //Modules do not have a 'main' in which to initialize their globals
+    bool has_dynamic_init = false;
+    {
+      ReportSink sink;
+      for (auto expr : module->expressions)
+      {
+        auto var = dyn_cast<PTR<const VarDeclExpr>>(expr);
+        if (var == nullptr || !var->is_global() || !var->is_initialized() || is_a<LiteralExpr>(var->get_value()))
+          continue;
+        GenerateError(ctx.to_src_info(var->get_src_loc()), "Global variable '{}' of a module must be initialized with a constant!", var->get_name());
+        has_dynamic_init = true;
+      }
+    }
+    if (has_dynamic_init)
+      return { Error, "The module contains errors!" };
+
+    //The object file is written first, as importers check if the interface is up to date
+    std::error_code ec;
+    auto object_temporary = GetTemporaryPath(object_path);
+    if (module_codegen_fn != nullptr)
+    {
+      if (!module_codegen_fn(module.get_value(), source.c_str(), object_temporary.c_str()))
+      {
+        std::filesystem::remove(object_temporary, ec);
+        return { Error, "Could not generate the object file of the module!" };
+      }
+      if (!RenameTemporary(object_temporary, object_path))
+        return { Error, "Could not write the object file of the module!" };
+    }
+
+    AST interface = { ctx };
+    CreateInterface(module.get_value(), interface);
+    AddModuleHash(name, HashSource(content.get_value()), interface);
+    auto interface_temporary = GetTemporaryPath(interface_path);
+    if (auto result = SerializeAST(interface, interface_temporary.c_str()); result.is_error())
+    {
+      std::filesystem::remove(interface_temporary, ec);
+      return result;
+    }
+    if (!RenameTemporary(interface_temporary, interface_path))
+      return { Error, "Could not write the interface of the module!" };
+    return true;
+  }
+
+  void RegisterModuleCodeGenFn(ModuleCodeGenFn fn) noexcept
+  {
+    module_codegen_fn = fn;
+  }
+
+  void CreateInterface(const AST& module, AST& interface) noexcept
+  {
+    for (auto expr : module.expressions)
+    {
+      if (auto fn = dyn_cast<PTR<const FnDefExpr>>(expr))
+      {
+        if (fn->is_extern() || !fn->has_body() || fn->is_main())
+          continue;
+        //The declaration is copied as the one of the module is not mutable
+        auto decl = fn->get_fn_decl();
+        SmallVector<StringView, 4> params_name;
+        for (auto name : decl->get_params_name())
+          params_name.push_back(name);
+        auto copy = FnDeclExpr::CreateExpr(decl->get_type(), decl->get_name(), std::move(params_name),
+          false, module.ctx.to_src_info(decl->get_src_loc()), interface.ctx);
+        auto def = FnDefExpr::CreateExpr(as<PTR<FnDeclExpr>>(copy), module.ctx.to_src_info(fn->get_src_loc()), interface.ctx);
+        interface.expressions.push_back(def);
+        AddToGlobalMap(interface.global_map, def);
+      }
+      else if (auto var = dyn_cast<PTR<const VarDeclExpr>>(expr); var && var->is_global())
+      {
+        //A global without initial value is an external declaration
+        auto decl = VarDeclExpr::CreateExpr(var->get_type(), var->get_symbol(), nullptr,
+          true, module.ctx.to_src_info(var->get_src_loc()), interface.ctx);
+        interface.expressions.push_back(decl);
+        AddToGlobalMap(interface.global_map, decl);
+      }
+    }
+    //Importers must also link the modules imported by the module
+    for (size_t i = 0; i < module.module_objects.get_size(); i++)
+      AddModuleObject(module.module_objects[i], interface);
+    //The interface is outdated if any of these modules is modified
+    for (size_t i = 0; i < module.module_hashes.get_size(); i++)
+      AddModuleHash(module.module_hashes[i].first, module.module_hashes[i].second, interface);
+  }
+
+  Expected<bool, const char*> ImportModule(StringView name, AST& ast) noexcept
+  {
+    for (size_t i = 0; i < ast.imported_modules.get_size(); i++)
+      if (StringView{ ast.imported_modules[i] } == name)
+        return true;
+    for (size_t i = 0; i < modules_in_progress.get_size(); i++)
+      if (StringView{ modules_in_progress[i] } == name)
+        return { Error, "Circular import!" };
+
+    namespace fs = std::filesystem;
+    auto source = GetModulePath(name, ".ct");
+    auto interface_path = GetModulePath(name, ".cast");
+    auto object_path = GetModulePath(name, ".o");
+
+    std::error_code ec;
+    bool has_source = fs::exists(source, ec);
+    bool is_outdated = !fs::exists(interface_path, ec)
+      || (module_codegen_fn != nullptr && !fs::exists(object_path, ec))
+      || !IsUpToDate(interface_path);
+    if (is_outdated)
+    {
+      if (!has_source)
+        return { Error, "Module file not found!" };
+
+      String module_name;
+      module_name += name;
+      modules_in_progress.push_back(std::move(module_name));
+      auto result = CompileModule(name, source, interface_path, object_path);
+      modules_in_progress.pop_back();
+      if (result.is_error())
+        return result;
+    }
+
+    //The content of the interface is owned by the context of 'ast'
+    AST interface = { ast.ctx };
+    if (auto result = DeserializeAST(interface_path.c_str(), interface); result.is_error())
+      return result;
+
+    //Check for conflicts before modifying 'ast'
+    for (auto expr : interface.expressions)
+      if (ast.global_map.find(GetGlobalSymbol(expr)) != nullptr)
+        return { Error, "The module redefines an existing function or global variable!" };
+    for (auto expr : interface.expressions)
+    {
+      ast.imports.push_back(expr);
+      AddToGlobalMap(ast.global_map, expr);
+    }
+
+    String module_name;
+    module_name += name;
+    ast.imported_modules.push_back(std::move(module_name));
+    if (module_codegen_fn != nullptr)
+      AddModuleObject(StringView{ object_path.data(), object_path.data() + object_path.size() }, ast);
+    for (size_t i = 0; i < interface.module_objects.get_size(); i++)
+      AddModuleObject(interface.module_objects[i], ast);
+    for (size_t i = 0; i < interface.module_hashes.get_size(); i++)
+      AddModuleHash(interface.module_hashes[i].first, interface.module_hashes[i].second, ast);
+    return true;
+  }
+}
@@ -0,0 +1,51 @@
+/** @file colt_module.h
+* Contains the import of modules.
+* A module 'name' is the file '<name>.ct' of the import directory.
+* The first time it is imported (or when its source is modified), a module
+* is compiled to an object file '<name>.o' and to an interface '<name>.cast',
+* which is the serialized AST of the declarations of its functions and global variables.
+* Importers only load the interface: the module is not parsed again.
+* Both files are written to temporary files then renamed, so that other
+* compilers importing the module never read partially written files.
+* The interface stores the hashes of the sources of the module and of the modules
+* it imports (directly or not): modifying any of them recompiles the module.
+* As modules have no 'main', their global variables must be initialized with constants.
+*/
+
+#ifndef HG_COLT_MODULE
+#define HG_COLT_MODULE
+
+#include <util/colt_pch.h>
+#include <ast/colt_ast.h>
+
+namespace colt::lang
+{
+  /// @brief Function generating the object file of a module.
+  /// The object file is shared by all the importers of the module: it must
+  /// not depend on the options specific to the file being compiled (output kind, profile...).
+  /// The arguments are the AST of the module, the path of its source and the object file to write.
+  using ModuleCodeGenFn = bool(*)(const AST& module, const char* source_path, const char* object_path) noexcept;
+
+  /// @brief Registers the function to call to generate the object file of a module.
+  /// If no function is registered, only the interface of modules is produced.
+  /// @param fn The function to call
+  void RegisterModuleCodeGenFn(ModuleCodeGenFn fn) noexcept;
+
+  /// @brief Creates the interface of a module: the declarations (without bodies)
+  /// of the functions it defines, and of its global variables.
+  /// 'main', 'extern' functions and imported declarations are not part of the interface.
+  /// @param module The AST of the module
+  /// @param interface The AST to fill, whose context should outlive 'module'
+  void CreateInterface(const AST& module, AST& interface) noexcept;
+
+  /// @brief Imports a module, compiling it if its interface is missing or outdated.
+  /// The declarations of the module are added to the imports and global table of 'ast',
+  /// and its object file (and the ones of the modules it imports) to the objects to link.
+  /// Importing a module multiple times does nothing.
+  /// @param name The name of the module
+  /// @param ast The AST in which to add the declarations
+  /// @return Error message or true
+  Expected<bool, const char*> ImportModule(StringView name, AST& ast) noexcept;
+}
+
+#endif //!HG_COLT_MODULE
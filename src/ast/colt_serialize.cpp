@@ -0,0 +1,1345 @@
+/** @file colt_serialize.cpp
+* Contains definition of functions declared in 'colt_serialize.h'.
+*/
+
+#include "colt_serialize.h"
+
+namespace colt::lang
+{
+  /// @brief "COLTAST\0" in little-endian
+  static constexpr u64 COLT_SERIALIZE_MAGIC = 0x0054534154'4C4F43;
+  /// @brief Index representing a null expression
+  static constexpr u64 COLT_SERIALIZE_NONE = std::numeric_limits<u64>::max();
+
+  /// @brief Writes the types and expressions of an AST to buffers
+  class ASTWriter
+  {
+    /// @brief The records of the types
+    Vector<u64> types = {};
+    /// @brief The records of the expressions
+    Vector<u64> exprs = {};
+    /// @brief The records of the global table
+    Vector<u64> globals = {};
+    /// @brief The indices of the root expressions
+    Vector<u64> roots = {};
+    /// @brief The indices of the imported declarations
+    Vector<u64> imports = {};
+    /// @brief The paths of the object files of the imported modules
+    Vector<u64> objects = {};
+    /// @brief The names and hashes of the sources of the imported modules
+    Vector<u64> hashes = {};
+    /// @brief Maps a type to its index
+    Map<PTR<const Type>, u64> type_index = {};
+    /// @brief Maps an expression to its index
+    Map<PTR<const Expr>, u64> expr_index = {};
+    /// @brief The names already written in the global table
+    Map<StringView, u64> global_index = {};
+    /// @brief The count of types written
+    u64 type_count = 0;
+    /// @brief The count of expressions written
+    u64 expr_count = 0;
+    /// @brief The count of names written in the global table
+    u64 global_count = 0;
+    /// @brief The count of paths of object files written
+    u64 object_count = 0;
+    /// @brief The count of hashes of modules written
+    u64 hash_count = 0;
+
+  public:
+    /// @brief Writes all the expressions of an AST
+    /// @param ast The AST to write
+    ASTWriter(const AST& ast) noexcept;
+
+    /// @brief Concatenates the header and the records
+    /// @return The serialized AST
+    Vector<u64> get_result() const noexcept;
+
+  private:
+    /// @brief Writes a type (and the types it depends on)
+    /// @param type The type to write
+    /// @return The index of the type
+    u64 write_type(PTR<const Type> type) noexcept;
+
+    /// @brief Writes an expression (and the expressions it depends on)
+    /// @param expr The expression to write (or nullptr)
+    /// @return The index of the expression, or COLT_SERIALIZE_NONE for nullptr
+    u64 write_expr(PTR<const Expr> expr) noexcept;
+
+    /// @brief Writes the header of an expression record
+    /// @param expr The expression whose header to write
+    /// @param type The index of the type of the expression
+    void write_expr_header(PTR<const Expr> expr, u64 type) noexcept;
+
+    /// @brief Writes the size of a string followed by its characters, padded to 8 bytes
+    /// @param to The buffer to which to write
+    /// @param str The string to write
+    static void write_str(Vector<u64>& to, StringView str) noexcept;
+
+    /// @brief Appends a buffer to another one
+    /// @param to The buffer to which to append
+    /// @param from The buffer to append
+    static void append(Vector<u64>& to, const Vector<u64>& from) noexcept;
+  };
+
+  /// @brief Reads the types and expressions of a serialized AST
+  class ASTReader
+  {
+    /// @brief The current word to read
+    const u64* current;
+    /// @brief The end of the buffer
+    const u64* end;
+    /// @brief The AST whose String table to use
+    AST& ast;
+    /// @brief The context in which to store the types and expressions
+    COLTContext& ctx;
+    /// @brief The types read
+    Vector<PTR<const Type>> types = {};
+    /// @brief The expressions read
+    Vector<PTR<Expr>> exprs = {};
+    /// @brief The types of the live local variables, while checking a function
+    Vector<PTR<const Type>> local_types = {};
+    /// @brief The hash of the types of the first 'i + 1' live local variables, at 'i'
+    Vector<u64> local_hashes = {};
+    /// @brief The count of live local variables with which each expression was checked,
+    /// and the hash of their types
+    Map<PTR<const Expr>, std::pair<u64, u64>> checked_locals = {};
+
+  public:
+    /// @brief Constructs a reader over a buffer
+    /// @param buffer The buffer to read
+    /// @param size The count of words in 'buffer'
+    /// @param ast The AST to which to add the expressions and globals
+    ASTReader(const u64* buffer, size_t size, AST& ast) noexcept
+      : current(buffer), end(buffer + size), ast(ast), ctx(ast.ctx) {}
+
+    /// @brief Reads the whole buffer, adding its content to the AST
+    /// @return Error message or true
+    Expected<bool, const char*> read_ast() noexcept;
+
+  private:
+    /// @brief Reads a type record
+    /// @return True on success
+    bool read_type_record() noexcept;
+
+    /// @brief Reads an expression record.
+    /// The types of the expression and of its children must be consistent
+    /// (operands, arguments and written values), as the generator expects them to be.
+    /// @return True on success
+    bool read_expr_record() noexcept;
+
+    /// @brief Checks that the local IDs used by an expression are the ones
+    /// of local variables declared before it (parameters included), and that
+    /// the type of each local variable read or written is the declared one.
+    /// As the IDs index the local variables of the generator, this must
+    /// be checked from the root expressions, which know the scopes.
+    /// @param expr The expression to check (or nullptr)
+    /// @return True if the local IDs are valid
+    bool check_locals(PTR<const Expr> expr) noexcept;
+
+    /// @brief Declares a local variable, for check_locals
+    /// @param type The type of the local variable
+    void push_local(PTR<const Type> type) noexcept;
+
+    /// @brief Removes the last local variables declared, for check_locals
+    /// @param count The count of local variables to remove
+    void pop_locals(u64 count) noexcept;
+
+    /// @brief Returns the hash of the types of the first 'count' live local variables
+    /// @param count The count of local variables
+    /// @return The hash (0 if 'count' is 0)
+    u64 get_locals_hash(u64 count) const noexcept { return count == 0 ? 0 : local_hashes[count - 1]; }
+
+    /// @brief Reads a word
+    /// @param out Where to write the result
+    /// @return True on success
+    bool read(u64& out) noexcept;
+
+    /// @brief Reads a string, whose content stays in the buffer
+    /// @param out Where to write the result
+    /// @return True on success
+    bool read_str(StringView& out) noexcept;
+
+    /// @brief Reads the index of an already read type
+    /// @param out Where to write the result
+    /// @return True on success
+    bool read_type(PTR<const Type>& out) noexcept;
+
+    /// @brief Reads the index of an already read expression
+    /// @param out Where to write the result
+    /// @param nullable If true, COLT_SERIALIZE_NONE is read as nullptr
+    /// @return True on success
+    bool read_expr(PTR<Expr>& out, bool nullable = false) noexcept;
+
+    /// @brief Reads the index of an already read expression of a specific kind
+    /// @param out Where to write the result
+    /// @param ID The ExprID of the expression
+    /// @return True on success
+    bool read_expr(PTR<Expr>& out, Expr::ExprID ID) noexcept;
+  };
+
+  /************************************
+  * ASTWriter
+  ************************************/
+
+  ASTWriter::ASTWriter(const AST& ast) noexcept
+  {
+    for (auto expr : ast.expressions)
+      roots.push_back(write_expr(expr));
+    for (auto expr : ast.imports)
+      imports.push_back(write_expr(expr));
+    for (size_t i = 0; i < ast.module_objects.get_size(); i++)
+    {
+      write_str(objects, ast.module_objects[i]);
+      object_count++;
+    }
+    for (size_t i = 0; i < ast.module_hashes.get_size(); i++)
+    {
+      write_str(hashes, ast.module_hashes[i].first);
+      hashes.push_back(ast.module_hashes[i].second);
+      hash_count++;
+    }
+
+    //The global table is rebuilt from the globals, in the order of declaration
+    for (auto expr : ast.expressions)
+    {
+      StringView name;
+      if (auto fn = dyn_cast<PTR<const FnDefExpr>>(expr))
+        name = fn->get_name();
+      else if (auto var = dyn_cast<PTR<const VarDeclExpr>>(expr); var && var->is_global())
+        name = var->get_name();
+      else
+        continue;
+
+      if (global_index.find(name) != nullptr)
+        continue;
+      auto ptr = ast.global_map.find(InternSymbol(name));
+      if (ptr == nullptr)
+        continue;
+      global_index.insert(name, global_count++);
+
+      write_str(globals, name);
+      auto overloads = ptr->second.to_view();
+      globals.push_back(overloads.get_size());
+      for (auto overload : overloads)
+        globals.push_back(write_expr(overload));
+    }
+  }
+
+  Vector<u64> ASTWriter::get_result() const noexcept
+  {
+    Vector<u64> result;
+    result.push_back(COLT_SERIALIZE_MAGIC);
+    result.push_back(COLT_SERIALIZE_VERSION);
+    result.push_back(type_count);
+    result.push_back(expr_count);
+    result.push_back(global_count);
+    result.push_back(roots.get_size());
+    result.push_back(imports.get_size());
+    result.push_back(object_count);
+    result.push_back(hash_count);
+    append(result, types);
+    append(result, exprs);
+    append(result, globals);
+    append(result, roots);
+    append(result, imports);
+    append(result, objects);
+    append(result, hashes);
+    return result;
+  }
+
+  u64 ASTWriter::write_type(PTR<const Type> type) noexcept
+  {
+    if (auto ptr = type_index.find(type); ptr != nullptr)
+      return ptr->second;
+
+    switch (type->classof())
+    {
+    break; case Type::TYPE_VOID:
+      types.push_back(Type::TYPE_VOID);
+      types.push_back(type->is_const());
+    break; case Type::TYPE_BUILTIN:
+      types.push_back(Type::TYPE_BUILTIN);
+      types.push_back(type->is_const());
+      types.push_back(as<PTR<const BuiltInType>>(type)->get_builtin_id());
+    break; case Type::TYPE_PTR:
+    {
+      u64 ptr_to = write_type(as<PTR<const PtrType>>(type)->get_type_to());
+      types.push_back(Type::TYPE_PTR);
+      types.push_back(type->is_const());
+      types.push_back(ptr_to);
+    }
+    break; case Type::TYPE_ARRAY:
+    {
+      auto arr = as<PTR<const ArrayType>>(type);
+      u64 array_of = write_type(arr->get_type_of());
+      types.push_back(Type::TYPE_ARRAY);
+      types.push_back(type->is_const());
+      types.push_back(array_of);
+      types.push_back(arr->get_count());
+    }
+    break; case Type::TYPE_SLICE:
+    {
+      u64 slice_of = write_type(as<PTR<const SliceType>>(type)->get_type_of());
+      types.push_back(Type::TYPE_SLICE);
+      types.push_back(type->is_const());
+      types.push_back(slice_of);
+    }
+    break; case Type::TYPE_VEC:
+    {
+      auto vec = as<PTR<const VecType>>(type);
+      u64 vec_of = write_type(vec->get_type_of());
+      types.push_back(Type::TYPE_VEC);
+      types.push_back(type->is_const());
+      types.push_back(vec_of);
+      types.push_back(vec->get_count());
+    }
+    break; case Type::TYPE_FN:
+    {
+      auto fn = as<PTR<const FnType>>(type);
+      u64 return_type = write_type(fn->get_return_type());
+      SmallVector<u64, 4> params;
+      for (auto param : fn->get_params_type())
+        params.push_back(write_type(param));
+      types.push_back(Type::TYPE_FN);
+      types.push_back(type->is_const());
+      types.push_back(return_type);
+      types.push_back(fn->is_varargs());
+      types.push_back(params.get_size());
+      for (auto param : params.to_view())
+        types.push_back(param);
+    }
+    break; case Type::TYPE_ERROR:
+    case Type::TYPE_CLASS:
+    default:
+      colt_unreachable("Invalid type to serialize!");
+    }
+    type_index.insert(type, type_count);
+    return type_count++;
+  }
+
+  void ASTWriter::write_expr_header(PTR<const Expr> expr, u64 type) noexcept
+  {
+    exprs.push_back(expr->classof());
+    exprs.push_back(type);
+    exprs.push_back(as<u64>(expr->get_src_loc().line_begin)
+      | (as<u64>(expr->get_src_loc().line_end) << 32));
+  }
+
+  u64 ASTWriter::write_expr(PTR<const Expr> expr) noexcept
+  {
+    if (expr == nullptr)
+      return COLT_SERIALIZE_NONE;
+    if (auto ptr = expr_index.find(expr); ptr != nullptr)
+      return ptr->second;
+
+    u64 type = write_type(expr->get_type());
+    switch (expr->classof())
+    {
+    break; case Expr::EXPR_LITERAL:
+    {
+      write_expr_header(expr, type);
+      auto value = as<PTR<const LiteralExpr>>(expr)->get_value();
+      //String literals are pointers to the String table of the AST
+      exprs.push_back(expr->get_type()->is_lstring());
+      if (expr->get_type()->is_lstring())
+        write_str(exprs, *value.as<PTR<const String>>());
+      else
+        exprs.push_back(value.as<u64>());
+    }
+    break; case Expr::EXPR_UNARY:
+    {
+      auto ptr = as<PTR<const UnaryExpr>>(expr);
+      u64 child = write_expr(ptr->get_child());
+      write_expr_header(expr, type);
+      exprs.push_back(ptr->get_operation());
+      exprs.push_back(child);
+    }
+    break; case Expr::EXPR_BINARY:
+    {
+      auto ptr = as<PTR<const BinaryExpr>>(expr);
+      u64 lhs = write_expr(ptr->get_LHS());
+      u64 rhs = write_expr(ptr->get_RHS());
+      write_expr_header(expr, type);
+      exprs.push_back(lhs);
+      exprs.push_back(ptr->get_operation());
+      exprs.push_back(rhs);
+    }
+    break; case Expr::EXPR_CONVERT:
+    {
+      auto ptr = as<PTR<const ConvertExpr>>(expr);
+      u64 child = write_expr(ptr->get_child());
+      write_expr_header(expr, type);
+      exprs.push_back(child);
+      exprs.push_back(ptr->get_conversion_type());
+    }
+    break; case Expr::EXPR_VAR_DECL:
+    {
+      auto ptr = as<PTR<const VarDeclExpr>>(expr);
+      u64 init = write_expr(ptr->get_value());
+      write_expr_header(expr, type);
+      exprs.push_back(init);
+      exprs.push_back(ptr->is_global());
+      write_str(exprs, ptr->get_name());
+    }
+    break; case Expr::EXPR_VAR_READ:
+    {
+      auto ptr = as<PTR<const VarReadExpr>>(expr);
+      write_expr_header(expr, type);
+      exprs.push_back(ptr->unsafe_get_local_id());
+      write_str(exprs, ptr->get_name());
+    }
+    break; case Expr::EXPR_VAR_WRITE:
+    {
+      auto ptr = as<PTR<const VarWriteExpr>>(expr);
+      u64 value = write_expr(ptr->get_value());
+      write_expr_header(expr, type);
+      exprs.push_back(value);
+      exprs.push_back(ptr->unsafe_get_local_id());
+      write_str(exprs, ptr->get_name());
+    }
+    break; case Expr::EXPR_FN_DECL:
+    {
+      auto ptr = as<PTR<const FnDeclExpr>>(expr);
+      write_expr_header(expr, type);
+      exprs.push_back(ptr->is_extern());
+      write_str(exprs, ptr->get_name());
+      exprs.push_back(ptr->get_params_count());
+      for (auto name : ptr->get_params_name())
+        write_str(exprs, name);
+    }
+    break; case Expr::EXPR_FN_DEF:
+    {
+      auto ptr = as<PTR<const FnDefExpr>>(expr);
+      u64 decl = write_expr(ptr->get_fn_decl());
+      u64 body = write_expr(ptr->get_body());
+      write_expr_header(expr, type);
+      exprs.push_back(decl);
+      exprs.push_back(body);
+    }
+    break; case Expr::EXPR_FN_CALL:
+    {
+      auto ptr = as<PTR<const FnCallExpr>>(expr);
+      u64 decl = write_expr(ptr->get_fn_decl());
+      SmallVector<u64, 4> args;
+      for (auto arg : ptr->get_arguments())
+        args.push_back(write_expr(arg));
+      write_expr_header(expr, type);
+      exprs.push_back(decl);
+      exprs.push_back(args.get_size());
+      for (auto arg : args.to_view())
+        exprs.push_back(arg);
+    }
+    break; case Expr::EXPR_FN_RETURN:
+    {
+      u64 value = write_expr(as<PTR<const FnReturnExpr>>(expr)->get_value());
+      write_expr_header(expr, type);
+      exprs.push_back(value);
+    }
+    break; case Expr::EXPR_SCOPE:
+    {
+      Vector<u64> body;
+      for (auto stmt : as<PTR<const ScopeExpr>>(expr)->get_body_array())
+        body.push_back(write_expr(stmt));
+      write_expr_header(expr, type);
+      exprs.push_back(body.get_size());
+      append(exprs, body);
+    }
+    break; case Expr::EXPR_CONDITION:
+    {
+      auto ptr = as<PTR<const ConditionExpr>>(expr);
+      u64 if_cond = write_expr(ptr->get_if_condition());
+      u64 if_stmt = write_expr(ptr->get_if_statement());
+      u64 else_stmt = write_expr(ptr->get_else_statement());
+      write_expr_header(expr, type);
+      exprs.push_back(if_cond);
+      exprs.push_back(if_stmt);
+      exprs.push_back(else_stmt);
+    }
+    break; case Expr::EXPR_SWITCH:
+    {
+      auto ptr = as<PTR<const SwitchExpr>>(expr);
+      u64 value = write_expr(ptr->get_value());
+      u64 default_body = write_expr(ptr->get_default());
+      Vector<u64> cases;
+      for (auto& [literal, body] : ptr->get_case_values())
+      {
+        cases.push_back(write_expr(literal));
+        cases.push_back(body);
+      }
+      Vector<u64> bodies;
+      for (auto body : ptr->get_case_bodies())
+        bodies.push_back(write_expr(body));
+      write_expr_header(expr, type);
+      exprs.push_back(value);
+      exprs.push_back(default_body);
+      exprs.push_back(ptr->get_case_values().get_size());
+      append(exprs, cases);
+      exprs.push_back(bodies.get_size());
+      append(exprs, bodies);
+    }
+    break; case Expr::EXPR_FOR_LOOP:
+    {
+      auto ptr = as<PTR<const ForLoopExpr>>(expr);
+      u64 var_type = write_type(ptr->get_var_type());
+      u64 begin = write_expr(ptr->get_begin());
+      u64 end = write_expr(ptr->get_end());
+      u64 body = write_expr(ptr->get_body());
+      write_expr_header(expr, type);
+      exprs.push_back(var_type);
+      exprs.push_back(begin);
+      exprs.push_back(end);
+      exprs.push_back(body);
+      write_str(exprs, ptr->get_var_name());
+    }
+    break; case Expr::EXPR_WHILE_LOOP:
+    {
+      auto ptr = as<PTR<const WhileLoopExpr>>(expr);
+      u64 condition = write_expr(ptr->get_condition());
+      u64 body = write_expr(ptr->get_body());
+      write_expr_header(expr, type);
+      exprs.push_back(condition);
+      exprs.push_back(body);
+    }
+    break; case Expr::EXPR_BREAK_CONTINUE:
+      write_expr_header(expr, type);
+      exprs.push_back(as<PTR<const BreakContinueExpr>>(expr)->is_break());
+    break; case Expr::EXPR_NOP:
+      write_expr_header(expr, type);
+    break; case Expr::EXPR_PTR_STORE:
+    {
+      auto ptr = as<PTR<const PtrStoreExpr>>(expr);
+      u64 where = write_expr(ptr->get_where());
+      u64 value = write_expr(ptr->get_value());
+      write_expr_header(expr, type);
+      exprs.push_back(where);
+      exprs.push_back(value);
+    }
+    break; case Expr::EXPR_PTR_LOAD:
+    {
+      u64 where = write_expr(as<PTR<const PtrLoadExpr>>(expr)->get_where());
+      write_expr_header(expr, type);
+      exprs.push_back(where);
+    }
+    break; case Expr::EXPR_INDEX:
+    {
+      auto ptr = as<PTR<const IndexExpr>>(expr);
+      u64 where = write_expr(ptr->get_where());
+      u64 index = write_expr(ptr->get_index());
+      write_expr_header(expr, type);
+      exprs.push_back(where);
+      exprs.push_back(index);
+      exprs.push_back(ptr->is_checked());
+    }
+    break; case Expr::EXPR_SLICE_LEN:
+    {
+      u64 slice = write_expr(as<PTR<const SliceLenExpr>>(expr)->get_slice());
+      write_expr_header(expr, type);
+      exprs.push_back(slice);
+    }
+    break; case Expr::EXPR_TO_SLICE:
+    {
+      u64 array = write_expr(as<PTR<const ToSliceExpr>>(expr)->get_array());
+      write_expr_header(expr, type);
+      exprs.push_back(array);
+    }
+    break; case Expr::EXPR_VEC_INTRINSIC:
+    {
+      auto ptr = as<PTR<const VecIntrinsicExpr>>(expr);
+      SmallVector<u64, 4> args;
+      for (auto arg : ptr->get_arguments())
+        args.push_back(write_expr(arg));
+      write_expr_header(expr, type);
+      exprs.push_back(ptr->get_intrinsic());
+      exprs.push_back(args.get_size());
+      for (auto arg : args.to_view())
+        exprs.push_back(arg);
+    }
+    break; case Expr::EXPR_ERROR:
+    default:
+      colt_unreachable("Invalid expression to serialize!");
+    }
+    expr_index.insert(expr, expr_count);
+    return expr_count++;
+  }
+
+  void ASTWriter::write_str(Vector<u64>& to, StringView str) noexcept
+  {
+    to.push_back(str.get_size());
+    for (size_t i = 0; i < str.get_size(); i += sizeof(u64))
+    {
+      u64 word = 0;
+      std::memcpy(&word, str.get_data() + i, std::min(sizeof(u64), str.get_size() - i));
+      to.push_back(word);
+    }
+  }
+
+  void ASTWriter::append(Vector<u64>& to, const Vector<u64>& from) noexcept
+  {
+    for (size_t i = 0; i < from.get_size(); i++)
+      to.push_back(from[i]);
+  }
+
+  /************************************
+  * ASTReader
+  ************************************/
+
+  bool ASTReader::read(u64& out) noexcept
+  {
+    if (current == end)
+      return false;
+    out = *current++;
+    return true;
+  }
+
+  bool ASTReader::read_str(StringView& out) noexcept
+  {
+    u64 size;
+    if (!read(size))
+      return false;
+    u64 words = size / sizeof(u64) + as<u64>(size % sizeof(u64) != 0);
+    if (as<u64>(end - current) < words)
+      return false;
+    auto begin = reinterpret_cast<const char*>(current);
+    out = StringView{ begin, begin + size };
+    current += words;
+    return true;
+  }
+
+  bool ASTReader::read_type(PTR<const Type>& out) noexcept
+  {
+    u64 index;
+    if (!read(index) || index >= types.get_size())
+      return false;
+    out = types[index];
+    return true;
+  }
+
+  bool ASTReader::read_expr(PTR<Expr>& out, bool nullable) noexcept
+  {
+    u64 index;
+    if (!read(index))
+      return false;
+    if (nullable && index == COLT_SERIALIZE_NONE)
+    {
+      out = nullptr;
+      return true;
+    }
+    if (index >= exprs.get_size())
+      return false;
+    out = exprs[index];
+    return true;
+  }
+
+  bool ASTReader::read_expr(PTR<Expr>& out, Expr::ExprID ID) noexcept
+  {
+    return read_expr(out) && out->classof() == ID;
+  }
+
+  bool ASTReader::read_type_record() noexcept
+  {
+    u64 ID, is_const;
+    if (!read(ID) || !read(is_const))
+      return false;
+
+    PTR<const Type> type;
+    switch (ID)
+    {
+    break; case Type::TYPE_VOID:
+      type = VoidType::CreateType(is_const, ctx);
+    break; case Type::TYPE_BUILTIN:
+    {
+      u64 builtin;
+      if (!read(builtin))
+        return false;
+      switch (builtin)
+      {
+      break; case BOOL:  type = BuiltInType::CreateBool(is_const, ctx);
+      break; case CHAR:  type = BuiltInType::CreateChar(is_const, ctx);
+      break; case U8:    type = BuiltInType::CreateU8(is_const, ctx);
+      break; case U16:   type = BuiltInType::CreateU16(is_const, ctx);
+      break; case U32:   type = BuiltInType::CreateU32(is_const, ctx);
+      break; case U64:   type = BuiltInType::CreateU64(is_const, ctx);
+      break; case U128:  type = BuiltInType::CreateU128(is_const, ctx);
+      break; case I8:    type = BuiltInType::CreateI8(is_const, ctx);
+      break; case I16:   type = BuiltInType::CreateI16(is_const, ctx);
+      break; case I32:   type = BuiltInType::CreateI32(is_const, ctx);
+      break; case I64:   type = BuiltInType::CreateI64(is_const, ctx);
+      break; case I128:  type = BuiltInType::CreateI128(is_const, ctx);
+      break; case F32:   type = BuiltInType::CreateF32(is_const, ctx);
+      break; case F64:   type = BuiltInType::CreateF64(is_const, ctx);
+      break; case byte:  type = BuiltInType::CreateBYTE(is_const, ctx);
+      break; case word:  type = BuiltInType::CreateWORD(is_const, ctx);
+      break; case dword: type = BuiltInType::CreateDWORD(is_const, ctx);
+      break; case qword: type = BuiltInType::CreateQWORD(is_const, ctx);
+      break; default:
+        return false;
+      }
+    }
+    break; case Type::TYPE_PTR:
+    {
+      PTR<const Type> ptr_to;
+      if (!read_type(ptr_to))
+        return false;
+      type = PtrType::CreatePtr(is_const, ptr_to, ctx);
+    }
+    break; case Type::TYPE_ARRAY:
+    {
+      PTR<const Type> array_of;
+      u64 count;
+      if (!read_type(array_of) || !read(count))
+        return false;
+      type = ArrayType::CreateArray(array_of, count, ctx);
+    }
+    break; case Type::TYPE_SLICE:
+    {
+      PTR<const Type> slice_of;
+      if (!read_type(slice_of))
+        return false;
+      type = SliceType::CreateSlice(is_const, slice_of, ctx);
+    }
+    break; case Type::TYPE_VEC:
+    {
+      PTR<const Type> vec_of;
+      u64 count;
+      if (!read_type(vec_of) || !read(count))
+        return false;
+      if (!VecType::isValidElement(vec_of) || !VecType::isValidCount(count))
+        return false;
+      type = VecType::CreateVec(vec_of, count, ctx);
+    }
+    break; case Type::TYPE_FN:
+    {
+      PTR<const Type> return_type;
+      u64 is_vararg, count;
+      if (!read_type(return_type) || !read(is_vararg) || !read(count))
+        return false;
+      SmallVector<PTR<const Type>, 4> params;
+      for (u64 i = 0; i < count; i++)
+      {
+        PTR<const Type> param;
+        if (!read_type(param))
+          return false;
+        params.push_back(param);
+      }
+      type = FnType::CreateFn(return_type, std::move(params), is_vararg, ctx);
+    }
+    break; default:
+      return false;
+    }
+    types.push_back(type);
+    return true;
+  }
+
+  bool ASTReader::read_expr_record() noexcept
+  {
+    u64 ID, lines;
+    PTR<const Type> type;
+    if (!read(ID) || !read_type(type) || !read(lines))
+      return false;
+
+    //Only the line numbers are serialized
+    SourceCodeLocation src_loc;
+    src_loc.line_begin = as<u32>(lines);
+    src_loc.line_end = as<u32>(lines >> 32);
+
+    PTR<Expr> expr;
+    switch (ID)
+    {
+    break; case Expr::EXPR_LITERAL:
+    {
+      u64 is_lstring;
+      QWORD value;
+      if (!read(is_lstring) || is_lstring != as<u64>(type->is_lstring()))
+        return false;
+      if (is_lstring)
+      {
+        StringView str;
+        if (!read_str(str))
+          return false;
+        String to_insert;
+        to_insert += str;
+        value = ast.str_table.insert(std::move(to_insert)).first;
+      }
+      else
+      {
+        u64 raw;
+        if (!read(raw))
+          return false;
+        value = QWORD{ raw };
+      }
+      expr = ctx.add_expr<LiteralExpr>(value, type, src_loc);
+    }
+    break; case Expr::EXPR_UNARY:
+    {
+      u64 op;
+      PTR<Expr> child;
+      if (!read(op) || !read_expr(child) || op > as<u64>(UnaryOperator::OP_BIT_NOT))
+        return false;
+      //'&' results in a pointer to its operand, the other operators in its type
+      if (as<UnaryOperator>(op) == UnaryOperator::OP_ADDRESSOF
+        ? !is_a<PtrType>(type) || !as<PTR<const PtrType>>(type)->get_type_to()->is_equal(child->get_type())
+        : !type->is_equal(child->get_type()))
+        return false;
+      expr = ctx.add_expr<UnaryExpr>(type, as<UnaryOperator>(op), child, src_loc);
+    }
+    break; case Expr::EXPR_BINARY:
+    {
+      u64 op;
+      PTR<Expr> lhs, rhs;
+      if (!read_expr(lhs) || !read(op) || !read_expr(rhs)
+        || op > as<u64>(BinaryOperator::OP_ASSIGN_RSHIFT))
+        return false;
+      if (!lhs->get_type()->is_equal(rhs->get_type())
+        || (!is_a<BuiltInType>(lhs->get_type()) && !is_a<VecType>(lhs->get_type())))
+        return false;
+      expr = ctx.add_expr<BinaryExpr>(type, lhs, as<BinaryOperator>(op), rhs, src_loc);
+    }
+    break; case Expr::EXPR_CONVERT:
+    {
+      u64 cnv;
+      PTR<Expr> child;
+      if (!read_expr(child) || !read(cnv) || cnv > ConvertExpr::CNV_BIT_AS)
+        return false;
+      expr = ctx.add_expr<ConvertExpr>(type, child, as<ConvertExpr::ConversionType>(cnv), src_loc);
+    }
+    break; case Expr::EXPR_VAR_DECL:
+    {
+      PTR<Expr> init;
+      u64 is_global;
+      StringView name;
+      if (!read_expr(init, true) || !read(is_global) || !read_str(name))
+        return false;
+      if (init != nullptr && !init->get_type()->is_equal(type))
+        return false;
+      expr = ctx.add_expr<VarDeclExpr>(type, InternSymbol(name), init, is_global, src_loc);
+    }
+    break; case Expr::EXPR_VAR_READ:
+    {
+      u64 local_ID;
+      StringView name;
+      if (!read(local_ID) || !read_str(name))
+        return false;
+      if (local_ID == std::numeric_limits<u64>::max())
+        expr = ctx.add_expr<VarReadExpr>(type, InternSymbol(name), src_loc);
+      else
+        expr = ctx.add_expr<VarReadExpr>(type, InternSymbol(name), local_ID, src_loc);
+    }
+    break; case Expr::EXPR_VAR_WRITE:
+    {
+      PTR<Expr> value;
+      u64 local_ID;
+      StringView name;
+      //The type of the expression is the one of the variable
+      if (!read_expr(value) || !read(local_ID) || !read_str(name)
+        || !value->get_type()->is_equal(type))
+        return false;
+      if (local_ID == std::numeric_limits<u64>::max())
+        expr = ctx.add_expr<VarWriteExpr>(type, InternSymbol(name), value, src_loc);
+      else
+        expr = ctx.add_expr<VarWriteExpr>(type, InternSymbol(name), value, local_ID, src_loc);
+    }
+    break; case Expr::EXPR_FN_DECL:
+    {
+      u64 is_extern, count;
+      StringView name;
+      if (!is_a<FnType>(type) || !read(is_extern) || !read_str(name) || !read(count)
+        || count != as<PTR<const FnType>>(type)->get_params_type().get_size())
+        return false;
+      SmallVector<StringView, 4> params;
+      for (u64 i = 0; i < count; i++)
+      {
+        StringView param;
+        if (!read_str(param))
+          return false;
+        params.push_back(param);
+      }
+      expr = ctx.add_expr<FnDeclExpr>(type, name, ctx.add_array<StringView>(params.to_view()), is_extern, src_loc);
+    }
+    break; case Expr::EXPR_FN_DEF:
+    {
+      PTR<Expr> decl, body;
+      if (!read_expr(decl, Expr::EXPR_FN_DECL) || !read_expr(body, true))
+        return false;
+      expr = ctx.add_expr<FnDefExpr>(type, as<PTR<FnDeclExpr>>(decl), body, src_loc);
+    }
+    break; case Expr::EXPR_FN_CALL:
+    {
+      PTR<Expr> decl;
+      u64 count;
+      if (!read_expr(decl, Expr::EXPR_FN_DECL) || !read(count))
+        return false;
+      //Variadic functions accept more arguments than parameters
+      auto fn_type = as<PTR<const FnDeclExpr>>(decl)->get_type();
+      auto params = fn_type->get_params_type();
+      if (count < params.get_size() || (count != params.get_size() && !fn_type->is_varargs()))
+        return false;
+      SmallVector<PTR<Expr>, 4> args;
+      for (u64 i = 0; i < count; i++)
+      {
+        PTR<Expr> arg;
+        if (!read_expr(arg) || (i < params.get_size() && !arg->get_type()->is_equal(params[i])))
+          return false;
+        args.push_back(arg);
+      }
+      expr = ctx.add_expr<FnCallExpr>(as<PTR<const FnDeclExpr>>(decl), ctx.add_array<PTR<Expr>>(args.to_view()), src_loc);
+    }
+    break; case Expr::EXPR_FN_RETURN:
+    {
+      PTR<Expr> value;
+      if (!read_expr(value, true))
+        return false;
+      expr = ctx.add_expr<FnReturnExpr>(type, value, src_loc);
+    }
+    break; case Expr::EXPR_SCOPE:
+    {
+      u64 count;
+      if (!read(count))
+        return false;
+      Vector<PTR<Expr>> body;
+      for (u64 i = 0; i < count; i++)
+      {
+        PTR<Expr> stmt;
+        if (!read_expr(stmt))
+          return false;
+        body.push_back(stmt);
+      }
+      expr = ctx.add_expr<ScopeExpr>(type, ctx.add_array<PTR<Expr>>(body.to_view()), src_loc);
+    }
+    break; case Expr::EXPR_CONDITION:
+    {
+      PTR<Expr> if_cond, if_stmt, else_stmt;
+      if (!read_expr(if_cond) || !read_expr(if_stmt) || !read_expr(else_stmt, true)
+        || !if_cond->get_type()->is_bool())
+        return false;
+      expr = ctx.add_expr<ConditionExpr>(type, if_cond, if_stmt, else_stmt, src_loc);
+    }
+    break; case Expr::EXPR_SWITCH:
+    {
+      PTR<Expr> value, default_body;
+      u64 case_count, body_count;
+      if (!read_expr(value) || !read_expr(default_body, true) || !read(case_count))
+        return false;
+      Vector<std::pair<PTR<const LiteralExpr>, u64>> cases;
+      for (u64 i = 0; i < case_count; i++)
+      {
+        PTR<Expr> literal;
+        u64 body;
+        if (!read_expr(literal, Expr::EXPR_LITERAL) || !read(body))
+          return false;
+        cases.push_back({ as<PTR<const LiteralExpr>>(literal), body });
+      }
+      if (!read(body_count))
+        return false;
+      Vector<PTR<Expr>> bodies;
+      for (u64 i = 0; i < body_count; i++)
+      {
+        PTR<Expr> body;
+        if (!read_expr(body))
+          return false;
+        bodies.push_back(body);
+      }
+      for (size_t i = 0; i < cases.get_size(); i++)
+        if (cases[i].second >= body_count)
+          return false;
+      expr = ctx.add_expr<SwitchExpr>(type, value, ctx.add_array<std::pair<PTR<const LiteralExpr>, u64>>(cases.to_view()),
+        ctx.add_array<PTR<Expr>>(bodies.to_view()), default_body, src_loc);
+    }
+    break; case Expr::EXPR_FOR_LOOP:
+    {
+      PTR<const Type> var_type;
+      PTR<Expr> begin, end, body;
+      StringView var_name;
+      if (!read_type(var_type) || !read_expr(begin) || !read_expr(end)
+        || !read_expr(body) || !read_str(var_name))
+        return false;
+      if (!is_a<BuiltInType>(var_type) || !var_type->is_equal(begin->get_type())
+        || !var_type->is_equal(end->get_type()))
+        return false;
+      expr = ctx.add_expr<ForLoopExpr>(type, var_name, var_type, begin, end, body, src_loc);
+    }
+    break; case Expr::EXPR_WHILE_LOOP:
+    {
+      PTR<Expr> condition, body;
+      if (!read_expr(condition) || !read_expr(body) || !condition->get_type()->is_bool())
+        return false;
+      expr = ctx.add_expr<WhileLoopExpr>(type, condition, body, src_loc);
+    }
+    break; case Expr::EXPR_BREAK_CONTINUE:
+    {
+      u64 is_break;
+      if (!read(is_break))
+        return false;
+      expr = ctx.add_expr<BreakContinueExpr>(type, is_break, src_loc);
+    }
+    break; case Expr::EXPR_NOP:
+      expr = ctx.add_expr<NoOpExpr>(type, src_loc);
+    break; case Expr::EXPR_PTR_STORE:
+    {
+      PTR<Expr> where, value;
+      if (!read_expr(where) || !read_expr(value) || !is_a<PtrType>(where->get_type())
+        || !as<PTR<const PtrType>>(where->get_type())->get_type_to()->is_equal(value->get_type()))
+        return false;
+      expr = ctx.add_expr<PtrStoreExpr>(as<PTR<const PtrType>>(where->get_type()), where, value, src_loc);
+    }
+    break; case Expr::EXPR_PTR_LOAD:
+    {
+      PTR<Expr> where;
+      if (!read_expr(where) || !is_a<PtrType>(where->get_type()))
+        return false;
+      expr = ctx.add_expr<PtrLoadExpr>(as<PTR<const PtrType>>(where->get_type()), where, src_loc);
+    }
+    break; case Expr::EXPR_INDEX:
+    {
+      PTR<Expr> where, index;
+      u64 is_checked;
+      if (!read_expr(where) || !read_expr(index) || !read(is_checked)
+        || !index->get_type()->is_integral())
+        return false;
+      //Arrays and slices can be indexed, resulting in a pointer to the element
+      auto where_t = where->get_type();
+      if ((!where_t->is_array() && !where_t->is_slice()) || !is_a<PtrType>(type))
+        return false;
+      auto element_t = where_t->is_array() ? as<PTR<const ArrayType>>(where_t)->get_type_of()
+        : as<PTR<const SliceType>>(where_t)->get_type_of();
+      if (!as<PTR<const PtrType>>(type)->get_type_to()->is_equal(element_t))
+        return false;
+      expr = ctx.add_expr<IndexExpr>(type, where, index, is_checked, src_loc);
+    }
+    break; case Expr::EXPR_SLICE_LEN:
+    {
+      PTR<Expr> slice;
+      if (!read_expr(slice) || !slice->get_type()->is_slice())
+        return false;
+      expr = ctx.add_expr<SliceLenExpr>(type, slice, src_loc);
+    }
+    break; case Expr::EXPR_TO_SLICE:
+    {
+      PTR<Expr> array;
+      if (!read_expr(array) || !is_a<ArrayType>(array->get_type()))
+        return false;
+      expr = ctx.add_expr<ToSliceExpr>(type, array, src_loc);
+    }
+    break; case Expr::EXPR_VEC_INTRINSIC:
+    {
+      u64 intrinsic, count;
+      if (!read(intrinsic) || !read(count) || intrinsic > VecIntrinsicExpr::VEC_STORE_MASKED)
+        return false;
+      SmallVector<PTR<Expr>, 4> args;
+      for (u64 i = 0; i < count; i++)
+      {
+        PTR<Expr> arg;
+        if (!read_expr(arg))
+          return false;
+        args.push_back(arg);
+      }
+      expr = ctx.add_expr<VecIntrinsicExpr>(type, as<VecIntrinsicExpr::VecIntrinsicID>(intrinsic), ctx.add_array<PTR<Expr>>(args.to_view()), src_loc);
+    }
+    break; default:
+      return false;
+    }
+    exprs.push_back(expr);
+    return true;
+  }
+
+  void ASTReader::push_local(PTR<const Type> type) noexcept
+  {
+    //FNV-1a over the addresses of the types
+    u64 hash = get_locals_hash(local_types.get_size()) ^ reinterpret_cast<uintptr_t>(type);
+    local_types.push_back(type);
+    local_hashes.push_back(hash * 0x100000001B3);
+  }
+
+  void ASTReader::pop_locals(u64 count) noexcept
+  {
+    local_types.pop_back_n(count);
+    local_hashes.pop_back_n(count);
+  }
+
+  bool ASTReader::check_locals(PTR<const Expr> expr) noexcept
+  {
+    if (expr == nullptr)
+      return true;
+    u64 live = local_types.get_size();
+    //Having more live local variables cannot make an expression invalid,
+    //if the ones with which it was checked have the same types
+    if (auto ptr = checked_locals.find(expr); ptr != nullptr)
+    {
+      auto [checked_live, checked_hash] = ptr->second;
+      if (checked_live <= live && get_locals_hash(checked_live) == checked_hash)
+        return true;
+      ptr->second = { live, get_locals_hash(live) };
+    }
+    else
+      checked_locals.insert(expr, std::pair<u64, u64>{ live, get_locals_hash(live) });
+
+    switch (expr->classof())
+    {
+    break; case Expr::EXPR_LITERAL:
+    case Expr::EXPR_FN_DECL:
+    case Expr::EXPR_BREAK_CONTINUE:
+    case Expr::EXPR_NOP:
+      return true;
+    break; case Expr::EXPR_UNARY:
+      return check_locals(as<PTR<const UnaryExpr>>(expr)->get_child());
+    break; case Expr::EXPR_BINARY:
+    {
+      auto ptr = as<PTR<const BinaryExpr>>(expr);
+      return check_locals(ptr->get_LHS()) && check_locals(ptr->get_RHS());
+    }
+    break; case Expr::EXPR_CONVERT:
+      return check_locals(as<PTR<const ConvertExpr>>(expr)->get_child());
+    break; case Expr::EXPR_VAR_DECL:
+      return check_locals(as<PTR<const VarDeclExpr>>(expr)->get_value());
+    break; case Expr::EXPR_VAR_READ:
+    {
+      auto ptr = as<PTR<const VarReadExpr>>(expr);
+      return ptr->is_global() || (ptr->get_local_ID() < live
+        && ptr->get_type()->is_equal(local_types[ptr->get_local_ID()]));
+    }
+    break; case Expr::EXPR_VAR_WRITE:
+    {
+      auto ptr = as<PTR<const VarWriteExpr>>(expr);
+      return (ptr->is_global() || (ptr->get_local_ID() < live
+        && ptr->get_type()->is_equal(local_types[ptr->get_local_ID()])))
+        && check_locals(ptr->get_value());
+    }
+    break; case Expr::EXPR_FN_DEF:
+    {
+      //The parameters are the first local variables (functions are not nested)
+      auto ptr = as<PTR<const FnDefExpr>>(expr);
+      if (live != 0)
+        return false;
+      auto params = ptr->get_fn_decl()->get_params_type();
+      for (size_t i = 0; i < params.get_size(); i++)
+        push_local(params[i]);
+      ON_EXIT{ pop_locals(params.get_size()); };
+      return check_locals(ptr->get_body());
+    }
+    break; case Expr::EXPR_FN_CALL:
+      for (auto arg : as<PTR<const FnCallExpr>>(expr)->get_arguments())
+        if (!check_locals(arg))
+          return false;
+      return true;
+    break; case Expr::EXPR_FN_RETURN:
+      return check_locals(as<PTR<const FnReturnExpr>>(expr)->get_value());
+    break; case Expr::EXPR_SCOPE:
+    {
+      //The local variables declared in a scope are live until its end
+      u64 declared = 0;
+      ON_EXIT{ pop_locals(declared); };
+      for (auto stmt : as<PTR<const ScopeExpr>>(expr)->get_body_array())
+      {
+        if (!check_locals(stmt))
+          return false;
+        if (auto var = dyn_cast<PTR<const VarDeclExpr>>(stmt); var && !var->is_global())
+        {
+          push_local(var->get_type());
+          declared++;
+        }
+      }
+      return true;
+    }
+    break; case Expr::EXPR_CONDITION:
+    {
+      auto ptr = as<PTR<const ConditionExpr>>(expr);
+      return check_locals(ptr->get_if_condition()) && check_locals(ptr->get_if_statement())
+        && check_locals(ptr->get_else_statement());
+    }
+    break; case Expr::EXPR_SWITCH:
+    {
+      auto ptr = as<PTR<const SwitchExpr>>(expr);
+      if (!check_locals(ptr->get_value()) || !check_locals(ptr->get_default()))
+        return false;
+      for (auto body : ptr->get_case_bodies())
+        if (!check_locals(body))
+          return false;
+      return true;
+    }
+    break; case Expr::EXPR_FOR_LOOP:
+    {
+      //The variable of the loop is live in its body
+      auto ptr = as<PTR<const ForLoopExpr>>(expr);
+      if (!check_locals(ptr->get_begin()) || !check_locals(ptr->get_end()))
+        return false;
+      push_local(ptr->get_var_type());
+      ON_EXIT{ pop_locals(1); };
+      return check_locals(ptr->get_body());
+    }
+    break; case Expr::EXPR_WHILE_LOOP:
+    {
+      auto ptr = as<PTR<const WhileLoopExpr>>(expr);
+      return check_locals(ptr->get_condition()) && check_locals(ptr->get_body());
+    }
+    break; case Expr::EXPR_PTR_STORE:
+    {
+      auto ptr = as<PTR<const PtrStoreExpr>>(expr);
+      return check_locals(ptr->get_where()) && check_locals(ptr->get_value());
+    }
+    break; case Expr::EXPR_PTR_LOAD:
+      return check_locals(as<PTR<const PtrLoadExpr>>(expr)->get_where());
+    break; case Expr::EXPR_INDEX:
+    {
+      auto ptr = as<PTR<const IndexExpr>>(expr);
+      return check_locals(ptr->get_where()) && check_locals(ptr->get_index());
+    }
+    break; case Expr::EXPR_SLICE_LEN:
+      return check_locals(as<PTR<const SliceLenExpr>>(expr)->get_slice());
+    break; case Expr::EXPR_TO_SLICE:
+      return check_locals(as<PTR<const ToSliceExpr>>(expr)->get_array());
+    break; case Expr::EXPR_VEC_INTRINSIC:
+      for (auto arg : as<PTR<const VecIntrinsicExpr>>(expr)->get_arguments())
+        if (!check_locals(arg))
+          return false;
+      return true;
+    break; default:
+      return false;
+    }
+  }
+
+  Expected<bool, const char*> ASTReader::read_ast() noexcept
+  {
+    u64 magic, version, type_count, expr_count, global_count, root_count, import_count, object_count, hash_count;
+    if (!read(magic) || magic != COLT_SERIALIZE_MAGIC)
+      return { Error, "File is not a serialized AST!" };
+    if (!read(version) || version != COLT_SERIALIZE_VERSION)
+      return { Error, "Serialized AST was written by an incompatible version of the compiler!" };
+    if (!read(type_count) || !read(expr_count) || !read(global_count) || !read(root_count)
+      || !read(import_count) || !read(object_count) || !read(hash_count))
+      return { Error, "Serialized AST is corrupted!" };
+
+    for (u64 i = 0; i < type_count; i++)
+      if (!read_type_record())
+        return { Error, "Serialized AST is corrupted!" };
+    for (u64 i = 0; i < expr_count; i++)
+      if (!read_expr_record())
+        return { Error, "Serialized AST is corrupted!" };
+
+    //Validate the global table before modifying the AST
+    auto globals_begin = current;
+    for (u64 i = 0; i < global_count; i++)
+    {
+      StringView name;
+      u64 count;
+      if (!read_str(name) || !read(count))
+        return { Error, "Serialized AST is corrupted!" };
+      if (ast.global_map.find(InternSymbol(name)) != nullptr)
+        return { Error, "Serialized AST redefines an existing global!" };
+      for (u64 j = 0; j < count; j++)
+      {
+        PTR<Expr> global;
+        if (!read_expr(global) || (!is_a<FnDefExpr>(global) && !is_a<VarDeclExpr>(global))
+          || !check_locals(global))
+          return { Error, "Serialized AST is corrupted!" };
+      }
+    }
+    Vector<PTR<Expr>> roots;
+    for (u64 i = 0; i < root_count; i++)
+    {
+      PTR<Expr> root;
+      if (!read_expr(root) || !check_locals(root))
+        return { Error, "Serialized AST is corrupted!" };
+      roots.push_back(root);
+    }
+    Vector<PTR<Expr>> imports;
+    for (u64 i = 0; i < import_count; i++)
+    {
+      PTR<Expr> import;
+      if (!read_expr(import) || !check_locals(import))
+        return { Error, "Serialized AST is corrupted!" };
+      imports.push_back(import);
+    }
+    Vector<StringView> objects;
+    for (u64 i = 0; i < object_count; i++)
+    {
+      StringView object;
+      if (!read_str(object))
+        return { Error, "Serialized AST is corrupted!" };
+      objects.push_back(object);
+    }
+    Vector<std::pair<StringView, u64>> hashes;
+    for (u64 i = 0; i < hash_count; i++)
+    {
+      StringView name;
+      u64 hash;
+      if (!read_str(name) || !read(hash))
+        return { Error, "Serialized AST is corrupted!" };
+      hashes.push_back({ name, hash });
+    }
+
+    current = globals_begin;
+    for (u64 i = 0; i < global_count; i++)
+    {
+      StringView name;
+      u64 count;
+      read_str(name);
+      read(count);
+      SmallVector<PTR<Expr>> overloads;
+      for (u64 j = 0; j < count; j++)
+      {
+        PTR<Expr> global;
+        read_expr(global);
+        overloads.push_back(global);
+      }
+      ast.global_map.insert(InternSymbol(name), overloads);
+    }
+    for (size_t i = 0; i < roots.get_size(); i++)
+      ast.expressions.push_back(roots[i]);
+    for (size_t i = 0; i < imports.get_size(); i++)
+      ast.imports.push_back(imports[i]);
+    for (size_t i = 0; i < objects.get_size(); i++)
+      AddModuleObject(objects[i], ast);
+    for (size_t i = 0; i < hashes.get_size(); i++)
+    {
+      String name;
+      name += hashes[i].first;
+      ast.module_hashes.push_back({ std::move(name), hashes[i].second });
+    }
+    return true;
+  }
+
+  /************************************
+  * FUNCTIONS
+  ************************************/
+
+  Vector<u64> SerializeAST(const AST& ast) noexcept
+  {
+    return ASTWriter{ ast }.get_result();
+  }
+
+  Expected<bool, const char*> SerializeAST(const AST& ast, const char* path) noexcept
+  {
+    auto buffer = SerializeAST(ast);
+    std::ofstream file{ path, std::ios::binary };
+    if (!file.is_open())
+      return { Error, "Could not open output file!" };
+    file.write(reinterpret_cast<const char*>(buffer.get_data()), buffer.get_size() * sizeof(u64));
+    if (!file)
+      return { Error, "Could not write output file!" };
+    return true;
+  }
+
+  Expected<bool, const char*> DeserializeAST(const u64* buffer, size_t size, AST& ast) noexcept
+  {
+    return ASTReader{ buffer, size, ast }.read_ast();
+  }
+
+  Expected<bool, const char*> DeserializeAST(const char* path, AST& ast) noexcept
+  {
+    std::error_code ec;
+    auto byte_size = std::filesystem::file_size(path, ec);
+    if (ec || byte_size % sizeof(u64) != 0)
+      return { Error, "Could not read serialized AST file!" };
+
+    std::ifstream file{ path, std::ios::binary };
+    if (!file.is_open())
+      return { Error, "Could not read serialized AST file!" };
+    auto size = byte_size / sizeof(u64);
+    auto buffer = std::unique_ptr<u64[]>(new(std::nothrow) u64[size]);
+    if (buffer == nullptr || !file.read(reinterpret_cast<char*>(buffer.get()), byte_size))
+      return { Error, "Could not read serialized AST file!" };
+
+    //The names of the AST point inside the buffer
+    auto data = ast.ctx.add_buffer(std::move(buffer));
+    return DeserializeAST(data, size, ast);
+  }
+}
@@ -0,0 +1,61 @@
+/** @file colt_serialize.h
+* Contains the binary serialization of an AST.
+* A serialized AST can be loaded back without lexing or parsing
+* the source code, which allows precompiling modules.
+* The format is a sequence of 64-bit words (in the endianness of the host):
+* - a header (magic, version, and the count of each record kind)
+* - the types, each type only referencing types written before it
+* - the expressions, each expression only referencing expressions written before it
+* - the global table (name and indices of expressions)
+* - the indices of the root expressions of the AST
+* - the indices of the declarations imported from other modules
+* - the paths of the object files of the imported modules
+* - the names and hashes of the sources of the imported modules.
+* Names (of variables, functions, parameters) are stored inline and are
+* not copied when loading: the StringView point inside the loaded buffer,
+* which is owned by the COLTContext of the AST.
+* The source code information of loaded expressions only contains line numbers.
+*/
+
+#ifndef HG_COLT_SERIALIZE
+#define HG_COLT_SERIALIZE
+
+#include <util/colt_pch.h>
+#include <ast/colt_ast.h>
+
+namespace colt::lang
+{
+  /// @brief The version of the serialization format, which must
+  /// be incremented each time the format (or an Expr/Type) changes
+  static constexpr u64 COLT_SERIALIZE_VERSION = 3;
+
+  /// @brief Serializes an AST to a buffer of 64-bit words
+  /// @param ast The AST to serialize (which must not contain errors)
+  /// @return The serialized AST
+  Vector<u64> SerializeAST(const AST& ast) noexcept;
+
+  /// @brief Serializes an AST and writes it to a file
+  /// @param ast The AST to serialize (which must not contain errors)
+  /// @param path The path of the file to write
+  /// @return Error message or true
+  Expected<bool, const char*> SerializeAST(const AST& ast, const char* path) noexcept;
+
+  /// @brief Loads a serialized AST, adding its content to an existing AST.
+  /// The indices (of types, expressions and local variables) are validated.
+  /// On error, the expressions, globals and imports of 'ast' are left unchanged,
+  /// but string literals read before the error may have been added to its String table.
+  /// @param buffer The serialized AST, whose lifetime must be at least the one of 'ast'
+  /// @param size The count of words in 'buffer'
+  /// @param ast The AST to which to add the expressions and globals
+  /// @return Error message or true
+  Expected<bool, const char*> DeserializeAST(const u64* buffer, size_t size, AST& ast) noexcept;
+
+  /// @brief Reads a file containing a serialized AST, and adds its content to an existing AST.
+  /// The content of the file is owned by the COLTContext of 'ast'.
+  /// @param path The path of the file to read
+  /// @param ast The AST to which to add the expressions and globals
+  /// @return Error message or true
+  Expected<bool, const char*> DeserializeAST(const char* path, AST& ast) noexcept;
+}
+
+#endif //!HG_COLT_SERIALIZE
@@ -0,0 +1,189 @@
+/** @file colt_bench.cpp
+* Contains the microbenchmarks of the components of the compiler ('colt_bench').
+* Each benchmark repeats an operation on a generated program for at least
+* 'MIN_RUN_TIME', and prints the best throughput of 'RUN_COUNT' runs.
+* USAGE: colt_bench [<prefix>] (runs the benchmarks whose name begins with <prefix>)
+*/
+
+#include <main_util.h>
+#include <code_gen/mangle.h>
+
+using namespace colt;
+using namespace colt::lang;
+
+namespace colt::bench
+{
+  /// @brief The minimum duration of a run of a benchmark (in seconds)
+  static constexpr double MIN_RUN_TIME = 0.5;
+  /// @brief The count of runs of each benchmark
+  static constexpr u64 RUN_COUNT = 3;
+
+  /// @brief Written by the benchmarks so that their work is not optimized away
+  static volatile u64 BenchSink = 0;
+
+  /// @brief Generates a program whose functions declare and assign local variables
+  /// @param fn_count The count of functions
+  /// @param local_count The count of local variables of each function
+  /// @return The source code of the program
+  static std::string GenerateProgram(u64 fn_count, u64 local_count) noexcept
+  {
+    std::string program;
+    auto out = std::back_inserter(program);
+    for (u64 i = 0; i < fn_count; i++)
+    {
+      fmt::format_to(out, "fn f{}(i64 a, i64 b)->i64\n{{\n  var mut l0 = a + b;\n", i);
+      for (u64 j = 1; j < local_count; j++)
+        fmt::format_to(out, "  var mut l{} = l{} * {}i64 + b;\n", j, j / 2, j);
+      for (u64 j = 0; j < local_count; j++)
+        fmt::format_to(out, "  if l{} < {}i64:\n    l{} = l{} - a;\n", j, j * 7, j, (j * 3) % local_count);
+      //Calls exercise the lookup of the functions
+      if (i != 0)
+        fmt::format_to(out, "  l0 = l0 + f{}(l0, b);\n", i - 1);
+      fmt::format_to(out, "  return l{};\n}}\n\n", local_count - 1);
+    }
+    fmt::format_to(out, "fn main()->i64: return f{}(1i64, 2i64);\n", fn_count - 1);
+    return program;
+  }
+
+  /// @brief Generates a program whose functions return an expression made of literals,
+  /// which is folded by the ASTMaker
+  /// @param fn_count The count of functions
+  /// @param literal_count The count of literals of the expression of each function
+  /// @return The source code of the program
+  static std::string GenerateLiteralProgram(u64 fn_count, u64 literal_count) noexcept
+  {
+    static constexpr const char* Operators[] = { "+", "*", "-" };
+    std::string program;
+    auto out = std::back_inserter(program);
+    for (u64 i = 0; i < fn_count; i++)
+    {
+      fmt::format_to(out, "fn f{}()->i64: return {}i64", i, i);
+      for (u64 j = 1; j < literal_count; j++)
+        fmt::format_to(out, " {} {}i64", Operators[j % std::size(Operators)], j % 16);
+      fmt::format_to(out, ";\n");
+    }
+    return program;
+  }
+
+  /// @brief Converts a std::string to a NUL terminated StringView
+  /// @param str The string to convert
+  /// @return StringView over the string and its NUL terminator
+  static StringView ToStringView(const std::string& str) noexcept
+  {
+    return StringView{ str.c_str(), str.c_str() + str.size() + 1 };
+  }
+
+  /// @brief Parses a generated program, aborting on errors
+  /// @param source The program to parse
+  /// @param ctx The context in which to store the AST
+  /// @return The AST of the program
+  static AST ParseOrAbort(StringView source, COLTContext& ctx) noexcept
+  {
+    auto ast = CreateAST(source, ctx);
+    if (ast.is_error())
+    {
+      io::PrintError("The generated program contains {} errors!", ast.get_error());
+      std::exit(1);
+    }
+    return std::move(ast.get_value());
+  }
+
+  template<typename Fn>
+  /// @brief Runs a benchmark and prints its throughput
+  /// @tparam Fn The type of the operation
+  /// @param filter The prefix of the names of the benchmarks to run
+  /// @param name The name of the benchmark
+  /// @param unit The unit of the work done by the operation
+  /// @param fn The operation, which returns the count of units processed
+  static void RunBench(StringView filter, const char* name, const char* unit, Fn&& fn) noexcept
+  {
+    if (!StringView{ name }.begins_with(filter))
+      return;
+
+    double best = 0.0;
+    for (u64 run = 0; run < RUN_COUNT; run++)
+    {
+      u64 units = 0;
+      double elapsed = 0.0;
+      auto begin = std::chrono::steady_clock::now();
+      do
+      {
+        units += fn();
+        elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+          std::chrono::steady_clock::now() - begin).count();
+      } while (elapsed < MIN_RUN_TIME);
+      best = std::max(best, static_cast<double>(units) / elapsed);
+    }
+    io::Print("{:<16}{:>16.0f} {}/s", name, best, unit);
+  }
+}
+
+int main(int argc, const char** argv)
+{
+  using namespace colt::bench;
+
+  //Only errors are reported, which the generated programs do not contain
+  args::NoColor = true;
+  args::NoMessage = true;
+  args::NoWarning = true;
+  InitializeCOLT();
+
+  StringView filter = argc > 1 ? StringView{ argv[1] } : StringView{ "" };
+
+  const auto program = GenerateProgram(200, 32);
+  const auto literals = GenerateLiteralProgram(200, 64);
+  const StringView source = ToStringView(program);
+
+  RunBench(filter, "lexer", "tokens", [&]() noexcept
+    {
+      Lexer lexer = { source };
+      while (lexer.get_next_token() != TKN_EOF)
+        ;
+      return lexer.get_token_count();
+    });
+
+  RunBench(filter, "parse", "bytes", [&]() noexcept
+    {
+      COLTContext ctx;
+      BenchSink = ParseOrAbort(source, ctx).expressions.get_size();
+      return static_cast<u64>(program.size());
+    });
+
+  //Folding is done while parsing: the expressions of literals are the bulk of the work
+  RunBench(filter, "constant_fold", "literals", [&]() noexcept
+    {
+      COLTContext ctx;
+      BenchSink = ParseOrAbort(ToStringView(literals), ctx).expressions.get_size();
+      return static_cast<u64>(200 * 64);
+    });
+
+  COLTContext ctx;
+  const AST ast = ParseOrAbort(source, ctx);
+  Vector<PTR<const FnDeclExpr>> declarations;
+  for (size_t i = 0; i < ast.expressions.get_size(); i++)
+  {
+    if (auto fn_def = dyn_cast<PTR<const FnDefExpr>>(ast.expressions[i]))
+      declarations.push_back(fn_def->get_fn_decl());
+  }
+
+  RunBench(filter, "mangle", "names", [&]() noexcept
+    {
+      for (size_t i = 0; i < declarations.get_size(); i++)
+        BenchSink = gen::mangle(declarations[i]).get_size();
+      return static_cast<u64>(declarations.get_size());
+    });
+
+#ifndef COLT_NO_LLVM
+  RunBench(filter, "generate_ir", "functions", [&]() noexcept
+    {
+      auto IR = gen::GenerateIR(ast);
+      if (IR.is_error())
+      {
+        io::PrintError("{}", IR.get_error());
+        std::exit(1);
+      }
+      BenchSink = IR->get_stats().inst_count;
+      return static_cast<u64>(declarations.get_size());
+    });
+#endif //!COLT_NO_LLVM
+}
@@ -2,6 +2,7 @@
 #define HG_COLT_ARGS_PARSER
 
 #include <array>
+#include <limits>
 #include <utility>
 #include <colt/utility/Typedefs.h>
 #include <util/colt_macro.h>
@@ -81,6 +82,15 @@ namespace colt::args
     return sorted;
   }
 
+  /// @brief The format in which diagnostics are written
+  enum class DiagnosticsFormat : u8
+  {
+    /// @brief Colored text, with the source code highlighted
+    TEXT,
+    /// @brief A JSON object per line
+    JSON
+  };
+
   template<typename T, bool positional>
   struct parser;
 
@@ -162,6 +172,62 @@ namespace colt::args
     }
   };
 
+  template<>
+  struct parser<u64, true>
+  {
+    bool operator()(StringView strv, u64* to_write) const noexcept
+    {
+      u64 value = 0;
+      for (size_t i = 0; i < strv.get_size(); i++)
+      {
+        if (strv[i] < '0' || strv[i] > '9')
+          return false;
+        u64 digit = static_cast<u64>(strv[i] - '0');
+        //Overflow check
+        if (value > (std::numeric_limits<u64>::max() - digit) / 10)
+          return false;
+        value = value * 10 + digit;
+      }
+      *to_write = value;
+      return true;
+    }
+  };
+
+  template<>
+  struct parser<u64, false>
+  {
+    bool operator()(StringView strv, u64* to_write) const noexcept
+    {
+      if (strv.get_front() != '=')
+        return false;
+      strv.pop_front();
+      if (strv.is_empty())
+        return false;
+      return parser<u64, true>{}(strv, to_write);
+    }
+  };
+
+  template<>
+  struct parser<DiagnosticsFormat, false>
+  {
+    bool operator()(StringView strv, DiagnosticsFormat* to_write) const noexcept
+    {
+      using namespace details;
+
+      if (is_iequal(strv, "=text"))
+      {
+        *to_write = DiagnosticsFormat::TEXT;
+        return true;
+      }
+      else if (is_iequal(strv, "=json"))
+      {
+        *to_write = DiagnosticsFormat::JSON;
+        return true;
+      }
+      return false;
+    }
+  };
+
   template<>
   struct parser<StringView, true>
   {
@@ -11,33 +11,46 @@
 
 namespace colt::args
 {  
+  /// @brief The result of parsing the arguments
+  enum class ParseResult
+  {
+    /// @brief The arguments were parsed
+    PARSED,
+    /// @brief '-help' was passed: the help was printed
+    PRINTED_HELP,
+    /// @brief An argument was invalid: the error was printed
+    INVALID
+  };
+
   template<bool positional = false, typename T>
-  void parse(T* write_result, StringView to_parse, StringView arg_name) noexcept
+  bool parse(T* write_result, StringView to_parse, StringView arg_name) noexcept
   {
     if (to_parse.is_empty())
     {
       if constexpr (std::is_same_v<std::decay_t<T>, bool>)
       {
         *write_result = true;
-        return;
+        return true;
       }
       else
       {
         io::PrintError("Argument '{}' expects a value!", arg_name);
-        std::exit(1);
+        return false;
       }
     }
 
     if (!parser<std::decay_t<T>, positional>{}(to_parse, write_result))
     {
       io::PrintError("Invalid value for argument '{}'!", arg_name);
-      std::exit(1);
+      return false;
     }
+    return true;
   }
 
   //HELPERS FOR COMMANDS STARTING WITH "-"
 #define GET_NAME(a, num, v, name, d) StringView{ name },
 #define DECLARE_VAR(name, num, init, n, d) inline decltype(init) name = init;
+#define RESET_VAR(name, num, init, n, d) name = init;
 #define HELP_STR(n, num, i, name, desc) "  -" name ":\n     " desc "\n\n"
 #define GEN_CASE(a, num, v, name, desc) \
   if (name[0] == argv[i][1]) { \
@@ -45,26 +58,31 @@ namespace colt::args
           if constexpr (num != 0) { \
           if (num > argc - i - 1) { \
             io::PrintError("Argument '" name "' expects " #num " arguments!"); \
-            std::exit(1); \
+            return ParseResult::INVALID; \
           } }\
           if constexpr (num == 1) {\
-            parse<true>(&a, argv[++i], name); continue; }\
+            if (!parse<true>(&a, argv[++i], name)) return ParseResult::INVALID; \
+            continue; }\
           else { \
-            parse<false>(&a, argv[i] + sizeof(name), name); continue; }\
+            if (!parse<false>(&a, argv[i] + sizeof(name), name)) return ParseResult::INVALID; \
+            continue; }\
         } }
 
 #define GEN_CASE_ALIAS(a, name) \
   if (name[0] == argv[i][1]) { \
-      if (StringView{ argv[i] + 1 }.begins_with(name)) { parse(&a, argv[i] + sizeof(name), name); continue; } }
+      if (StringView{ argv[i] + 1 }.begins_with(name)) { \
+        if (!parse(&a, argv[i] + sizeof(name), name)) return ParseResult::INVALID; \
+        continue; } }
 
   //POSITIONAL ARGUMENTS
 
 #define HELP_POS(n, t, name) "<" name "> "
 #define DECLARE_VAR_POS(name, t, n) inline decltype(t) name = t;
+#define RESET_VAR_POS(name, t, n) name = t;
 #define GEN_BOOL(name, t, n) bool COLT_CONCAT(name, BOOL) = false;
 #define IF_POS(name, type, n) \
   if (COLT_CONCAT(name, BOOL) == false) {\
-    parse<true>(&name, argv[i], HELP_POS(name, type, n)); \
+    if (!parse<true>(&name, argv[i], HELP_POS(name, type, n))) return ParseResult::INVALID; \
     COLT_CONCAT(name, BOOL) = true;\
     continue; \
   }
@@ -80,14 +98,17 @@ namespace colt::args
     "  -v:\n     Display compiler version informations.\n\n" \
       COMMANDS(HELP_STR) \
     ); \
-    std::exit(0); \
   } \
   constexpr auto NameTable = sort(std::array{ COMMANDS(GET_NAME) }); \
   static_assert(details::is_unique(NameTable), "All arguments name should be unique!"); \
   constexpr auto MaxNameSize = details::max_name_size(NameTable); \
   COMMANDS(DECLARE_VAR) \
   POSITIONALS(DECLARE_VAR_POS)\
-  static void ParseArguments(int argc, const char** argv) noexcept { \
+  static void ResetArguments() noexcept { \
+    COMMANDS(RESET_VAR) \
+    POSITIONALS(RESET_VAR_POS) \
+  } \
+  static ParseResult TryParseArguments(int argc, const char** argv) noexcept { \
     bool is_only_positional = false; \
     for (size_t i = 1; i < argc; i++) \
     { \
@@ -101,7 +122,7 @@ namespace colt::args
       if (StringView{ argv[i] } == "-help") \
       { \
         PrintHelp(); \
-        continue; \
+        return ParseResult::PRINTED_HELP; \
       } \
       if (StringView{ argv[i] } == "-v") \
       { \
@@ -112,8 +133,16 @@ namespace colt::args
       COMMANDS(GEN_CASE) \
       ALIAS(GEN_CASE_ALIAS) \
       io::PrintError("Unknown argument '{}'! Try: 'colt -help'", argv[i]);\
-      std::exit(1); \
+      return ParseResult::INVALID; \
     } \
+    return ParseResult::PARSED; \
+  } \
+  static void ParseArguments(int argc, const char** argv) noexcept { \
+    auto result = TryParseArguments(argc, argv); \
+    if (result == ParseResult::PRINTED_HELP) \
+      std::exit(0); \
+    if (result == ParseResult::INVALID) \
+      std::exit(1); \
   }
 
 #ifdef COLT_NO_LLVM
@@ -130,8 +159,28 @@ namespace colt::args
   X(NoMessage,     0, false, "no-message", "Deactivates logging of compilation messages.") \
   X(RunMain,       0, false, "run-main", "Run the 'main' function inside the compiler if it exists.") \
   X(NoWait,        0, false, "no-wait", "Specifies that the compiler should exit without user input.") \
+  X(NoBoundsCheck, 0, false, "no-bounds-check", "Deactivates runtime bounds checks of arrays and slices indexing.") \
+  X(DirectSSA,     0, false, "direct-ssa", "Promotes local variables to registers while generating IR, even without optimizations.") \
+  X(DiagFormat,    0, DiagnosticsFormat::TEXT, "diagnostics-format", "Chooses the format of diagnostics: '=text' (default) or '=json' (a JSON object per line).") \
+  X(ErrorLimit,    1, (u64)0, "error-limit", "Stops parsing once <N> errors were reported (0 for no limit).") \
+  X(ParallelParse, 0, false, "parallel-parse", "Parses the declarations first, then the bodies of functions in parallel (functions can then be used before their declaration).") \
+  X(PrintStats,    0, false, "stats", "Prints statistics of the compilation: tokens, expressions and bytes per kind, generated IR and peak memory.") \
+  X(StatsFile,     1, (lstring)nullptr, "json-stats", "Writes the statistics of the compilation to <file> as JSON.") \
+  X(NoDebugInfo,   0, false, "no-debug", "Deactivates generation of debug line tables (DWARF) mapping machine code to the source.") \
+  X(ProfileGenerate, 0, false, "fprofile-generate", "Instruments the code to collect an execution profile, written to 'default_<id>.profraw' when the program exits.") \
+  X(ProfileUse,    1, (lstring)nullptr, "fprofile-use", "Optimizes the code using the merged execution profile <file>.") \
+  X(EmitBitcode,   0, false, "emit-bc", "Writes bitcode containing a ThinLTO summary to the output instead of an object file.") \
+  X(EmitAST,       0, false, "emit-ast", "Writes the serialized AST to the output, which can be compiled ('.cast' input) without parsing.") \
+  X(EmitExecutable, 0, false, "exe", "Links the output into an executable, with the Colt runtime, instead of writing an object file.") \
+  X(Daemon,        1, (lstring)nullptr, "daemon", "Stays resident and serves the compilation requests sent to the local socket <path>.") \
+  X(DaemonConnect, 1, (lstring)nullptr, "connect", "Sends the compilation to the daemon listening on the local socket <path>, and prints its output.") \
   X(FileOut,       1, (lstring)nullptr, "o", "Place the output into <file>.") \
-  X(TargetMachine, 1, (lstring)COLT_DEFAULT_TARGET, "target", "Chooses the target for which to compile.")
+  X(ThinLTOFiles,  1, (lstring)nullptr, "thinlto", "Links the comma separated bitcode <files> using ThinLTO, writing an object file per module.") \
+  X(IncrementalDir, 1, (lstring)nullptr, "incremental", "Caches the optimized bitcode of each function in <dir>, and only recompiles the modified functions.") \
+  X(ImportDir,     1, (lstring)".", "import-dir", "Searches for the imported modules ('<name>.ct') in <dir>.") \
+  X(TargetMachine, 1, (lstring)COLT_DEFAULT_TARGET, "target", "Chooses the target for which to compile.") \
+  X(TargetCPU,     1, (lstring)"generic", "mcpu", "Chooses the CPU for which to compile ('native' for the CPU of the host).") \
+  X(TargetAttr,    1, (lstring)"", "mattr", "Enables (+<feature>) or disables (-<feature>) a comma separated list of CPU features.")
 
 #define COLT_ALIAS_COMMANDS(X) \
   X(NoColor,      "C") \
@@ -0,0 +1,427 @@
+/** @file fn_attributes.cpp
+* Contains definition of functions declared in 'fn_attributes.h'.
+*/
+
+#include "fn_attributes.h"
+
+namespace colt::gen
+{
+  using namespace lang;
+
+  /// @brief A pointer parameter passed as argument to a function defined in the AST
+  struct ParamForward
+  {
+    /// @brief The index of the called function
+    u64 callee;
+    /// @brief The index of the parameter of the called function
+    u64 callee_param;
+    /// @brief The index of the parameter of the caller
+    u64 param;
+  };
+
+  /// @brief The properties of a function computed from its body only
+  struct FnBodyInfo
+  {
+    /// @brief The attributes, which are refined using the callees
+    FnAttributes attr = {};
+    /// @brief The indices of the functions called
+    Vector<u64> callees = {};
+    /// @brief The pointer parameters passed to functions defined in the AST
+    Vector<ParamForward> forwards = {};
+    /// @brief For each parameter, true if memory is accessed through it
+    Vector<bool> accessed = {};
+    /// @brief For each parameter, true if it is written to
+    Vector<bool> reassigned = {};
+    /// @brief True if non-local memory is accessed through something else than a parameter
+    bool other_access = false;
+  };
+
+  /// @brief Visits the body of a function to compute its FnBodyInfo
+  class FnBodyVisitor
+  {
+    /// @brief Returned by param_of if the expression is not a pointer parameter
+    static constexpr i64 NOT_A_PARAM = -1;
+    /// @brief The address of a local variable
+    static constexpr i64 LOCAL_ADDRESS = -2;
+    /// @brief Any address that is not local or a parameter
+    static constexpr i64 UNKNOWN_ADDRESS = -3;
+
+    /// @brief The information to fill
+    FnBodyInfo& info;
+    /// @brief Maps a function declaration to its index
+    const Map<PTR<const FnDeclExpr>, u64>& fn_index;
+    /// @brief The types of the parameters of the function
+    ContiguousView<PTR<const Type>> params_type;
+
+  public:
+    /// @brief Constructor
+    /// @param info The information to fill
+    /// @param fn_index Maps a function declaration to its index
+    /// @param params_type The types of the parameters of the function
+    FnBodyVisitor(FnBodyInfo& info, const Map<PTR<const FnDeclExpr>, u64>& fn_index, ContiguousView<PTR<const Type>> params_type) noexcept
+      : info(info), fn_index(fn_index), params_type(params_type) {}
+
+    /// @brief Visits an expression whose value is used
+    /// @param ptr The expression to visit
+    void visit(PTR<const Expr> ptr) noexcept
+    {
+      switch (ptr->classof())
+      {
+      break; case Expr::EXPR_LITERAL:
+      case Expr::EXPR_BREAK_CONTINUE:
+      case Expr::EXPR_NOP:
+        return;
+      break; case Expr::EXPR_UNARY:
+      {
+        auto unary = as<PTR<const UnaryExpr>>(ptr);
+        //Taking the address of a variable does not access memory
+        if (unary->get_operation() == UnaryOperator::OP_ADDRESSOF)
+        {
+          if (is_a<PtrLoadExpr>(unary->get_child()))
+            visit(as<PTR<const PtrLoadExpr>>(unary->get_child())->get_where());
+        }
+        else
+          visit(unary->get_child());
+      }
+      break; case Expr::EXPR_BINARY:
+        visit(as<PTR<const BinaryExpr>>(ptr)->get_LHS());
+        visit(as<PTR<const BinaryExpr>>(ptr)->get_RHS());
+      break; case Expr::EXPR_CONVERT:
+        visit(as<PTR<const ConvertExpr>>(ptr)->get_child());
+      break; case Expr::EXPR_VAR_DECL:
+        if (as<PTR<const VarDeclExpr>>(ptr)->is_initialized())
+          visit(as<PTR<const VarDeclExpr>>(ptr)->get_value());
+      break; case Expr::EXPR_VAR_READ:
+      {
+        auto var_read = as<PTR<const VarReadExpr>>(ptr);
+        //A global may also be accessed through a pointer parameter
+        if (var_read->is_global())
+        {
+          info.attr.reads_memory = true;
+          info.other_access = true;
+        }
+        //The value of the pointer may outlive the call
+        else if (auto param = param_of(ptr); param != NOT_A_PARAM)
+          info.attr.no_capture[param] = false;
+      }
+      break; case Expr::EXPR_VAR_WRITE:
+      {
+        auto var_write = as<PTR<const VarWriteExpr>>(ptr);
+        visit(var_write->get_value());
+        if (var_write->is_global())
+        {
+          info.attr.writes_memory = true;
+          info.other_access = true;
+        }
+        else if (var_write->get_local_ID() < params_type.get_size())
+          info.reassigned[var_write->get_local_ID()] = true;
+      }
+      break; case Expr::EXPR_FN_CALL:
+        visit_call(as<PTR<const FnCallExpr>>(ptr));
+      break; case Expr::EXPR_FN_RETURN:
+        if (as<PTR<const FnReturnExpr>>(ptr)->get_value())
+          visit(as<PTR<const FnReturnExpr>>(ptr)->get_value());
+      break; case Expr::EXPR_SCOPE:
+        for (auto expr : as<PTR<const ScopeExpr>>(ptr)->get_body_array())
+          visit(expr);
+      break; case Expr::EXPR_CONDITION:
+      {
+        auto condition = as<PTR<const ConditionExpr>>(ptr);
+        visit(condition->get_if_condition());
+        visit(condition->get_if_statement());
+        if (condition->get_else_statement())
+          visit(condition->get_else_statement());
+      }
+      break; case Expr::EXPR_SWITCH:
+      {
+        auto switch_expr = as<PTR<const SwitchExpr>>(ptr);
+        visit(switch_expr->get_value());
+        for (auto body : switch_expr->get_case_bodies())
+          visit(body);
+        if (switch_expr->get_default())
+          visit(switch_expr->get_default());
+      }
+      break; case Expr::EXPR_FOR_LOOP:
+        //The trip count of a for loop is known before entering it
+        visit(as<PTR<const ForLoopExpr>>(ptr)->get_begin());
+        visit(as<PTR<const ForLoopExpr>>(ptr)->get_end());
+        visit(as<PTR<const ForLoopExpr>>(ptr)->get_body());
+      break; case Expr::EXPR_WHILE_LOOP:
+        //A while loop may never terminate
+        info.attr.will_return = false;
+        visit(as<PTR<const WhileLoopExpr>>(ptr)->get_condition());
+        visit(as<PTR<const WhileLoopExpr>>(ptr)->get_body());
+      break; case Expr::EXPR_PTR_LOAD:
+        access(visit_address(as<PTR<const PtrLoadExpr>>(ptr)->get_where()), false);
+      break; case Expr::EXPR_PTR_STORE:
+        visit(as<PTR<const PtrStoreExpr>>(ptr)->get_value());
+        access(visit_address(as<PTR<const PtrStoreExpr>>(ptr)->get_where()), true);
+      break; case Expr::EXPR_INDEX:
+      {
+        //The address of the element may outlive the call
+        auto index = as<PTR<const IndexExpr>>(ptr);
+        visit_index(index);
+        visit_array(index->get_where());
+      }
+      break; case Expr::EXPR_SLICE_LEN:
+        visit(as<PTR<const SliceLenExpr>>(ptr)->get_slice());
+      break; case Expr::EXPR_TO_SLICE:
+        visit_array(as<PTR<const ToSliceExpr>>(ptr)->get_array());
+      break; case Expr::EXPR_VEC_INTRINSIC:
+      {
+        auto intrinsic = as<PTR<const VecIntrinsicExpr>>(ptr);
+        auto args = intrinsic->get_arguments();
+        size_t i = 0;
+        if (intrinsic->get_intrinsic() == VecIntrinsicExpr::VEC_LOAD_MASKED
+          || intrinsic->get_intrinsic() == VecIntrinsicExpr::VEC_STORE_MASKED)
+        {
+          access(visit_address(args[0]),
+            intrinsic->get_intrinsic() == VecIntrinsicExpr::VEC_STORE_MASKED);
+          i = 1;
+        }
+        for (; i < args.get_size(); i++)
+          visit(args[i]);
+      }
+      break; default:
+        colt_unreachable("Visiting invalid expression!");
+      }
+    }
+
+  private:
+    /// @brief Returns the index of the pointer parameter read by an expression
+    /// @param ptr The expression
+    /// @return The index of the parameter, or NOT_A_PARAM if 'ptr' does not read a pointer parameter
+    i64 param_of(PTR<const Expr> ptr) const noexcept
+    {
+      if (!is_a<VarReadExpr>(ptr) || as<PTR<const VarReadExpr>>(ptr)->is_global())
+        return NOT_A_PARAM;
+      u64 local_ID = as<PTR<const VarReadExpr>>(ptr)->get_local_ID();
+      if (local_ID < params_type.get_size() && params_type[local_ID]->is_ptr())
+        return static_cast<i64>(local_ID);
+      return NOT_A_PARAM;
+    }
+
+    /// @brief Registers a memory access
+    /// @param address The result of visit_address
+    /// @param is_write True if the access is a write
+    void access(i64 address, bool is_write) noexcept
+    {
+      if (address == LOCAL_ADDRESS)
+        return;
+      if (is_write)
+        info.attr.writes_memory = true;
+      else
+        info.attr.reads_memory = true;
+      if (address == UNKNOWN_ADDRESS)
+        info.other_access = true;
+      else
+        info.accessed[address] = true;
+    }
+
+    /// @brief Visits an expression whose value is an address that is dereferenced
+    /// @param ptr The address
+    /// @return The index of the parameter on which the address is based, LOCAL_ADDRESS or UNKNOWN_ADDRESS
+    i64 visit_address(PTR<const Expr> ptr) noexcept
+    {
+      if (auto param = param_of(ptr); param != NOT_A_PARAM)
+        return param;
+      if (is_a<IndexExpr>(ptr))
+      {
+        auto index = as<PTR<const IndexExpr>>(ptr);
+        visit_index(index);
+        PTR<const Expr> where = index->get_where();
+        if (where->get_type()->is_slice())
+        {
+          visit(where);
+          return UNKNOWN_ADDRESS;
+        }
+        //Arrays are either variables or loaded through a pointer
+        if (is_a<PtrLoadExpr>(where))
+          return visit_address(as<PTR<const PtrLoadExpr>>(where)->get_where());
+        return as<PTR<const VarReadExpr>>(where)->is_global() ? UNKNOWN_ADDRESS : LOCAL_ADDRESS;
+      }
+      if (is_a<UnaryExpr>(ptr) && as<PTR<const UnaryExpr>>(ptr)->get_operation() == UnaryOperator::OP_ADDRESSOF
+        && is_a<VarReadExpr>(as<PTR<const UnaryExpr>>(ptr)->get_child()))
+        return as<PTR<const VarReadExpr>>(as<PTR<const UnaryExpr>>(ptr)->get_child())->is_global()
+          ? UNKNOWN_ADDRESS : LOCAL_ADDRESS;
+      visit(ptr);
+      return UNKNOWN_ADDRESS;
+    }
+
+    /// @brief Visits the index of an IndexExpr
+    /// @param ptr The index expression
+    void visit_index(PTR<const IndexExpr> ptr) noexcept
+    {
+      //Failing a bounds check traps
+      if (ptr->is_checked())
+        info.attr.will_return = false;
+      visit(ptr->get_index());
+    }
+
+    /// @brief Visits an array or a slice whose address may outlive the call
+    /// @param ptr The array or slice
+    void visit_array(PTR<const Expr> ptr) noexcept
+    {
+      if (ptr->get_type()->is_slice())
+        visit(ptr);
+      else if (is_a<PtrLoadExpr>(ptr))
+        visit(as<PTR<const PtrLoadExpr>>(ptr)->get_where());
+    }
+
+    /// @brief Visits a function call
+    /// @param ptr The function call
+    void visit_call(PTR<const FnCallExpr> ptr) noexcept
+    {
+      auto callee = fn_index.find(ptr->get_fn_decl());
+      auto args = ptr->get_arguments();
+      if (callee == nullptr)
+      {
+        //Nothing is known about extern functions
+        info.attr.reads_memory = true;
+        info.attr.writes_memory = true;
+        info.attr.will_return = false;
+        info.attr.no_sync = false;
+        info.other_access = true;
+        for (auto arg : args)
+          visit(arg);
+        return;
+      }
+
+      info.callees.push_back(callee->second);
+      for (size_t i = 0; i < args.get_size(); i++)
+      {
+        //Whether the pointer is captured depends on the callee
+        if (auto param = param_of(args[i]); param != NOT_A_PARAM)
+          info.forwards.push_back(ParamForward{ callee->second, i, static_cast<u64>(param) });
+        else
+          visit(args[i]);
+      }
+    }
+  };
+
+  /// @brief Sets 'flag' to 'value' if 'cond' is true
+  /// @param flag The flag to modify
+  /// @param value The value to assign
+  /// @param cond The condition
+  /// @return True if 'flag' was modified
+  static bool update_if(bool& flag, bool value, bool cond) noexcept
+  {
+    if (!cond || flag == value)
+      return false;
+    flag = value;
+    return true;
+  }
+
+  FnAttributesInference::FnAttributesInference(const lang::AST& ast) noexcept
+  {
+    Vector<PTR<const FnDefExpr>> fn_defs;
+    for (size_t i = 0; i < ast.expressions.get_size(); i++)
+    {
+      if (!is_a<FnDefExpr>(ast.expressions[i]))
+        continue;
+      auto fn_def = as<PTR<const FnDefExpr>>(ast.expressions[i]);
+      if (fn_def->get_fn_decl()->is_extern() || !fn_def->has_body())
+        continue;
+      fn_index.insert(fn_def->get_fn_decl(), fn_defs.get_size());
+      fn_defs.push_back(fn_def);
+    }
+
+    //Visit the bodies of all functions
+    Vector<FnBodyInfo> infos;
+    for (auto fn_def : fn_defs)
+    {
+      FnBodyInfo info;
+      for (auto type : fn_def->get_params_type())
+      {
+        info.attr.no_capture.push_back(type->is_ptr());
+        info.attr.no_alias.push_back(false);
+        info.accessed.push_back(false);
+        info.reassigned.push_back(false);
+      }
+      FnBodyVisitor{ info, fn_index, fn_def->get_params_type() }.visit(fn_def->get_body());
+      infos.push_back(std::move(info));
+    }
+
+    //A function is recursive if it can reach itself through its callees
+    for (size_t i = 0; i < infos.get_size(); i++)
+    {
+      Vector<bool> visited;
+      for (size_t j = 0; j < infos.get_size(); j++)
+        visited.push_back(false);
+      Vector<u64> to_visit;
+      for (auto callee : infos[i].callees.to_view())
+        to_visit.push_back(callee);
+
+      while (!to_visit.is_empty() && infos[i].attr.no_recurse)
+      {
+        u64 callee = to_visit.get_back();
+        to_visit.pop_back();
+        if (callee == i)
+        {
+          infos[i].attr.no_recurse = false;
+          infos[i].attr.will_return = false;
+        }
+        if (visited[callee])
+          continue;
+        visited[callee] = true;
+        for (auto next : infos[callee].callees.to_view())
+          to_visit.push_back(next);
+      }
+    }
+
+    //Propagate the properties of the callees to the callers until
+    //a fixed point is reached: each flag can only change once.
+    bool changed = true;
+    while (changed)
+    {
+      changed = false;
+      for (size_t i = 0; i < infos.get_size(); i++)
+      {
+        FnBodyInfo& info = infos[i];
+        for (auto callee : info.callees.to_view())
+        {
+          const FnAttributes& callee_attr = infos[callee].attr;
+          changed |= update_if(info.attr.reads_memory, true, callee_attr.reads_memory);
+          changed |= update_if(info.attr.writes_memory, true, callee_attr.writes_memory);
+          changed |= update_if(info.attr.will_return, false, !callee_attr.will_return);
+          changed |= update_if(info.attr.no_sync, false, !callee_attr.no_sync);
+        }
+        for (auto forward : info.forwards.to_view())
+          changed |= update_if(info.attr.no_capture[forward.param], false,
+            !infos[forward.callee].attr.no_capture[forward.callee_param]);
+      }
+    }
+
+    //A parameter is noalias if the function only accesses memory through it,
+    //and only calls functions that do not access memory.
+    for (size_t i = 0; i < infos.get_size(); i++)
+    {
+      FnBodyInfo& info = infos[i];
+      size_t accessed_count = 0;
+      for (size_t j = 0; j < info.accessed.get_size(); j++)
+      {
+        //The parameter may not point to its initial value
+        if (info.accessed[j] && info.reassigned[j])
+          info.other_access = true;
+        accessed_count += info.accessed[j];
+      }
+      for (auto callee : info.callees.to_view())
+        info.other_access |= infos[callee].attr.reads_memory || infos[callee].attr.writes_memory;
+
+      if (info.other_access || accessed_count != 1)
+        continue;
+      for (size_t j = 0; j < info.accessed.get_size(); j++)
+        info.attr.no_alias[j] = info.accessed[j];
+    }
+
+    for (size_t i = 0; i < infos.get_size(); i++)
+      attributes.push_back(std::move(infos[i].attr));
+  }
+
+  PTR<const FnAttributes> FnAttributesInference::find(PTR<const lang::FnDeclExpr> decl) const noexcept
+  {
+    if (auto index = fn_index.find(decl); index != nullptr)
+      return &attributes[index->second];
+    return nullptr;
+  }
+}
@@ -0,0 +1,61 @@
+/** @file fn_attributes.h
+* Contains the inference of function attributes from the AST.
+* The attributes are computed for all the functions of an AST at once,
+* as the properties of a function depend on the functions it calls.
+*/
+
+#ifndef HG_COLT_FN_ATTRIBUTES
+#define HG_COLT_FN_ATTRIBUTES
+
+#include <util/colt_pch.h>
+#include <ast/colt_ast.h>
+
+namespace colt::gen
+{
+  /// @brief The properties of a function definition, that can be
+  /// translated to LLVM function and parameter attributes.
+  struct FnAttributes
+  {
+    /// @brief True if the function reads memory that is not local to it (readnone if false)
+    bool reads_memory = false;
+    /// @brief True if the function writes memory that is not local to it (readonly if false)
+    bool writes_memory = false;
+    /// @brief True if the function always returns (no unbounded loops, recursion or traps)
+    bool will_return = true;
+    /// @brief True if the function cannot call itself, directly or not
+    bool no_recurse = true;
+    /// @brief True if the function does not call unknown (extern) functions (nosync and nofree)
+    bool no_sync = true;
+    /// @brief For each parameter, true if it is a pointer that does not outlive the call
+    Vector<bool> no_capture = {};
+    /// @brief For each parameter, true if it is a pointer through which all the
+    /// memory accessed by the function is accessed
+    Vector<bool> no_alias = {};
+  };
+
+  /// @brief Infers the attributes of all the functions defined in an AST
+  class FnAttributesInference
+  {
+    /// @brief The attributes of each function definition
+    Vector<FnAttributes> attributes = {};
+    /// @brief Maps a function declaration to its index in 'attributes'
+    Map<PTR<const lang::FnDeclExpr>, u64> fn_index = {};
+
+  public:
+    /// @brief No default constructor
+    FnAttributesInference() = delete;
+    /// @brief No default copy constructor
+    FnAttributesInference(const FnAttributesInference&) = delete;
+
+    /// @brief Infers the attributes of all the functions defined in 'ast'
+    /// @param ast The AST whose functions to analyze
+    FnAttributesInference(const lang::AST& ast) noexcept;
+
+    /// @brief Returns the attributes of a function
+    /// @param decl The declaration of the function
+    /// @return The attributes, or nullptr if the function is not defined in the AST (extern)
+    PTR<const FnAttributes> find(PTR<const lang::FnDeclExpr> decl) const noexcept;
+  };
+}
+
+#endif //!HG_COLT_FN_ATTRIBUTES
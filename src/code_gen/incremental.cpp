@@ -0,0 +1,492 @@
+/** @file incremental.cpp
+* Contains definition of functions declared in 'incremental.h'.
+*/
+
+#include "incremental.h"
+#include <code_gen/llvm_ir_gen.h>
+
+#ifndef COLT_NO_LLVM
+
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+namespace colt::gen
+{
+  using namespace lang;
+
+  /// @brief Hashes bytes using FNV-1a
+  /// @param view The bytes to hash
+  /// @param hash The hash to continue
+  /// @return The hash
+  static u64 HashBytes(StringView view, u64 hash = 0xcbf29ce484222325ULL) noexcept
+  {
+    for (size_t i = 0; i < view.get_size(); i++)
+    {
+      hash ^= static_cast<u8>(view[i]);
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  /// @brief Mixes the bits of a hash, so that hashes can be summed
+  /// @param hash The hash to mix
+  /// @return The mixed hash
+  static u64 MixHash(u64 hash) noexcept
+  {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  /// @brief Hashes the content of a file
+  /// @param path The path of the file
+  /// @param hash The hash to continue
+  /// @return The hash ('hash' mixed with a marker if the file cannot be read)
+  static u64 HashFile(const char* path, u64 hash) noexcept
+  {
+    std::ifstream file{ path, std::ios::binary };
+    if (!file)
+      return MixHash(hash + 1);
+    char buffer[4096];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() != 0)
+      hash = HashBytes(StringView{ buffer, buffer + file.gcount() }, hash);
+    return hash;
+  }
+
+  /// @brief Hashes the options of the compiler that change the generated code
+  /// @return The hash
+  static u64 HashConfig() noexcept
+  {
+    u64 hash = HashBytes(COLT_VERSION_STRING);
+    hash = HashBytes(COLT_CONFIG_STRING, hash);
+    hash = HashBytes(args::TargetMachine, hash);
+    hash = HashBytes(args::TargetCPU, hash);
+    hash = HashBytes(args::TargetAttr, hash);
+    //A profile is usually merged again at the same path: its content is hashed
+    if (args::ProfileUse)
+      hash = HashFile(args::ProfileUse, hash);
+    const bool flags[] = {
+      args::NoBoundsCheck, args::NoDebugInfo, args::DirectSSA,
+      args::EmitBitcode, args::ProfileUse != nullptr, args::ProfileGenerate
+    };
+    for (auto flag : flags)
+      hash = MixHash(hash + flag);
+    return hash;
+  }
+
+  /// @brief The dependencies of a function, computed from its body only
+  struct FnDependencies
+  {
+    /// @brief The indices of the functions (with bodies) called
+    Vector<u64> callees = {};
+    /// @brief Sum of the hashes of the extern functions called and globals used
+    u64 external_hash = 0;
+  };
+
+  /// @brief Visits the body of a function to compute its FnDependencies
+  class FnDependencyVisitor
+  {
+    /// @brief The dependencies to fill
+    FnDependencies& deps;
+    /// @brief Maps a function declaration to its index
+    const Map<PTR<const FnDeclExpr>, u64>& fn_index;
+    /// @brief Maps the symbol of a global variable to the hash of its declaration
+    const Map<SymbolID, u64>& global_hash;
+
+  public:
+    /// @brief Constructor
+    /// @param deps The dependencies to fill
+    /// @param fn_index Maps a function declaration to its index
+    /// @param global_hash Maps the symbol of a global variable to the hash of its declaration
+    FnDependencyVisitor(FnDependencies& deps, const Map<PTR<const FnDeclExpr>, u64>& fn_index, const Map<SymbolID, u64>& global_hash) noexcept
+      : deps(deps), fn_index(fn_index), global_hash(global_hash) {}
+
+    /// @brief Visits an expression
+    /// @param ptr The expression to visit
+    void visit(PTR<const Expr> ptr) noexcept
+    {
+      switch (ptr->classof())
+      {
+      break; case Expr::EXPR_LITERAL:
+      case Expr::EXPR_BREAK_CONTINUE:
+      case Expr::EXPR_NOP:
+        return;
+      break; case Expr::EXPR_UNARY:
+        visit(as<PTR<const UnaryExpr>>(ptr)->get_child());
+      break; case Expr::EXPR_BINARY:
+        visit(as<PTR<const BinaryExpr>>(ptr)->get_LHS());
+        visit(as<PTR<const BinaryExpr>>(ptr)->get_RHS());
+      break; case Expr::EXPR_CONVERT:
+        visit(as<PTR<const ConvertExpr>>(ptr)->get_child());
+      break; case Expr::EXPR_VAR_DECL:
+        if (as<PTR<const VarDeclExpr>>(ptr)->is_initialized())
+          visit(as<PTR<const VarDeclExpr>>(ptr)->get_value());
+      break; case Expr::EXPR_VAR_READ:
+        if (as<PTR<const VarReadExpr>>(ptr)->is_global())
+          use_global(as<PTR<const VarReadExpr>>(ptr)->get_symbol());
+      break; case Expr::EXPR_VAR_WRITE:
+      {
+        auto var_write = as<PTR<const VarWriteExpr>>(ptr);
+        visit(var_write->get_value());
+        if (var_write->is_global())
+          use_global(var_write->get_symbol());
+      }
+      break; case Expr::EXPR_FN_CALL:
+      {
+        auto call = as<PTR<const FnCallExpr>>(ptr);
+        for (auto arg : call->get_arguments())
+          visit(arg);
+        if (auto callee = fn_index.find(call->get_fn_decl()); callee != nullptr)
+          deps.callees.push_back(callee->second);
+        else
+        {
+          //Extern and imported functions are identified by their signature
+          auto decl = call->get_fn_decl();
+          deps.external_hash += MixHash(HashBytes(decl->get_type()->get_name(), HashBytes(StringView{ mangle(decl) })));
+        }
+      }
+      break; case Expr::EXPR_FN_RETURN:
+        if (as<PTR<const FnReturnExpr>>(ptr)->get_value())
+          visit(as<PTR<const FnReturnExpr>>(ptr)->get_value());
+      break; case Expr::EXPR_SCOPE:
+        for (auto expr : as<PTR<const ScopeExpr>>(ptr)->get_body_array())
+          visit(expr);
+      break; case Expr::EXPR_CONDITION:
+      {
+        auto condition = as<PTR<const ConditionExpr>>(ptr);
+        visit(condition->get_if_condition());
+        visit(condition->get_if_statement());
+        if (condition->get_else_statement())
+          visit(condition->get_else_statement());
+      }
+      break; case Expr::EXPR_SWITCH:
+      {
+        auto switch_expr = as<PTR<const SwitchExpr>>(ptr);
+        visit(switch_expr->get_value());
+        for (auto body : switch_expr->get_case_bodies())
+          visit(body);
+        if (switch_expr->get_default())
+          visit(switch_expr->get_default());
+      }
+      break; case Expr::EXPR_FOR_LOOP:
+        visit(as<PTR<const ForLoopExpr>>(ptr)->get_begin());
+        visit(as<PTR<const ForLoopExpr>>(ptr)->get_end());
+        visit(as<PTR<const ForLoopExpr>>(ptr)->get_body());
+      break; case Expr::EXPR_WHILE_LOOP:
+        visit(as<PTR<const WhileLoopExpr>>(ptr)->get_condition());
+        visit(as<PTR<const WhileLoopExpr>>(ptr)->get_body());
+      break; case Expr::EXPR_PTR_LOAD:
+        visit(as<PTR<const PtrLoadExpr>>(ptr)->get_where());
+      break; case Expr::EXPR_PTR_STORE:
+        visit(as<PTR<const PtrStoreExpr>>(ptr)->get_value());
+        visit(as<PTR<const PtrStoreExpr>>(ptr)->get_where());
+      break; case Expr::EXPR_INDEX:
+        visit(as<PTR<const IndexExpr>>(ptr)->get_where());
+        visit(as<PTR<const IndexExpr>>(ptr)->get_index());
+      break; case Expr::EXPR_SLICE_LEN:
+        visit(as<PTR<const SliceLenExpr>>(ptr)->get_slice());
+      break; case Expr::EXPR_TO_SLICE:
+        visit(as<PTR<const ToSliceExpr>>(ptr)->get_array());
+      break; case Expr::EXPR_VEC_INTRINSIC:
+        for (auto arg : as<PTR<const VecIntrinsicExpr>>(ptr)->get_arguments())
+          visit(arg);
+      break; default:
+        colt_unreachable("Visiting invalid expression!");
+      }
+    }
+
+  private:
+    /// @brief Registers a read or write to a global variable
+    /// @param symbol The symbol of the global variable
+    void use_global(SymbolID symbol) noexcept
+    {
+      if (auto hash = global_hash.find(symbol); hash != nullptr)
+        deps.external_hash += hash->second;
+    }
+  };
+
+  /// @brief Collects the globals used by a function: the functions it calls, the
+  /// globals it uses, and the ones used by the internal globals (runtime and
+  /// string literals) it uses, which must be copied with it
+  /// @param fn The function
+  /// @return The globals used by the function (including itself)
+  static llvm::SmallVector<llvm::GlobalValue*, 16> CollectUsedGlobals(llvm::Function* fn) noexcept
+  {
+    using namespace llvm;
+    SmallVector<GlobalValue*, 16> globals;
+    SmallPtrSet<const Value*, 32> visited;
+    SmallVector<Value*, 32> to_visit;
+    to_visit.push_back(fn);
+    while (!to_visit.empty())
+    {
+      auto value = to_visit.pop_back_val();
+      if (!visited.insert(value).second)
+        continue;
+      if (auto gv = dyn_cast<GlobalValue>(value))
+      {
+        globals.push_back(gv);
+        //Other external globals are only declared
+        if (gv != fn && !gv->hasLocalLinkage())
+          continue;
+        if (auto var = dyn_cast<GlobalVariable>(gv); var && var->hasInitializer())
+          to_visit.push_back(var->getInitializer());
+        else if (auto local_fn = dyn_cast<Function>(gv))
+        {
+          for (auto& inst : instructions(local_fn))
+            for (auto& op : inst.operands())
+              if (isa<Constant>(op.get()))
+                to_visit.push_back(op.get());
+        }
+      }
+      else if (auto constant = dyn_cast<Constant>(value))
+      {
+        for (auto& op : constant->operands())
+          to_visit.push_back(op.get());
+      }
+    }
+    return globals;
+  }
+
+  /// @brief Copies a function to its own module, in which the globals it uses
+  /// are declared (or copied if they are internal).
+  /// Only the globals used by the function are visited, so that extracting
+  /// all the functions of a module is linear in its size.
+  /// @param module The module containing the function
+  /// @param fn The function to copy
+  /// @return The module containing the copy of the function
+  static std::unique_ptr<llvm::Module> ExtractFunction(const llvm::Module& module, llvm::Function* fn) noexcept
+  {
+    using namespace llvm;
+    auto fn_module = std::make_unique<Module>(module.getModuleIdentifier(), module.getContext());
+    fn_module->setSourceFileName(module.getSourceFileName());
+    fn_module->setDataLayout(module.getDataLayout());
+    fn_module->setTargetTriple(module.getTargetTriple());
+
+    //All the globals are created before copying bodies and initializers, as they may use each other
+    auto globals = CollectUsedGlobals(fn);
+    ValueToValueMapTy value_map;
+    for (auto gv : globals)
+    {
+      bool is_copied = gv == fn || gv->hasLocalLinkage();
+      auto linkage = is_copied || gv->isDeclaration() ? gv->getLinkage() : GlobalValue::ExternalLinkage;
+      if (auto global_fn = dyn_cast<Function>(gv))
+      {
+        auto copy = Function::Create(global_fn->getFunctionType(), linkage,
+          global_fn->getAddressSpace(), global_fn->getName(), fn_module.get());
+        copy->copyAttributesFrom(global_fn);
+        value_map[global_fn] = copy;
+      }
+      else if (auto var = dyn_cast<GlobalVariable>(gv))
+      {
+        auto copy = new GlobalVariable(*fn_module, var->getValueType(), var->isConstant(), linkage,
+          nullptr, var->getName(), nullptr, var->getThreadLocalMode(), var->getAddressSpace());
+        copy->copyAttributesFrom(var);
+        value_map[var] = copy;
+      }
+      else
+        colt_unreachable("Aliases are not generated!");
+    }
+    for (auto gv : globals)
+    {
+      if (gv != fn && !gv->hasLocalLinkage())
+        continue;
+      if (auto var = dyn_cast<GlobalVariable>(gv); var && var->hasInitializer())
+        cast<GlobalVariable>(value_map[var])->setInitializer(MapValue(var->getInitializer(), value_map));
+      else if (auto global_fn = dyn_cast<Function>(gv); global_fn && !global_fn->isDeclaration())
+      {
+        auto copy = cast<Function>(value_map[global_fn]);
+        auto arg = copy->arg_begin();
+        for (auto& global_arg : global_fn->args())
+        {
+          arg->setName(global_arg.getName());
+          value_map[&global_arg] = &*arg++;
+        }
+        SmallVector<ReturnInst*, 8> returns;
+        CloneFunctionInto(copy, global_fn, value_map, CloneFunctionChangeType::DifferentModule, returns);
+      }
+    }
+
+    //The debug information is only valid with the flags of the module
+    if (auto flags = module.getModuleFlagsMetadata())
+    {
+      auto fn_flags = fn_module->getOrInsertModuleFlagsMetadata();
+      for (auto flag : flags->operands())
+        fn_flags->addOperand(MapMetadata(flag, value_map));
+    }
+    return fn_module;
+  }
+
+  IncrementalCache::IncrementalCache(const lang::AST& ast, const char* directory) noexcept
+  {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    //Each source file owns a subdirectory, so that updating the cache
+    //of a file does not remove the bitcode of the other files
+    const char* source_path = args::FileIn ? args::FileIn : "<stdin>";
+    auto absolute = fs::absolute(source_path, ec).string();
+    this->directory = (fs::path(directory) / fmt::format("{:016x}",
+      HashBytes(StringView{ absolute.data(), absolute.data() + absolute.size() }))).string();
+    fs::create_directories(this->directory, ec);
+
+    //The declaration of a global (type and initial value) is part of the key of its users
+    Map<SymbolID, u64> global_hash;
+    auto add_global = [&](PTR<const Expr> expr)
+    {
+      if (auto var = dyn_cast<PTR<const VarDeclExpr>>(expr); var && var->is_global())
+        global_hash.insert(var->get_symbol(),
+          MixHash(HashBytes(ast.ctx.to_src_info(var->get_src_loc()).expression, HashBytes(var->get_type()->get_name()))));
+    };
+    for (size_t i = 0; i < ast.imports.get_size(); i++)
+      add_global(ast.imports[i]);
+    for (size_t i = 0; i < ast.expressions.get_size(); i++)
+      add_global(ast.expressions[i]);
+
+    Vector<PTR<const FnDefExpr>> fn_defs;
+    Map<PTR<const FnDeclExpr>, u64> def_index;
+    for (size_t i = 0; i < ast.expressions.get_size(); i++)
+    {
+      auto fn_def = dyn_cast<PTR<const FnDefExpr>>(ast.expressions[i]);
+      if (fn_def == nullptr || fn_def->get_fn_decl()->is_extern() || !fn_def->has_body())
+        continue;
+      def_index.insert(fn_def->get_fn_decl(), fn_defs.get_size());
+      fn_defs.push_back(fn_def);
+    }
+
+    //The key of a function depends on its source code and on its dependencies,
+    //as the optimizer uses their bodies (inlining) and attributes
+    Vector<FnDependencies> deps;
+    Vector<u64> own_hash;
+    Vector<bool> has_source;
+    for (auto fn_def : fn_defs)
+    {
+      FnDependencies dep;
+      FnDependencyVisitor{ dep, def_index, global_hash }.visit(fn_def->get_body());
+      deps.push_back(std::move(dep));
+      //The source code of loaded ASTs is not available
+      StringView source = ast.ctx.to_src_info(fn_def->get_src_loc()).expression;
+      has_source.push_back(source.get_size() != 0);
+      //The lines are part of the generated code (debug information, bounds checks)
+      u64 hash = HashBytes(source, HashBytes(StringView{ mangle(fn_def->get_fn_decl()) }));
+      own_hash.push_back(MixHash(hash + fn_def->get_src_loc().line_begin));
+    }
+
+    u64 config_hash = HashConfig();
+    //The debug information contains the path of the source file
+    if (!args::NoDebugInfo)
+      config_hash = MixHash(HashBytes(source_path, config_hash));
+    Vector<bool> visited;
+    Vector<u64> to_visit;
+    for (size_t i = 0; i < fn_defs.get_size(); i++)
+    {
+      //'main' also contains the initialization of global variables
+      if (fn_defs[i]->is_main())
+        continue;
+
+      visited.clear();
+      for (size_t j = 0; j < fn_defs.get_size(); j++)
+        visited.push_back(false);
+      to_visit.clear();
+      to_visit.push_back(i);
+      visited[i] = true;
+
+      //The sum of the hashes does not depend on the order of traversal
+      u64 key = config_hash;
+      bool cacheable = true;
+      while (!to_visit.is_empty())
+      {
+        u64 current = to_visit.get_back();
+        to_visit.pop_back();
+        cacheable &= has_source[current];
+        key += own_hash[current] + deps[current].external_hash;
+        for (auto callee : deps[current].callees)
+        {
+          if (visited[callee])
+            continue;
+          visited[callee] = true;
+          to_visit.push_back(callee);
+        }
+      }
+      if (!cacheable)
+        continue;
+
+      key = MixHash(key ^ own_hash[i]);
+      auto path = (fs::path(this->directory) / fmt::format("{:016x}.bc", key)).string();
+      bool exists = fs::exists(path, ec);
+      cached_count += exists;
+      fn_index.insert(fn_defs[i]->get_fn_decl(), functions.get_size());
+      functions.push_back(CachedFn{ fn_defs[i]->get_fn_decl(), std::move(path), exists });
+    }
+  }
+
+  bool IncrementalCache::is_cached(PTR<const lang::FnDeclExpr> decl) const noexcept
+  {
+    if (auto index = fn_index.find(decl); index != nullptr)
+      return functions[index->second].is_cached;
+    return false;
+  }
+
+  Expected<bool, const char*> IncrementalCache::update(llvm::Module& module) const noexcept
+  {
+    using namespace llvm;
+
+    //Save the functions that were generated, each in its own module
+    for (size_t i = 0; i < functions.get_size(); i++)
+    {
+      const CachedFn& cached = functions[i];
+      if (cached.is_cached)
+        continue;
+      auto fn = module.getFunction(ToStringRef(mangle(cached.decl)));
+      if (fn == nullptr || fn->isDeclaration())
+        continue;
+      auto fn_module = ExtractFunction(module, fn);
+
+      std::error_code ec;
+      raw_fd_ostream os(cached.path, ec, sys::fs::OF_None);
+      if (ec)
+        return { Error, "Could not write the bitcode of a function to the incremental cache!" };
+      WriteBitcodeToFile(*fn_module, os);
+    }
+
+    //Link the cached functions
+    for (size_t i = 0; i < functions.get_size(); i++)
+    {
+      const CachedFn& cached = functions[i];
+      if (!cached.is_cached)
+        continue;
+      auto buffer = MemoryBuffer::getFile(cached.path);
+      if (!buffer)
+        return { Error, "Could not read the bitcode of a function from the incremental cache!" };
+      auto fn_module = parseBitcodeFile(buffer.get()->getMemBufferRef(), module.getContext());
+      if (!fn_module)
+      {
+        consumeError(fn_module.takeError());
+        return { Error, "Invalid bitcode in the incremental cache!" };
+      }
+      if (Linker::linkModules(module, std::move(fn_module.get())))
+        return { Error, "Could not link the bitcode of a function from the incremental cache!" };
+    }
+
+    //Remove the bitcode of functions that were modified or removed
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    for (auto& entry : fs::directory_iterator(directory, ec))
+    {
+      //Only files named '<16 hex digits>.bc' belong to the cache
+      auto name = entry.path().filename().string();
+      if (entry.path().extension() != ".bc" || name.size() != 19)
+        continue;
+      bool is_used = false;
+      for (size_t i = 0; i < functions.get_size() && !is_used; i++)
+        is_used = fs::path(functions[i].path).filename().string() == name;
+      if (!is_used)
+        fs::remove(entry.path(), ec);
+    }
+    return true;
+  }
+}
+
+#endif //!COLT_NO_LLVM
@@ -0,0 +1,83 @@
+/** @file incremental.h
+* Contains the cache used for function-granular incremental compilation.
+* Each function definition is identified by a key, which is the hash of
+* its source code and line, of the functions it calls and of the global variables
+* it uses (transitively), and of the options of the compiler (and of the path of
+* the source file if debug information is generated).
+* The optimized bitcode of each function is saved in the subdirectory of the
+* source file (the hash of its absolute path) as '<key>.bc': when compiling again,
+* only the functions whose key changed are generated and optimized, and the
+* bitcode of the others is linked in.
+*/
+
+#ifndef HG_COLT_INCREMENTAL
+#define HG_COLT_INCREMENTAL
+
+#include <util/colt_pch.h>
+#include <ast/colt_ast.h>
+
+namespace llvm
+{
+  class Module;
+}
+
+namespace colt::gen
+{
+  /// @brief The cache of the optimized bitcode of the functions of an AST
+  class IncrementalCache
+  {
+    /// @brief A function whose bitcode can be cached
+    struct CachedFn
+    {
+      /// @brief The declaration of the function
+      PTR<const lang::FnDeclExpr> decl;
+      /// @brief The path of the bitcode of the function
+      std::string path;
+      /// @brief True if the bitcode exists (and the function does not need to be generated)
+      bool is_cached;
+    };
+
+    /// @brief The directory containing the bitcode of the functions of the source file
+    std::string directory;
+    /// @brief The functions whose bitcode can be cached
+    Vector<CachedFn> functions = {};
+    /// @brief Maps a function declaration to its index in 'functions'
+    Map<PTR<const lang::FnDeclExpr>, u64> fn_index = {};
+    /// @brief The count of functions whose bitcode exists
+    u64 cached_count = 0;
+
+  public:
+    /// @brief No default constructor
+    IncrementalCache() = delete;
+    /// @brief No default copy constructor
+    IncrementalCache(const IncrementalCache&) = delete;
+
+    /// @brief Computes the keys of the functions of 'ast', and checks which are cached
+    /// @param ast The AST whose functions to cache (parsed from '-file')
+    /// @param directory The directory of the cache (created if it does not exist)
+    IncrementalCache(const lang::AST& ast, const char* directory) noexcept;
+
+    /// @brief Check if the bitcode of a function is cached, in which case
+    /// only its declaration needs to be generated
+    /// @param decl The declaration of the function
+    /// @return True if cached
+    bool is_cached(PTR<const lang::FnDeclExpr> decl) const noexcept;
+
+    /// @brief Returns the count of functions whose bitcode was found
+    /// @return The count of functions reused
+    u64 get_cached_count() const noexcept { return cached_count; }
+    /// @brief Returns the count of functions that can be cached
+    /// @return The count of functions ('main' and functions of loaded ASTs are never cached)
+    u64 get_fn_count() const noexcept { return functions.get_size(); }
+
+    /// @brief Saves the bitcode of the functions generated in an optimized
+    /// module, then links the bitcode of the cached functions into it.
+    /// The bitcode of functions that are no longer part of the AST is removed
+    /// (the bitcode of other source files is left untouched).
+    /// @param module The optimized module
+    /// @return True if no errors, or a const char* representing the error
+    Expected<bool, const char*> update(llvm::Module& module) const noexcept;
+  };
+}
+
+#endif //!HG_COLT_INCREMENTAL
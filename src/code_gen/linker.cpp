@@ -0,0 +1,101 @@
+/** @file linker.cpp
+* Contains definition of functions declared in 'linker.h'.
+*/
+
+#include "linker.h"
+
+#ifdef COLT_LLD
+  #include <lld/Common/Driver.h>
+  #include <llvm/Support/raw_ostream.h>
+  #include <llvm/Support/FileSystem.h>
+  #include <llvm/Support/Path.h>
+  //Generated by CMake from 'resources/cmake/cmake_link_config.in'
+  #include <colt_link_config.h>
+#endif //COLT_LLD
+
+namespace colt::gen
+{
+#ifdef COLT_LLD
+  /// @brief Finds a runtime library, relative to the directory of the compiler:
+  /// in 'COLT_INSTALL_LIBRARY_DIR' if installed, else next to it (build tree)
+  /// @param name The file name of the library
+  /// @return The path of the library, or an empty string if it was not found
+  static std::string FindRuntimeLibrary(llvm::StringRef name) noexcept
+  {
+    auto executable = llvm::sys::fs::getMainExecutable(nullptr, reinterpret_cast<void*>(&FindRuntimeLibrary));
+    llvm::StringRef directory = llvm::sys::path::parent_path(executable);
+    for (auto relative : { COLT_INSTALL_LIBRARY_DIR, "." })
+    {
+      llvm::SmallString<256> path = directory;
+      llvm::sys::path::append(path, relative, name);
+      llvm::sys::path::remove_dots(path, true);
+      if (llvm::sys::fs::exists(path))
+        return std::string(path);
+    }
+    return {};
+  }
+#endif //COLT_LLD
+
+  Expected<bool, const char*> LinkExecutable(const char* object, const Vector<String>& modules, const char* output) noexcept
+  {
+#ifdef COLT_LLD
+    auto runtime_library = FindRuntimeLibrary(COLT_RUNTIME_LIBRARY_NAME);
+    auto fmt_library = FindRuntimeLibrary(COLT_FMT_LIBRARY_NAME);
+    if (runtime_library.empty() || fmt_library.empty())
+      return "Could not find the runtime libraries in the directory of the compiler!";
+
+  #if defined(COLT_WINDOWS)
+    std::string out = std::string("/out:") + output;
+    std::vector<const char*> args = {
+      "lld-link", "/nologo", out.c_str(), object
+    };
+  #elif defined(COLT_APPLE)
+    std::vector<const char*> args = {
+      "ld64.lld", COLT_LINK_ARGS_BEFORE
+      "-o", output, object
+    };
+  #else
+    std::vector<const char*> args = {
+      "ld.lld", COLT_LINK_ARGS_BEFORE
+      "-o", output, object
+    };
+  #endif
+    //The object files of the imported modules
+    for (size_t i = 0; i < modules.get_size(); i++)
+      args.push_back(modules[i].c_str());
+    //Instrumented code requires the profile runtime, whose registration
+    //(which writes the profile at exit) is only linked if referenced
+    if (args::ProfileGenerate)
+    {
+  #ifndef COLT_PROFILE_LIBRARY
+      return "Colt was built without the LLVM profile runtime: instrumented executables cannot be linked!";
+  #elif defined(COLT_WINDOWS)
+      args.insert(args.end(), { "/include:__llvm_profile_runtime", COLT_PROFILE_LIBRARY });
+  #elif defined(COLT_APPLE)
+      args.insert(args.end(), { "-u", "___llvm_profile_runtime", COLT_PROFILE_LIBRARY });
+  #else
+      args.insert(args.end(), { "-u", "__llvm_profile_runtime", COLT_PROFILE_LIBRARY });
+  #endif
+    }
+    args.insert(args.end(), {
+      runtime_library.c_str(), fmt_library.c_str(),
+      COLT_LINK_ARGS_AFTER
+    });
+
+    //With JSON diagnostics, 'stdout' only contains the JSON records
+    auto& stdout_stream = args::DiagFormat == args::DiagnosticsFormat::JSON ? llvm::errs() : llvm::outs();
+  #if defined(COLT_WINDOWS)
+    bool success = lld::coff::link(args, stdout_stream, llvm::errs(), false, false);
+  #elif defined(COLT_APPLE)
+    bool success = lld::macho::link(args, stdout_stream, llvm::errs(), false, false);
+  #else
+    bool success = lld::elf::link(args, stdout_stream, llvm::errs(), false, false);
+  #endif
+    if (!success)
+      return "Could not link the executable!";
+    return true;
+#else
+    return "Colt was built without LLD: executables cannot be produced!";
+#endif //COLT_LLD
+  }
+}
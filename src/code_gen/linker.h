@@ -0,0 +1,23 @@
+/** @file linker.h
+* Contains utilities for linking object files to executables in-process, using LLD.
+*/
+
+#ifndef HG_COLT_LINKER
+#define HG_COLT_LINKER
+
+#include <util/colt_pch.h>
+
+namespace colt::gen
+{
+  /// @brief Links an object file produced by Colt into an executable.
+  /// The Colt runtime and the standard libraries are linked in,
+  /// so that the resulting executable can be run directly.
+  /// Linking is done by LLD, in the process of the compiler.
+  /// @param object The path to the object file
+  /// @param modules The paths to the object files of the imported modules
+  /// @param output The path of the executable to create
+  /// @return True if no errors, or a const char* representing the error
+  Expected<bool, const char*> LinkExecutable(const char* object, const Vector<String>& modules, const char* output) noexcept;
+}
+
+#endif //!HG_COLT_LINKER
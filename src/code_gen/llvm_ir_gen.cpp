@@ -5,6 +5,11 @@
 #include <code_gen/llvm_ir_gen.h>
 #include <ast/colt_ast.h>
 
+#ifdef COLT_RUNTIME_BITCODE
+  //Generated by CMake from 'interpreter/fn_exports.cpp'
+  #include <colt_runtime_bc.h>
+#endif
+
 #ifndef COLT_NO_LLVM
 
 /// @brief Contains code generators
@@ -17,7 +22,51 @@ namespace colt::gen
     return StringRef(view.get_data(), view.get_size());
   }
 
-  Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast) noexcept
+  /// @brief Returns the type of the elements of a vector, or 'type' if not a vector
+  /// @param type The built-in or vector type
+  /// @return The built-in type on which operations are done
+  static PTR<const lang::BuiltInType> scalar_type_of(PTR<const lang::Type> type) noexcept
+  {
+    if (type->is_vec())
+      return as<PTR<const lang::VecType>>(type)->get_type_of();
+    return as<PTR<const lang::BuiltInType>>(type);
+  }
+
+  std::string GetTargetCPU() noexcept
+  {
+    if (StringRef(args::TargetCPU) == "native")
+      return sys::getHostCPUName().str();
+    return args::TargetCPU;
+  }
+
+  std::string GetTargetFeatures() noexcept
+  {
+    std::string features;
+    if (StringRef(args::TargetCPU) == "native")
+    {
+      StringMap<bool> host_features;
+      if (sys::getHostCPUFeatures(host_features))
+      {
+        for (auto& feature : host_features)
+        {
+          if (!features.empty())
+            features += ',';
+          features += feature.second ? '+' : '-';
+          features += feature.first().str();
+        }
+      }
+    }
+    //Features specified by the user override the ones of the host
+    if (!StringRef(args::TargetAttr).empty())
+    {
+      if (!features.empty())
+        features += ',';
+      features += args::TargetAttr;
+    }
+    return features;
+  }
+
+  Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast, PTR<const IncrementalCache> cache) noexcept
   {
     std::string target_str = args::TargetMachine;
     if (target_str == "no-target")
@@ -28,23 +77,102 @@ namespace colt::gen
     auto Target = llvm::TargetRegistry::lookupTarget(target_str, error);
     if (!Target)
       return { Error, error };
-    ir.target_machine = Target->createTargetMachine(target_str, "generic", "", {}, {});
+    ir.target_machine = Target->createTargetMachine(target_str, GetTargetCPU(), GetTargetFeatures(), {}, {});
     ir.module->setTargetTriple(target_str);
     ir.module->setDataLayout(ir.target_machine->createDataLayout());
 
     //Generate and store the IR in 'ir'
-    LLVMIRGenerator ir_gen = { ast, *ir.context, *ir.module };
+    LLVMIRGenerator ir_gen = { ast, *ir.context, *ir.module, cache };
     //Verify module
     if (llvm::verifyModule(*ir.module, &llvm::errs()))
       return { Error, "Generated IR is invalid!" };
+    //Link the runtime so that it can be inlined
+    if (auto result = ir.link_runtime(); result.is_error())
+      return { Error, result.get_error() };
     return ir;
   }
 
+  Expected<bool, std::string> LinkThinLTO(ArrayRef<StringRef> files, StringRef output_prefix) noexcept
+  {
+    lto::Config config;
+    config.CPU = GetTargetCPU();
+    std::string features = GetTargetFeatures();
+    SmallVector<StringRef, 8> features_list;
+    StringRef(features).split(features_list, ',', -1, false);
+    for (auto feature : features_list)
+      config.MAttrs.push_back(feature.str());
+    config.OptLevel = 3;
+    config.CGOptLevel = CodeGenOpt::Aggressive;
+
+    //Each module is optimized and compiled on its own thread
+    lto::LTO lto(std::move(config),
+      lto::createInProcessThinBackend(heavyweight_hardware_concurrency()));
+
+    //The buffers must outlive the LTO
+    std::vector<std::unique_ptr<MemoryBuffer>> buffers;
+    StringSet<> defined;
+    for (auto file : files)
+    {
+      auto buffer = MemoryBuffer::getFile(file);
+      if (!buffer)
+        return { Error, "Could not open file '" + file.str() + "'!" };
+      auto input = lto::InputFile::create((*buffer)->getMemBufferRef());
+      if (!input)
+        return { Error, toString(input.takeError()) };
+
+      std::vector<lto::SymbolResolution> resolutions;
+      for (const auto& symbol : (*input)->symbols())
+      {
+        lto::SymbolResolution resolution;
+        if (!symbol.isUndefined())
+        {
+          //The first definition of a symbol prevails
+          resolution.Prevailing = defined.insert(symbol.getName()).second;
+          resolution.FinalDefinitionInLinkageUnit = true;
+          //The object files are linked by a native linker
+          resolution.VisibleToRegularObj = true;
+        }
+        resolutions.push_back(resolution);
+      }
+      if (auto err = lto.add(std::move(*input), resolutions))
+        return { Error, toString(std::move(err)) };
+      buffers.push_back(std::move(*buffer));
+    }
+
+    auto add_stream = [output_prefix](unsigned task) -> llvm::Expected<std::unique_ptr<CachedFileStream>>
+    {
+      std::error_code EC;
+      auto os = std::make_unique<raw_fd_ostream>(
+        (output_prefix + "." + Twine(task) + ".o").str(), EC, sys::fs::OF_None);
+      if (EC)
+        return errorCodeToError(EC);
+      return std::make_unique<CachedFileStream>(std::move(os));
+    };
+    if (auto err = lto.run(add_stream))
+      return { Error, toString(std::move(err)) };
+    return true;
+  }
+
   void GeneratedIR::print_module(llvm::raw_ostream& os) const noexcept
   {
     module->print(os, nullptr);
   }
 
+  IRStats GeneratedIR::get_stats() const noexcept
+  {
+    IRStats stats;
+    for (const auto& fn : *module)
+    {
+      //Declarations do not contain any instruction
+      if (fn.isDeclaration())
+        continue;
+      stats.fn_count += 1;
+      stats.block_count += fn.size();
+      stats.inst_count += fn.getInstructionCount();
+    }
+    return stats;
+  }
+
   Expected<bool, const char*> GeneratedIR::to_object_file(const char* path) noexcept
   {
     std::error_code EC;
@@ -60,13 +188,87 @@ namespace colt::gen
 
     pass.run(*module);
     dest.flush();
+    //A partially written file must not be used (see ImportModule)
+    if (dest.has_error())
+    {
+      dest.clear_error();
+      return "Could not write file!";
+    }
+    //No errors
+    return true;
+  }
+
+  Expected<bool, const char*> GeneratedIR::to_bitcode_file(const char* path) noexcept
+  {
+    std::error_code EC;
+    raw_fd_ostream dest(path, EC);
+
+    if (EC) {
+      return "Could not open file!";
+    }
+
+    //The summary allows ThinLTO to import functions from other modules
+    ModuleSummaryIndex index = buildModuleSummaryIndex(*module, nullptr, nullptr);
+    WriteBitcodeToFile(*module, dest, false, &index);
+    dest.flush();
+    if (dest.has_error())
+    {
+      dest.clear_error();
+      return "Could not write file!";
+    }
     //No errors
     return true;
   }
 
+  Expected<bool, const char*> GeneratedIR::link_runtime() noexcept
+  {
+#ifdef COLT_RUNTIME_BITCODE
+    auto buffer = MemoryBufferRef(
+      StringRef(reinterpret_cast<const char*>(COLT_RUNTIME_BITCODE_DATA), COLT_RUNTIME_BITCODE_DATA_SIZE),
+      "colt_runtime");
+    auto runtime = parseBitcodeFile(buffer, *context);
+    if (!runtime)
+    {
+      consumeError(runtime.takeError());
+      return "Could not load runtime bitcode!";
+    }
+    //The runtime is compiled for the host: a module targeting another
+    //machine keeps calling the runtime as external functions.
+    if ((*runtime)->getTargetTriple() != module->getTargetTriple())
+      return true;
+    (*runtime)->setDataLayout(module->getDataLayout());
+
+    //Only link the functions used by the module, and internalize them
+    //so that they can be inlined and removed after optimizations.
+    bool error = Linker::linkModules(*module, std::move(*runtime), Linker::Flags::LinkOnlyNeeded,
+      [](llvm::Module& mod, const StringSet<>& linked)
+      {
+        internalizeModule(mod, [&linked](const GlobalValue& gv)
+          {
+            return !gv.hasName() || linked.count(gv.getName()) == 0;
+          });
+      });
+    if (error)
+      return "Could not link runtime bitcode!";
+#endif //COLT_RUNTIME_BITCODE
+    return true;
+  }
+
+  /// @brief Returns the profile-guided optimization options.
+  /// Should only be called if '-fprofile-generate' or '-fprofile-use' was specified.
+  /// @return Options to use the profile if '-fprofile-use', else to instrument the code
+  static PGOOptions GetPGOOptions() noexcept
+  {
+    if (args::ProfileUse)
+      return PGOOptions(args::ProfileUse, "", "", PGOOptions::IRUse);
+    //The instrumented program writes 'default_<id>.profraw' at exit
+    return PGOOptions("", "", "", PGOOptions::IRInstr);
+  }
+
   void GeneratedIR::optimize(colt::gen::OptimizationLevel level) noexcept
   {
-    if (level == colt::gen::OptimizationLevel::O0)
+    //Instrumentation ('-fprofile-generate') is applied even without optimizations
+    if (level == colt::gen::OptimizationLevel::O0 && !args::ProfileGenerate)
       return;
 
     LoopAnalysisManager LAM;
@@ -74,7 +276,10 @@ namespace colt::gen
     CGSCCAnalysisManager CGAM;
     ModuleAnalysisManager MAM;
 
-    PassBuilder PB;
+    //The target machine provides the costs used by the vectorizers
+    PassBuilder PB = args::ProfileGenerate || args::ProfileUse
+      ? PassBuilder(target_machine, PipelineTuningOptions(), GetPGOOptions())
+      : PassBuilder(target_machine);
 
     PB.registerModuleAnalyses(MAM);
     PB.registerCGSCCAnalyses(CGAM);
@@ -85,6 +290,8 @@ namespace colt::gen
     llvm::OptimizationLevel opt;
     switch (level)
     {
+    break; case colt::gen::OptimizationLevel::O0:
+      opt = llvm::OptimizationLevel::O0;
     break; case colt::gen::OptimizationLevel::O1:
       opt = llvm::OptimizationLevel::O1;
     break; case colt::gen::OptimizationLevel::O2:
@@ -99,21 +306,76 @@ namespace colt::gen
       colt_unreachable("Invalid optimization level");
     }
 
-    ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(opt);
+    //Bitcode is optimized again by ThinLTO after importing functions
+    ModulePassManager MPM;
+    if (level == colt::gen::OptimizationLevel::O0)
+      MPM = PB.buildO0DefaultPipeline(opt, args::EmitBitcode);
+    else if (args::EmitBitcode)
+      MPM = PB.buildThinLTOPreLinkDefaultPipeline(opt);
+    else
+      MPM = PB.buildPerModuleDefaultPipeline(opt);
     MPM.run(*module, MAM);
   }
 
-  LLVMIRGenerator::LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod) noexcept
-    : context(ctx), module(mod), builder(ctx)
+  LLVMIRGenerator::LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod, PTR<const IncrementalCache> cache) noexcept
+    : context(ctx), module(mod), ast_ctx(ast.ctx), builder(ctx), fn_attributes(ast), dbg_builder(mod), cache(cache)
   {
+    if (!args::NoDebugInfo)
+    {
+      //Only line tables are generated, which is enough for profilers and stack traces
+      StringRef path = args::FileIn ? args::FileIn : "<stdin>";
+      auto file = dbg_builder.createFile(sys::path::filename(path), sys::path::parent_path(path));
+      dbg_unit = dbg_builder.createCompileUnit(dwarf::DW_LANG_C, file, "Colt Compiler", true, "", 0,
+        "", DICompileUnit::LineTablesOnly);
+      module.addModuleFlag(llvm::Module::Warning, "Debug Info Version", DEBUG_METADATA_VERSION);
+      module.addModuleFlag(llvm::Module::Warning, "Dwarf Version", 4);
+    }
+
+    //All the globals are declared before generating the bodies that use them
+    for (size_t i = 0; i < ast.imports.get_size(); i++)
+      declare_global(ast.imports[i]);
+    for (size_t i = 0; i < ast.expressions.get_size(); i++)
+      declare_global(ast.expressions[i]);
+
+    //Declarations imported from other modules
+    for (size_t i = 0; i < ast.imports.get_size(); i++)
+      gen_ir(ast.imports[i]);
     for (size_t i = 0; i < ast.expressions.get_size(); i++)
       gen_ir(ast.expressions[i]);
+
+    if (dbg_unit)
+      dbg_builder.finalize();
+  }
+
+  void LLVMIRGenerator::declare_global(PTR<const lang::Expr> ptr) noexcept
+  {
+    using namespace lang;
+
+    if (auto fn_def = dyn_cast<PTR<const FnDefExpr>>(ptr))
+    {
+      PTR<Function> fn = Function::Create(
+        cast<FunctionType>(type_to_llvm(fn_def->get_type())),
+        GlobalValue::ExternalLinkage,
+        ToStringRef(colt::gen::mangle(fn_def->get_fn_decl())),
+        module);
+      function_map.insert(fn_def->get_fn_decl(), fn);
+    }
+    else if (auto var = dyn_cast<PTR<const VarDeclExpr>>(ptr); var && var->is_global())
+    {
+      module.getOrInsertGlobal(ToStringRef(var->get_name()), type_to_llvm(var->get_type()));
+      global_vars.insert(var->get_symbol(), module.getNamedGlobal(ToStringRef(var->get_name())));
+    }
   }
 
   void LLVMIRGenerator::gen_ir(PTR<const lang::Expr> ptr) noexcept
   {
     using namespace lang;
 
+    //Instructions are attributed to the innermost expression generating them
+    DebugLoc saved_location = builder.getCurrentDebugLocation();
+    ON_EXIT{ builder.SetCurrentDebugLocation(saved_location); };
+    set_debug_location(ptr);
+
     switch (ptr->classof())
     {
     break; case Expr::EXPR_LITERAL:
@@ -140,6 +402,8 @@ namespace colt::gen
       gen_scope(as<PTR<const ScopeExpr>>(ptr));
     break; case Expr::EXPR_CONDITION:
       gen_condition(as<PTR<const ConditionExpr>>(ptr));
+    break; case Expr::EXPR_SWITCH:
+      gen_switch(as<PTR<const SwitchExpr>>(ptr));
     break; case Expr::EXPR_WHILE_LOOP:
       gen_while_loop(as<PTR<const WhileLoopExpr>>(ptr));
     break; case Expr::EXPR_BREAK_CONTINUE:
@@ -151,6 +415,15 @@ namespace colt::gen
     break; case Expr::EXPR_PTR_STORE:
       gen_ptr_store(as<PTR<const PtrStoreExpr>>(ptr));
     break; case Expr::EXPR_FOR_LOOP:
+      gen_for_loop(as<PTR<const ForLoopExpr>>(ptr));
+    break; case Expr::EXPR_INDEX:
+      gen_index(as<PTR<const IndexExpr>>(ptr));
+    break; case Expr::EXPR_SLICE_LEN:
+      gen_slice_len(as<PTR<const SliceLenExpr>>(ptr));
+    break; case Expr::EXPR_TO_SLICE:
+      gen_to_slice(as<PTR<const ToSliceExpr>>(ptr));
+    break; case Expr::EXPR_VEC_INTRINSIC:
+      gen_vec_intrinsic(as<PTR<const VecIntrinsicExpr>>(ptr));
     break; default:
       colt_unreachable("Generating invalid expression!");
     }
@@ -163,7 +436,16 @@ namespace colt::gen
     //If lstring, then the type is not built-in but PTR
     if (ptr->get_type()->is_lstring())
     {
-      returned_value = builder.CreateGlobalStringPtr(ToStringRef(*ptr->get_value().as<PTR<String>>()), "GlobStr", 0U, &module);
+      //String literals are interned by the AST: emit a single global per string
+      PTR<const String> str = ptr->get_value().as<PTR<String>>();
+      if (auto global = string_literals.find(str); global != nullptr)
+      {
+        returned_value = global->second;
+        return;
+      }
+      auto global = builder.CreateGlobalStringPtr(ToStringRef(*str), "GlobStr", 0U, &module);
+      string_literals.insert(str, global);
+      returned_value = global;
       return;
     }
 
@@ -217,7 +499,7 @@ namespace colt::gen
       if (!var_read->is_global())
         returned_value = local_vars[var_read->get_local_ID()];
       else
-        returned_value = global_vars.find(var_read->get_name())->second;
+        returned_value = global_vars.find(var_read->get_symbol())->second;
     }    
     break; case UnaryOperator::OP_NEGATE:
       returned_value = builder.CreateNeg(child);
@@ -242,8 +524,9 @@ namespace colt::gen
 
     using namespace colt::lang;
 
-    auto expr_t = as<PTR<const BuiltInType>>(ptr->get_type());
-    auto type_t = as<PTR<const BuiltInType>>(ptr->get_LHS()->get_type());
+    //Operations on vectors are done element-wise
+    auto expr_t = scalar_type_of(ptr->get_type());
+    auto type_t = scalar_type_of(ptr->get_LHS()->get_type());
 
     switch (ptr->get_operation())
     {
@@ -369,7 +652,7 @@ namespace colt::gen
     }
     else // bit_as
     {
-      auto alloc = builder.CreateAlloca(returned_value->getType());
+      auto alloc = create_entry_alloca(returned_value->getType(), "bit_as");
       builder.CreateStore(returned_value, alloc);
       returned_value = builder.CreateBitCast(alloc,
         llvm::PointerType::get(type_to_llvm(expr_t), 0));
@@ -383,8 +666,7 @@ namespace colt::gen
     {
       //Create an allocation on the stack and store it
       local_vars.push_back(
-        builder.CreateAlloca(type_to_llvm(ptr->get_type()), nullptr,
-          ToStringRef(ptr->get_name()))
+        create_entry_alloca(type_to_llvm(ptr->get_type()), ToStringRef(ptr->get_name()))
       );
     
       //If initialized
@@ -399,11 +681,8 @@ namespace colt::gen
     {
       assert(ptr->is_global());
 
-      module.getOrInsertGlobal(ToStringRef(ptr->get_name()), type_to_llvm(ptr->get_type()));
-
-      PTR<GlobalVariable> gvar = module.getNamedGlobal(ToStringRef(ptr->get_name()));
-      //Insert variable
-      global_vars.insert(ptr->get_name(), gvar);
+      //Declared by 'declare_global'
+      PTR<GlobalVariable> gvar = global_vars.find(ptr->get_symbol())->second;
       if (ptr->is_initialized())
       {
         gen_ir(ptr->get_value());
@@ -423,7 +702,7 @@ namespace colt::gen
         local_vars[ptr->get_local_ID()], false);
     else
     {
-      auto gptr = global_vars.find(ptr->get_name());
+      auto gptr = global_vars.find(ptr->get_symbol());
       assert(gptr);
       returned_value = builder.CreateLoad(gptr->second->getValueType(), gptr->second);
     }
@@ -443,35 +722,51 @@ namespace colt::gen
     }
     else
     {
-      auto gptr = global_vars.find(ptr->get_name())->second;
-      builder.CreateStore(to_write, global_vars.find(ptr->get_name())->second);
+      auto gptr = global_vars.find(ptr->get_symbol())->second;
+      builder.CreateStore(to_write, global_vars.find(ptr->get_symbol())->second);
       returned_value = builder.CreateLoad(gptr->getValueType(), gptr);
     }
   }
 
   void LLVMIRGenerator::gen_fn_def(PTR<const lang::FnDefExpr> ptr) noexcept
   {
-    PTR<Function> fn = Function::Create(
-      cast<FunctionType>(type_to_llvm(ptr->get_type())),
-      GlobalValue::ExternalLinkage,
-      ToStringRef(colt::gen::mangle(ptr->get_fn_decl())),
-      module);
-    //Save to global table
-    function_map.insert(ptr->get_fn_decl(), fn);
+    //Declared by 'declare_global'
+    PTR<Function> fn = function_map.find(ptr->get_fn_decl())->second;
     
     //noexcept
     fn->addFnAttr(llvm::Attribute::NoUnwind);
     
-    //Extern functions do not have bodies
-    if (ptr->get_fn_decl()->is_extern())
+    //Extern and imported functions do not have bodies
+    if (ptr->get_fn_decl()->is_extern() || !ptr->has_body())
       return;
     
     assert_true(ptr->get_body(), "Body should not be empty!");       
+
+    //The initialization of global variables done in 'main' is not part of its body
+    if (auto attr = fn_attributes.find(ptr->get_fn_decl());
+      attr != nullptr && (ptr->get_name() != "main" || call_before_main.is_empty()))
+      add_fn_attributes(fn, *attr);
+    //The body of cached functions is linked after optimizations
+    if (cache != nullptr && cache->is_cached(ptr->get_fn_decl()))
+      return;
     
     current_fn = fn;
     //Reset current_fn to nullptr
     ON_EXIT{ current_fn = nullptr; };
 
+    if (dbg_unit)
+    {
+      u32 line = ptr->get_src_loc().line_begin;
+      //Line tables do not need the types of the parameters
+      auto subprogram = dbg_builder.createFunction(dbg_unit->getFile(), ToStringRef(ptr->get_name()),
+        fn->getName(), dbg_unit->getFile(), line,
+        dbg_builder.createSubroutineType(dbg_builder.getOrCreateTypeArray({})), line,
+        DINode::FlagPrototyped, DISubprogram::SPFlagDefinition | DISubprogram::SPFlagOptimized);
+      fn->setSubprogram(subprogram);
+      //The prologue is attributed to the declaration of the function
+      set_debug_location(ptr);
+    }
+
     PTR<llvm::BasicBlock> BB = BasicBlock::Create(context, "entry", fn);
     
     if (ptr->get_name() == "main" && !call_before_main.is_empty())
@@ -494,7 +789,7 @@ namespace colt::gen
       arg.setName(ToStringRef(ptr->get_params_name()[i]));
       //Create an allocation on the stack and store it
       local_vars.push_back(
-        builder.CreateAlloca(arg.getType(), nullptr,
+        create_entry_alloca(arg.getType(),
           ToStringRef(ptr->get_params_name()[i]) + "_ArgCopy")
       );
       builder.CreateStore(&arg, local_vars.get_back());
@@ -504,6 +799,35 @@ namespace colt::gen
 
     //We pop variables allocated in the current scope
     local_vars.pop_back_n(local_vars.get_size() - current_scope_var_count);
+
+    //An invalid function is reported by the verifier after generation
+    if (args::DirectSSA && !llvm::verifyFunction(*fn))
+      promote_locals();
+  }
+
+  void LLVMIRGenerator::add_fn_attributes(PTR<Function> fn, const FnAttributes& attr) noexcept
+  {
+    if (attr.no_recurse)
+      fn->setDoesNotRecurse();
+    if (attr.will_return)
+      fn->addFnAttr(llvm::Attribute::WillReturn);
+    if (attr.no_sync)
+    {
+      fn->addFnAttr(llvm::Attribute::NoSync);
+      fn->addFnAttr(llvm::Attribute::NoFree);
+    }
+    if (!attr.reads_memory && !attr.writes_memory)
+      fn->setDoesNotAccessMemory();
+    else if (!attr.writes_memory)
+      fn->setOnlyReadsMemory();
+
+    for (unsigned i = 0; i < attr.no_capture.get_size(); i++)
+    {
+      if (attr.no_capture[i])
+        fn->addParamAttr(i, llvm::Attribute::NoCapture);
+      if (attr.no_alias[i])
+        fn->addParamAttr(i, llvm::Attribute::NoAlias);
+    }
   }
 
   void LLVMIRGenerator::gen_fn_ret(PTR<const lang::FnReturnExpr> ptr) noexcept
@@ -587,6 +911,56 @@ namespace colt::gen
     }
   }
 
+  void LLVMIRGenerator::gen_switch(PTR<const lang::SwitchExpr> ptr) noexcept
+  {
+    gen_ir(ptr->get_value());
+    Value* value = returned_value;
+
+    BasicBlock* after_st = BasicBlock::Create(context, "after_switch");
+    //Without a 'default' case, values not handled skip the switch
+    BasicBlock* default_st = ptr->get_default() != nullptr
+      ? BasicBlock::Create(context, "switch_default") : after_st;
+
+    auto bodies = ptr->get_case_bodies();
+    llvm::SmallVector<BasicBlock*, 16> case_sts;
+    for (size_t i = 0; i < bodies.get_size(); i++)
+      case_sts.push_back(BasicBlock::Create(context, "switch_case"));
+
+    //The backend chooses between a jump table, a binary search
+    //or a bit test depending on the density of the cases.
+    auto values = ptr->get_case_values();
+    SwitchInst* switch_inst = builder.CreateSwitch(value, default_st,
+      as<u32>(values.get_size()));
+    for (auto& [case_value, index] : values)
+    {
+      gen_literal(case_value);
+      switch_inst->addCase(cast<ConstantInt>(returned_value), case_sts[index]);
+    }
+
+    for (size_t i = 0; i < bodies.get_size(); i++)
+    {
+      current_fn->getBasicBlockList().push_back(case_sts[i]);
+      builder.SetInsertPoint(case_sts[i]);
+      gen_ir(bodies[i]);
+      if (!lang::isTerminated(bodies[i]))
+        builder.CreateBr(after_st);
+    }
+    if (ptr->get_default() != nullptr)
+    {
+      current_fn->getBasicBlockList().push_back(default_st);
+      builder.SetInsertPoint(default_st);
+      gen_ir(ptr->get_default());
+      if (!lang::isTerminated(ptr->get_default()))
+        builder.CreateBr(after_st);
+    }
+
+    if (!lang::isTerminated(ptr))
+    {
+      current_fn->getBasicBlockList().push_back(after_st);
+      builder.SetInsertPoint(after_st);
+    }
+  }
+
   void LLVMIRGenerator::gen_while_loop(PTR<const lang::WhileLoopExpr> ptr) noexcept
   {
     BasicBlock* while_cond = BasicBlock::Create(context, "while_cond", current_fn);
@@ -615,6 +989,61 @@ namespace colt::gen
     builder.SetInsertPoint(end);
   }
 
+  void LLVMIRGenerator::gen_for_loop(PTR<const lang::ForLoopExpr> ptr) noexcept
+  {
+    bool is_signed = ptr->get_var_type()->is_signed_int();
+    
+    //The bounds are evaluated once, before entering the loop
+    gen_ir(ptr->get_begin());
+    PTR<Value> begin = returned_value;
+    gen_ir(ptr->get_end());
+    PTR<Value> end = returned_value;
+    
+    //Storage of the loop variable, read by the body.
+    //As the variable is not mutable, this is promoted to the PHI node.
+    local_vars.push_back(
+      create_entry_alloca(begin->getType(), ToStringRef(ptr->get_var_name()))
+    );
+    PTR<AllocaInst> var = local_vars.get_back();
+
+    BasicBlock* preheader = builder.GetInsertBlock();
+    BasicBlock* body = BasicBlock::Create(context, "for_body", current_fn);
+    BasicBlock* latch = BasicBlock::Create(context, "for_latch");
+    BasicBlock* end_bb = BasicBlock::Create(context, "after_for");
+
+    colt::ScopedSave s1 = { loop_begin, latch };
+    colt::ScopedSave s2 = { loop_end, end_bb };
+
+    //Guard: do not enter the loop if the range is empty
+    builder.CreateCondBr(is_signed ? builder.CreateICmpSLT(begin, end, "si_lt")
+      : builder.CreateICmpULT(begin, end, "ui_lt"), body, end_bb);
+
+    builder.SetInsertPoint(body);
+    PHINode* iv = builder.CreatePHI(begin->getType(), 2, ToStringRef(ptr->get_var_name()));
+    iv->addIncoming(begin, preheader);
+    builder.CreateStore(iv, var);
+
+    gen_ir(ptr->get_body());
+    if (!lang::isLoopTerminated(ptr->get_body()))
+      builder.CreateBr(latch);
+
+    //As 'iv' < 'end', incrementing cannot overflow
+    current_fn->getBasicBlockList().push_back(latch);
+    builder.SetInsertPoint(latch);
+    PTR<Value> next = builder.CreateAdd(iv, ConstantInt::get(begin->getType(), 1),
+      "for_next", !is_signed, is_signed);
+    iv->addIncoming(next, latch);
+    builder.CreateCondBr(is_signed ? builder.CreateICmpSLT(next, end, "si_lt")
+      : builder.CreateICmpULT(next, end, "ui_lt"), body, end_bb);
+
+    //Pop the loop variable
+    local_vars.pop_back();
+
+    current_fn->getBasicBlockList().push_back(end_bb);
+    //Set insertion to after loop body
+    builder.SetInsertPoint(end_bb);
+  }
+
   void LLVMIRGenerator::gen_break_continue(PTR<const lang::BreakContinueExpr> ptr) noexcept
   {
     BasicBlock* jmp = BasicBlock::Create(context, ptr->is_break() ? "break" : "continue", current_fn);
@@ -647,6 +1076,221 @@ namespace colt::gen
       store->getPointerOperand());
   }  
 
+  void LLVMIRGenerator::gen_index(PTR<const lang::IndexExpr> ptr) noexcept
+  {
+    using namespace lang;
+
+    PTR<Value> base;
+    PTR<Value> size;
+    PTR<const lang::Type> where_t = ptr->get_where()->get_type();
+    if (where_t->is_array())
+    {
+      base = gen_address(ptr->get_where());
+      size = builder.getInt64(as<PTR<const lang::ArrayType>>(where_t)->get_count());
+    }
+    else
+    {
+      gen_ir(ptr->get_where());
+      base = builder.CreateExtractValue(returned_value, 0, "slice_ptr");
+      size = builder.CreateExtractValue(returned_value, 1, "slice_len");
+    }
+
+    gen_ir(ptr->get_index());
+    //Negative indices become greater than any size
+    PTR<Value> index = builder.CreateIntCast(returned_value, builder.getInt64Ty(),
+      ptr->get_index()->get_type()->is_signed_int(), "index");
+
+    if (ptr->is_checked())
+    {
+      BasicBlock* out_of_bounds = BasicBlock::Create(context, "out_of_bounds", current_fn);
+      BasicBlock* in_bounds = BasicBlock::Create(context, "in_bounds", current_fn);
+      
+      //The check is expected to always pass
+      builder.CreateCondBr(builder.CreateICmpULT(index, size, "ui_lt"), in_bounds, out_of_bounds,
+        MDBuilder(context).createBranchWeights(1 << 20, 1));
+      
+      builder.SetInsertPoint(out_of_bounds);
+      builder.CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
+      builder.CreateUnreachable();
+      
+      builder.SetInsertPoint(in_bounds);
+    }
+
+    if (where_t->is_array())
+      returned_value = builder.CreateInBoundsGEP(type_to_llvm(where_t), base,
+        { builder.getInt64(0), index }, "arr_elem");
+    else
+      returned_value = builder.CreateInBoundsGEP(
+        type_to_llvm(as<PTR<const SliceType>>(where_t)->get_type_of()), base,
+        index, "slice_elem");
+  }
+
+  void LLVMIRGenerator::gen_slice_len(PTR<const lang::SliceLenExpr> ptr) noexcept
+  {
+    gen_ir(ptr->get_slice());
+    returned_value = builder.CreateExtractValue(returned_value, 1, "slice_len");
+  }
+
+  void LLVMIRGenerator::gen_to_slice(PTR<const lang::ToSliceExpr> ptr) noexcept
+  {
+    PTR<Value> array = gen_address(ptr->get_array());
+    PTR<Value> slice = UndefValue::get(type_to_llvm(ptr->get_type()));
+    slice = builder.CreateInsertValue(slice, builder.CreateInBoundsGEP(
+      type_to_llvm(ptr->get_array()->get_type()), array,
+      { builder.getInt64(0), builder.getInt64(0) }, "arr_begin"), 0);
+    returned_value = builder.CreateInsertValue(slice, builder.getInt64(ptr->get_count()), 1, "to_slice");
+  }
+
+  void LLVMIRGenerator::gen_vec_intrinsic(PTR<const lang::VecIntrinsicExpr> ptr) noexcept
+  {
+    using namespace lang;
+    using VecI = VecIntrinsicExpr;
+
+    auto args = ptr->get_arguments();
+    gen_ir(args[0]);
+    PTR<Value> value = returned_value;
+
+    switch (ptr->get_intrinsic())
+    {
+    break; case VecI::VEC_SPLAT:
+      returned_value = builder.CreateVectorSplat(
+        as<u32>(as<PTR<const VecType>>(ptr->get_type())->get_count()), value, "vec_splat");
+    break; case VecI::VEC_FROM_ARRAY:
+    {
+      //The optimizer merges the extractions into a single vector load
+      u64 count = as<PTR<const VecType>>(ptr->get_type())->get_count();
+      returned_value = UndefValue::get(type_to_llvm(ptr->get_type()));
+      for (u64 i = 0; i < count; i++)
+        returned_value = builder.CreateInsertElement(returned_value,
+          builder.CreateExtractValue(value, as<u32>(i)), i);
+    }
+    break; case VecI::VEC_TO_ARRAY:
+    {
+      u64 count = as<PTR<const VecType>>(args[0]->get_type())->get_count();
+      returned_value = UndefValue::get(type_to_llvm(ptr->get_type()));
+      for (u64 i = 0; i < count; i++)
+        returned_value = builder.CreateInsertValue(returned_value,
+          builder.CreateExtractElement(value, i), as<u32>(i));
+    }
+    break; case VecI::VEC_SHUFFLE:
+    {
+      gen_ir(args[1]);
+      llvm::SmallVector<int, 16> mask;
+      for (size_t i = 2; i < args.get_size(); i++)
+        mask.push_back(as<PTR<const LiteralExpr>>(args[i])->get_value().as<i32>());
+      returned_value = builder.CreateShuffleVector(value, returned_value, mask, "vec_shuffle");
+    }
+    break; case VecI::VEC_REDUCE_ADD:
+      if (ptr->get_type()->is_floating())
+      {
+        //Reassociation is allowed so that the reduction is done as a tree
+        auto reduce = builder.CreateFAddReduce(ConstantFP::getNegativeZero(value->getType()->getScalarType()), value);
+        reduce->setHasAllowReassoc(true);
+        returned_value = reduce;
+      }
+      else
+        returned_value = builder.CreateAddReduce(value);
+    break; case VecI::VEC_REDUCE_MUL:
+      if (ptr->get_type()->is_floating())
+      {
+        //Reassociation is allowed so that the reduction is done as a tree
+        auto reduce = builder.CreateFMulReduce(ConstantFP::get(value->getType()->getScalarType(), 1.0), value);
+        reduce->setHasAllowReassoc(true);
+        returned_value = reduce;
+      }
+      else
+        returned_value = builder.CreateMulReduce(value);
+    break; case VecI::VEC_REDUCE_MIN:
+      if (ptr->get_type()->is_floating())
+        returned_value = builder.CreateFPMinReduce(value);
+      else
+        returned_value = builder.CreateIntMinReduce(value, ptr->get_type()->is_signed_int());
+    break; case VecI::VEC_REDUCE_MAX:
+      if (ptr->get_type()->is_floating())
+        returned_value = builder.CreateFPMaxReduce(value);
+      else
+        returned_value = builder.CreateIntMaxReduce(value, ptr->get_type()->is_signed_int());
+    break; case VecI::VEC_REDUCE_AND:
+      returned_value = builder.CreateAndReduce(value);
+    break; case VecI::VEC_REDUCE_OR:
+      returned_value = builder.CreateOrReduce(value);
+    break; case VecI::VEC_REDUCE_XOR:
+      returned_value = builder.CreateXorReduce(value);
+    break; case VecI::VEC_LOAD_MASKED:
+    case VecI::VEC_STORE_MASKED:
+    {
+      gen_ir(args[1]);
+      PTR<Value> mask = returned_value;
+      gen_ir(args[2]);
+      PTR<Value> vec = returned_value;
+      
+      //The pointer only needs the alignment of the elements
+      PTR<llvm::Type> vec_type = vec->getType();
+      PTR<Value> where = builder.CreateBitCast(value, PointerType::get(vec_type, 0));
+      Align align = module.getDataLayout().getABITypeAlign(vec_type->getScalarType());
+      if (ptr->get_intrinsic() == VecI::VEC_LOAD_MASKED)
+        returned_value = builder.CreateMaskedLoad(vec_type, where, align, mask, vec, "vec_load");
+      else
+        returned_value = builder.CreateMaskedStore(vec, where, align, mask);
+    }
+    break; default:
+      colt_unreachable("Invalid vector operation!");
+    }
+  }
+
+  void LLVMIRGenerator::set_debug_location(PTR<const lang::Expr> ptr) noexcept
+  {
+    if (current_fn == nullptr || current_fn->getSubprogram() == nullptr)
+      return;
+    auto src_info = ast_ctx.to_src_info(ptr->get_src_loc());
+    if (!src_info.is_valid())
+      return;
+    //'lines' begins at the start of the first line of the expression
+    u32 column = static_cast<u32>(src_info.expression.get_data() - src_info.lines.get_data()) + 1;
+    builder.SetCurrentDebugLocation(
+      DILocation::get(context, src_info.line_begin, column, current_fn->getSubprogram()));
+  }
+
+  PTR<AllocaInst> LLVMIRGenerator::create_entry_alloca(PTR<llvm::Type> type, const Twine& name) noexcept
+  {
+    //Allocations in the entry block are done once per call, and
+    //are the only ones that mem2reg and SROA promote to registers.
+    BasicBlock& entry = current_fn->getEntryBlock();
+    IRBuilder<> entry_builder = { &entry, entry.begin() };
+    return entry_builder.CreateAlloca(type, nullptr, name);
+  }
+
+  void LLVMIRGenerator::promote_locals() noexcept
+  {
+    //Variables whose address is taken cannot be promoted
+    llvm::SmallVector<PTR<AllocaInst>, 16> allocas;
+    for (auto& inst : current_fn->getEntryBlock())
+    {
+      if (auto alloca = llvm::dyn_cast<AllocaInst>(&inst); alloca && isAllocaPromotable(alloca))
+        allocas.push_back(alloca);
+    }
+    if (allocas.empty())
+      return;
+    
+    DominatorTree dom_tree = { *current_fn };
+    PromoteMemToReg(allocas, dom_tree);
+  }
+
+  PTR<Value> LLVMIRGenerator::gen_address(PTR<const lang::Expr> ptr) noexcept
+  {
+    using namespace lang;
+
+    if (is_a<PtrLoadExpr>(ptr))
+    {
+      gen_ir(as<PTR<const PtrLoadExpr>>(ptr)->get_where());
+      return returned_value;
+    }
+    auto var_read = as<PTR<const VarReadExpr>>(ptr);
+    if (!var_read->is_global())
+      return local_vars[var_read->get_local_ID()];
+    return global_vars.find(var_read->get_symbol())->second;
+  }
+
   PTR<llvm::Type> LLVMIRGenerator::type_to_llvm(PTR<const lang::Type> type) noexcept
   {
     using namespace lang;
@@ -707,6 +1351,22 @@ namespace colt::gen
       return FunctionType::get(type_to_llvm(ptr->get_return_type()), arg_types, ptr->is_varargs());
     }      
     case lang::Type::TYPE_ARRAY:
+    {
+      auto ptr = as<PTR<const lang::ArrayType>>(type);
+      return llvm::ArrayType::get(type_to_llvm(ptr->get_type_of()), ptr->get_count());
+    }
+    case lang::Type::TYPE_SLICE:
+    {
+      //A slice is a pointer to the first element and a length
+      auto ptr = as<PTR<const SliceType>>(type);
+      return StructType::get(context,
+        { PointerType::get(type_to_llvm(ptr->get_type_of()), 0), llvm::Type::getInt64Ty(context) });
+    }
+    case lang::Type::TYPE_VEC:
+    {
+      auto ptr = as<PTR<const VecType>>(type);
+      return FixedVectorType::get(type_to_llvm(ptr->get_type_of()), as<u32>(ptr->get_count()));
+    }
     case lang::Type::TYPE_CLASS:      
     default:
       colt_unreachable("Unimplemented type!");
@@ -18,19 +18,34 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/DIBuilder.h>
+#include <llvm/Support/Path.h>
+#include <llvm/IR/Dominators.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Target/TargetOptions.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Analysis/ModuleSummaryAnalysis.h>
+#include <llvm/LTO/LTO.h>
+#include <llvm/Support/Caching.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/Utils/PromoteMemToReg.h>
 
 #include <util/colt_pch.h>
 #include <type/colt_type.h>
 #include <ast/colt_ast.h>
 #include <code_gen/mangle.h>
+#include <code_gen/fn_attributes.h>
+#include <code_gen/incremental.h>
 
 /// @brief Contains classes responsible of producing code from the Colt AST
 namespace colt::gen
@@ -40,6 +55,17 @@ namespace colt::gen
 	/// @return The converted StringRef
 	llvm::StringRef ToStringRef(colt::StringView view) noexcept;
 
+	/// @brief Counters of the content of a module (printed by '-stats')
+	struct IRStats
+	{
+		/// @brief The count of function definitions
+		u64 fn_count = 0;
+		/// @brief The count of basic blocks
+		u64 block_count = 0;
+		/// @brief The count of instructions
+		u64 inst_count = 0;
+	};
+
 	/// @brief Represents valid LLVM IR
 	struct GeneratedIR
 	{
@@ -55,21 +81,57 @@ namespace colt::gen
 		/// @param os The file to write in
 		void print_module(llvm::raw_ostream& os = llvm::errs()) const noexcept;
 
+		/// @brief Counts the functions, basic blocks and instructions of the module
+		/// @return The statistics of the module
+		IRStats get_stats() const noexcept;
+
 		/// @brief Compiles IR to object file
 		/// @param path The path where to create the object file
 		/// @return True if no errors, or a const char* representing the error
 		Expected<bool, const char*> to_object_file(const char* path) noexcept;
 
-		/// @brief Optimizes the generated IR
+		/// @brief Writes the IR as bitcode, with the summary used by ThinLTO
+		/// @param path The path where to create the bitcode file
+		/// @return True if no errors, or a const char* representing the error
+		Expected<bool, const char*> to_bitcode_file(const char* path) noexcept;
+
+		/// @brief Links the Colt runtime bitcode into the module.
+		/// Only the runtime functions used by the module are linked, and
+		/// are internalized so that they can be inlined by the optimizer.
+		/// Does nothing if the compiler was built without the runtime bitcode.
+		/// @return True if no errors, or a const char* representing the error
+		Expected<bool, const char*> link_runtime() noexcept;
+
+		/// @brief Optimizes the generated IR.
+		/// If '-emit-bc' was specified, runs the ThinLTO pre-link pipeline.
 		/// @param level The optimization level
 		void optimize(colt::gen::OptimizationLevel level) noexcept;
 	};	
 
+	/// @brief Returns the CPU for which to generate code ('-mcpu').
+	/// 'native' is replaced by the name of the CPU of the host.
+	/// @return The name of the CPU
+	std::string GetTargetCPU() noexcept;
+
+	/// @brief Returns the CPU features to enable or disable ('-mattr').
+	/// If the CPU is 'native', the features of the host are detected
+	/// and prepended to the features specified by the user.
+	/// @return Comma separated list of features
+	std::string GetTargetFeatures() noexcept;
+
+	/// @brief Links bitcode files produced with '-emit-bc' using ThinLTO.
+	/// Functions are imported across modules, then each module is optimized
+	/// and compiled in parallel, producing an object file per module.
+	/// @param files The paths of the bitcode files
+	/// @param output_prefix The prefix of the object files ('<prefix>.<n>.o')
+	/// @return True if no errors, or a std::string representing the error
+	Expected<bool, std::string> LinkThinLTO(llvm::ArrayRef<llvm::StringRef> files, llvm::StringRef output_prefix) noexcept;
+
 	/// @brief Generates the LLVM corresponding to a valid AST
 	/// @param ast The AST from which to generate IR
-	/// @param target_triple The target for which to generate IR
+	/// @param cache If not null, the functions it contains are only declared
 	/// @return IR or std::string representing the error (related to targets)
-	Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast) noexcept;
+	Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast, PTR<const IncrementalCache> cache = nullptr) noexcept;
 
 	/// @brief Class responsible of generating LLVM IR
 	class LLVMIRGenerator
@@ -78,12 +140,16 @@ namespace colt::gen
 		llvm::LLVMContext& context;
 		/// @brief The LLVM Module
 		llvm::Module& module;
+		/// @brief The context of the AST, from which the source code information is rebuilt
+		const lang::COLTContext& ast_ctx;
 		/// @brief The helper for generating IR
 		llvm::IRBuilder<> builder;
 		/// @brief Function map
 		Map<PTR<const lang::FnDeclExpr>, PTR<llvm::Function>> function_map;
 		/// @brief Contains all global variables
-		Map<StringView, PTR<llvm::GlobalVariable>> global_vars{};
+		Map<lang::SymbolID, PTR<llvm::GlobalVariable>> global_vars{};
+		/// @brief Contains the global of each string literal, keyed by its entry in AST::str_table
+		Map<PTR<const String>, PTR<llvm::Constant>> string_literals{};
 		/// @brief The IR to generate before the code in main
 		Vector<PTR<llvm::Value>> call_before_main{};
 		/// @brief Contains all local variables
@@ -96,6 +162,14 @@ namespace colt::gen
 		PTR<llvm::BasicBlock> loop_begin = nullptr;
 		/// @brief Current loop begin block (used for continue)
 		PTR<llvm::BasicBlock> loop_end = nullptr;
+		/// @brief The attributes inferred for the functions of the AST
+		FnAttributesInference fn_attributes;
+		/// @brief The helper for generating debug informations
+		llvm::DIBuilder dbg_builder;
+		/// @brief The compile unit, or nullptr if debug informations are not generated
+		PTR<llvm::DICompileUnit> dbg_unit = nullptr;
+		/// @brief The functions whose bodies are linked from the incremental cache, or nullptr
+		PTR<const IncrementalCache> cache;
 
 	public:
 		/// @brief No default constructor
@@ -109,13 +183,19 @@ namespace colt::gen
 		/// @param ast The AST to compile to IR
 		/// @param ctx The LLVMContext in which to store resulting informations
 		/// @param mod The module in which to write the IR
-		LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod) noexcept;
+		/// @param cache If not null, the functions it contains are only declared
+		LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod, PTR<const IncrementalCache> cache = nullptr) noexcept;
 
 	private:
 		/// @brief Generates IR for any expression by calling the
 		///        corresponding function.
 		void gen_ir(PTR<const lang::Expr> ptr) noexcept;
 
+		/// @brief Declares a function or a global variable, so that it can be
+		/// used before its definition (which '-parallel-parse' allows)
+		/// @param ptr The global expression to declare (other expressions are ignored)
+		void declare_global(PTR<const lang::Expr> ptr) noexcept;
+
 		/// @brief Generates IR for literal expressions
 		/// @param ptr The expression for which to generate the IR
 		void gen_literal(PTR<const lang::LiteralExpr> ptr) noexcept;
@@ -148,6 +228,17 @@ namespace colt::gen
 		/// @param ptr The expression for which to generate the IR
 		void gen_fn_def(PTR<const lang::FnDefExpr> ptr) noexcept;
 
+		/// @brief Sets the debug location of the instructions generated by the builder
+		/// to the beginning of an expression.
+		/// Does nothing if the current function has no debug informations.
+		/// @param ptr The expression whose location to use
+		void set_debug_location(PTR<const lang::Expr> ptr) noexcept;
+
+		/// @brief Adds the attributes inferred from the AST to a function
+		/// @param fn The function to which to add the attributes
+		/// @param attr The attributes of the function
+		void add_fn_attributes(PTR<llvm::Function> fn, const FnAttributes& attr) noexcept;
+
 		/// @brief Generates IR for function returns
 		/// @param ptr The expression for which to generate the IR
 		void gen_fn_ret(PTR<const lang::FnReturnExpr> ptr) noexcept;
@@ -164,15 +255,63 @@ namespace colt::gen
 		/// @param ptr The expression for which to generate the IR
 		void gen_condition(PTR<const lang::ConditionExpr> ptr) noexcept;
 
+		/// @brief Generates IR for switch expressions.
+		/// The switch is lowered to an LLVM 'switch' instruction.
+		/// @param ptr The expression for which to generate the IR
+		void gen_switch(PTR<const lang::SwitchExpr> ptr) noexcept;
+
 		/// @brief Generates IR for while expressions
 		/// @param ptr The expression for which to generate the IR
 		void gen_while_loop(PTR<const lang::WhileLoopExpr> ptr) noexcept;
 
+		/// @brief Generates IR for for loops.
+		/// The loop is lowered to a canonical loop: the induction variable
+		/// is a single PHI node, and the trip count is computed before the loop.
+		/// @param ptr The expression for which to generate the IR
+		void gen_for_loop(PTR<const lang::ForLoopExpr> ptr) noexcept;
+
 		void gen_break_continue(PTR<const lang::BreakContinueExpr> ptr) noexcept;
 
 		void gen_ptr_load(PTR<const lang::PtrLoadExpr> ptr) noexcept;
 		
 		void gen_ptr_store(PTR<const lang::PtrStoreExpr> ptr) noexcept;
+
+		/// @brief Generates IR for the address of an element of an array or a slice.
+		/// If the index was not proven to be in bounds, a check is generated.
+		/// @param ptr The expression for which to generate the IR
+		void gen_index(PTR<const lang::IndexExpr> ptr) noexcept;
+
+		/// @brief Generates IR for the length of a slice
+		/// @param ptr The expression for which to generate the IR
+		void gen_slice_len(PTR<const lang::SliceLenExpr> ptr) noexcept;
+
+		/// @brief Generates IR for conversions from array to slice
+		/// @param ptr The expression for which to generate the IR
+		void gen_to_slice(PTR<const lang::ToSliceExpr> ptr) noexcept;
+
+		/// @brief Generates IR for operations on vectors.
+		/// Floating point additions and multiplications reductions may be reassociated.
+		/// @param ptr The expression for which to generate the IR
+		void gen_vec_intrinsic(PTR<const lang::VecIntrinsicExpr> ptr) noexcept;
+
+		/// @brief Generates IR for the address of an addressable expression
+		/// @param ptr The VarReadExpr or PtrLoadExpr whose address to return
+		/// @return The address of the value of the expression
+		PTR<llvm::Value> gen_address(PTR<const lang::Expr> ptr) noexcept;
+
+		/// @brief Allocates a local variable in the entry block of the current function.
+		/// This keeps the size of the stack frame constant (even for variables declared
+		/// in loops) and allows the variable to be promoted to a register.
+		/// @param type The type of the variable
+		/// @param name The name of the variable
+		/// @return The allocation
+		PTR<llvm::AllocaInst> create_entry_alloca(PTR<llvm::Type> type, const llvm::Twine& name) noexcept;
+
+		/// @brief Promotes the local variables of the current function to registers.
+		/// This constructs SSA form (PHI nodes) directly after generating a function,
+		/// without running the optimization pipeline. Variables whose address is
+		/// taken stay on the stack.
+		void promote_locals() noexcept;
 		
 
 		/// @brief Converts a Colt type to an LLVM type
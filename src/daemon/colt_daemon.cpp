@@ -0,0 +1,269 @@
+/** @file colt_daemon.cpp
+* Contains definition of functions declared in 'colt_daemon.h'.
+*/
+
+#include "colt_daemon.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#ifndef COLT_WINDOWS
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif //!COLT_WINDOWS
+
+namespace colt
+{
+#ifndef COLT_WINDOWS
+  /// @brief The maximum count of strings in a request
+  static constexpr u32 MAX_REQUEST_STRINGS = 4096;
+  /// @brief The maximum size of a string in a request
+  static constexpr u32 MAX_REQUEST_STRING_SIZE = 1 << 20;
+
+  /// @brief Writes all the bytes of a buffer to a socket
+  /// @param fd The socket
+  /// @param data The buffer
+  /// @param size The size of the buffer
+  /// @return True on success
+  static bool WriteAll(int fd, const void* data, size_t size) noexcept
+  {
+    auto ptr = static_cast<const char*>(data);
+    while (size != 0)
+    {
+      auto written = ::write(fd, ptr, size);
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0)
+        return false;
+      ptr += written;
+      size -= static_cast<size_t>(written);
+    }
+    return true;
+  }
+
+  /// @brief Reads exactly 'size' bytes from a socket
+  /// @param fd The socket
+  /// @param data The buffer to fill
+  /// @param size The count of bytes to read
+  /// @return True on success
+  static bool ReadAll(int fd, void* data, size_t size) noexcept
+  {
+    auto ptr = static_cast<char*>(data);
+    while (size != 0)
+    {
+      auto read = ::read(fd, ptr, size);
+      if (read < 0 && errno == EINTR)
+        continue;
+      if (read <= 0)
+        return false;
+      ptr += read;
+      size -= static_cast<size_t>(read);
+    }
+    return true;
+  }
+
+  /// @brief Writes a string prefixed by its size
+  /// @param fd The socket
+  /// @param str The string to write
+  /// @return True on success
+  static bool WriteString(int fd, StringView str) noexcept
+  {
+    u32 size = static_cast<u32>(str.get_size());
+    return WriteAll(fd, &size, sizeof(size)) && WriteAll(fd, str.get_data(), size);
+  }
+
+  /// @brief Fills the address of a Unix domain socket
+  /// @param addr The address to fill
+  /// @param socket_path The path of the socket
+  /// @return False if the path is too long
+  static bool ToSocketAddress(sockaddr_un& addr, const char* socket_path) noexcept
+  {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (std::strlen(socket_path) >= sizeof(addr.sun_path))
+      return false;
+    std::strcpy(addr.sun_path, socket_path);
+    return true;
+  }
+
+  /// @brief Writes the exit status of a request, which ends its output
+  /// @param fd The socket
+  /// @param status The exit status
+  /// @return True on success
+  static bool WriteStatus(int fd, i32 status) noexcept
+  {
+    return WriteAll(fd, &status, sizeof(status));
+  }
+
+  /// @brief Reads a request from a client and serves it
+  /// @param client The socket of the client
+  /// @param fn The function serving the request
+  static void ServeClient(int client, DaemonRequestFn fn) noexcept
+  {
+    //Request: count of strings, then the working directory and the arguments
+    u32 count;
+    if (!ReadAll(client, &count, sizeof(count)) || count == 0 || count > MAX_REQUEST_STRINGS)
+      return;
+    std::vector<std::string> strings;
+    for (u32 i = 0; i < count; i++)
+    {
+      u32 size;
+      if (!ReadAll(client, &size, sizeof(size)) || size > MAX_REQUEST_STRING_SIZE)
+        return;
+      std::string str(size, '\0');
+      if (!ReadAll(client, str.data(), size))
+        return;
+      strings.push_back(std::move(str));
+    }
+
+    std::error_code ec;
+    std::filesystem::current_path(strings[0], ec);
+    if (ec)
+    {
+      const char msg[] = "Could not change to the working directory of the client!\n";
+      WriteAll(client, msg, sizeof(msg) - 1);
+      WriteStatus(client, EXIT_FAILURE);
+      return;
+    }
+
+    //The name of the program is not sent
+    std::vector<const char*> argv = { "colt" };
+    for (size_t i = 1; i < strings.size(); i++)
+      argv.push_back(strings[i].c_str());
+
+    //The output of the request is sent to the client
+    std::fflush(stdout);
+    std::fflush(stderr);
+    int saved_out = ::dup(STDOUT_FILENO);
+    int saved_err = ::dup(STDERR_FILENO);
+    ::dup2(client, STDOUT_FILENO);
+    ::dup2(client, STDERR_FILENO);
+
+    int status = fn(static_cast<int>(argv.size()), argv.data());
+
+    std::fflush(stdout);
+    std::fflush(stderr);
+    ::dup2(saved_out, STDOUT_FILENO);
+    ::dup2(saved_err, STDERR_FILENO);
+    ::close(saved_out);
+    ::close(saved_err);
+    WriteStatus(client, static_cast<i32>(status));
+  }
+#endif //!COLT_WINDOWS
+
+  Expected<bool, const char*> ListenDaemon(const char* socket_path, DaemonRequestFn fn) noexcept
+  {
+#ifndef COLT_WINDOWS
+    sockaddr_un addr;
+    if (!ToSocketAddress(addr, socket_path))
+      return { Error, "The path of the socket is too long!" };
+
+    int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+      return { Error, "Could not create the socket!" };
+    ON_EXIT{ ::close(server); };
+
+    //The socket of a daemon that was killed would prevent binding
+    struct stat info;
+    if (::lstat(socket_path, &info) == 0 && S_ISSOCK(info.st_mode))
+      ::unlink(socket_path);
+    //Any user able to connect could compile and run code as the owner of the daemon:
+    //the socket is created with mode 0600 (the umask is process-wide, but the
+    //daemon does not create files from other threads while starting)
+    mode_t previous_mask = ::umask(S_IRWXG | S_IRWXO | S_IXUSR);
+    int bind_result = ::bind(server, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+    ::umask(previous_mask);
+    if (bind_result < 0 || ::listen(server, 16) < 0)
+      return { Error, "Could not listen on the socket!" };
+    ON_EXIT{ ::unlink(socket_path); };
+
+    //A client disconnecting must not kill the daemon
+    std::signal(SIGPIPE, SIG_IGN);
+    io::PrintMessage("Listening for requests on '{}'...", socket_path);
+    for (;;)
+    {
+      int client = ::accept(server, nullptr, nullptr);
+      if (client < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        return { Error, "Could not accept a connection!" };
+      }
+      ServeClient(client, fn);
+      ::close(client);
+    }
+#else
+    return { Error, "The daemon requires Unix domain sockets, which are not supported on this platform!" };
+#endif //!COLT_WINDOWS
+  }
+
+  Expected<int, const char*> ConnectDaemon(const char* socket_path, int argc, const char** argv) noexcept
+  {
+#ifndef COLT_WINDOWS
+    sockaddr_un addr;
+    if (!ToSocketAddress(addr, socket_path))
+      return { Error, "The path of the socket is too long!" };
+
+    int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0)
+      return { Error, "Could not create the socket!" };
+    ON_EXIT{ ::close(server); };
+    if (::connect(server, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0)
+      return { Error, "Could not connect to the daemon!" };
+
+    std::error_code ec;
+    auto working_dir = std::filesystem::current_path(ec).string();
+    if (ec)
+      return { Error, "Could not get the working directory!" };
+
+    Vector<StringView> strings;
+    strings.push_back(StringView{ working_dir.data(), working_dir.data() + working_dir.size() });
+    for (int i = 1; i < argc; i++)
+    {
+      if (StringView{ argv[i] } == "-connect")
+      {
+        ++i;
+        continue;
+      }
+      strings.push_back(StringView{ argv[i] });
+    }
+
+    u32 count = static_cast<u32>(strings.get_size());
+    bool sent = WriteAll(server, &count, sizeof(count));
+    for (size_t i = 0; i < strings.get_size() && sent; i++)
+      sent = WriteString(server, strings[i]);
+    if (!sent)
+      return { Error, "Could not send the request to the daemon!" };
+
+    //The daemon closes the connection once the request is served.
+    //The last bytes received are the status, which are not printed.
+    char buffer[4096 + sizeof(i32)];
+    size_t pending = 0;
+    for (;;)
+    {
+      auto read = ::read(server, buffer + pending, sizeof(buffer) - pending);
+      if (read < 0 && errno == EINTR)
+        continue;
+      if (read <= 0)
+        break;
+      pending += static_cast<size_t>(read);
+      if (pending <= sizeof(i32))
+        continue;
+      std::fwrite(buffer, 1, pending - sizeof(i32), stdout);
+      std::memmove(buffer, buffer + pending - sizeof(i32), sizeof(i32));
+      pending = sizeof(i32);
+    }
+    std::fflush(stdout);
+    if (pending != sizeof(i32))
+      return { Error, "The daemon closed the connection without sending the status of the request!" };
+    i32 status;
+    std::memcpy(&status, buffer, sizeof(status));
+    return static_cast<int>(status);
+#else
+    return { Error, "The daemon requires Unix domain sockets, which are not supported on this platform!" };
+#endif //!COLT_WINDOWS
+  }
+}
@@ -0,0 +1,39 @@
+/** @file colt_daemon.h
+* Contains the local socket protocol of the compiler daemon.
+* A daemon ('-daemon <path>') stays resident after initializing the code
+* generators, and serves the requests sent to the Unix domain socket <path>.
+* A client ('-connect <path>') sends its working directory and its
+* arguments, then prints the output of the request until the daemon
+* closes the connection. The last 4 bytes sent by the daemon are not
+* part of the output: they are the exit status of the request.
+* Requests are served one at a time.
+*/
+
+#ifndef HG_COLT_DAEMON
+#define HG_COLT_DAEMON
+
+#include <util/colt_pch.h>
+
+namespace colt
+{
+  /// @brief Function serving a request, whose output (stdout and stderr) is sent to the client.
+  /// Returns the exit status of the request, with which the client exits.
+  using DaemonRequestFn = int(*)(int argc, const char** argv) noexcept;
+
+  /// @brief Listens on a Unix domain socket, serving requests until the process is killed.
+  /// The working directory is changed to the one of the client for each request.
+  /// @param socket_path The path of the socket to create
+  /// @param fn The function to call for each request (with the arguments of the client)
+  /// @return Error message or true
+  Expected<bool, const char*> ListenDaemon(const char* socket_path, DaemonRequestFn fn) noexcept;
+
+  /// @brief Sends the arguments of the current invocation (without '-connect') to
+  /// a daemon, and prints the output of the request.
+  /// @param socket_path The path of the socket on which the daemon listens
+  /// @param argc The count of arguments of the invocation
+  /// @param argv The arguments of the invocation
+  /// @return Error message or the exit status of the request
+  Expected<int, const char*> ConnectDaemon(const char* socket_path, int argc, const char** argv) noexcept;
+}
+
+#endif //!HG_COLT_DAEMON
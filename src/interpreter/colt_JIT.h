@@ -16,14 +16,18 @@
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/ExecutionEngine/JITEventListener.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/ProfileData/InstrProf.h>
 #include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Scalar/GVN.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
 #include <memory>
 #include <code_gen/llvm_ir_gen.h>
 
@@ -44,20 +48,219 @@ namespace colt::gen
 
     /// @brief Adds generated IR to compile
     /// @param IR The IR to compile
+    /// @param dylib The library in which to add the IR, or nullptr for the main library
     /// @return success if no error are encountered
-    llvm::Error addModule(GeneratedIR&& IR) noexcept
+    llvm::Error addModule(GeneratedIR&& IR, PTR<llvm::orc::JITDylib> dylib = nullptr) noexcept
     {      
-      if (auto err = JIT->addLazyIRModule(llvm::orc::ThreadSafeModule{ std::move(IR.module), std::move(IR.context)}))
+      if (auto err = JIT->addLazyIRModule(dylib ? *dylib : JIT->getMainJITDylib(),
+        llvm::orc::ThreadSafeModule{ std::move(IR.module), std::move(IR.context)}))
         return err;
       return llvm::Error::success();
     }
 
+    /// @brief Adds instrumented IR ('-fprofile-generate') to compile, with the LLVM profile runtime.
+    /// The module is compiled at once (not lazily), so that each section of the profile
+    /// data is contiguous: the bounds of the sections, which the linker defines for
+    /// executables, are defined in the module (see DefineProfileSection).
+    /// The profile is written by writeProfile.
+    /// @param IR The instrumented IR to compile
+    /// @param dylib The library in which to add the IR and the profile runtime
+    /// @return success if no error are encountered
+    llvm::Error addProfiledModule(GeneratedIR&& IR, llvm::orc::JITDylib& dylib) noexcept
+    {
+      using namespace llvm;
+#ifdef COLT_PROFILE_LIBRARY
+      const Triple triple(IR.module->getTargetTriple());
+      //The sections are ordered by name ('$A'...'$Z') by the linker on Windows
+      if (triple.isOSBinFormatCOFF())
+        return make_error<StringError>("The JIT cannot run instrumented code on Windows!", inconvertibleErrorCode());
+
+      //Each library has its own copy of the runtime (and of its state)
+      auto runtime = orc::StaticLibraryDefinitionGenerator::Load(JIT->getObjLinkingLayer(),
+        COLT_PROFILE_LIBRARY, triple);
+      if (!runtime)
+        return runtime.takeError();
+      dylib.addGenerator(std::move(*runtime));
+
+      for (auto kind : { IPSK_data, IPSK_cnts, IPSK_name, IPSK_vnodes })
+        DefineProfileSection(*IR.module, kind);
+      //Read by the runtime to write the build ID, which JITed code does not have
+      if (triple.isOSBinFormatELF() && IR.module->getNamedValue("__ehdr_start") == nullptr)
+      {
+        auto header_t = ArrayType::get(Type::getInt8Ty(IR.module->getContext()), 64);
+        new GlobalVariable(*IR.module, header_t, true, GlobalValue::ExternalLinkage,
+          ConstantAggregateZero::get(header_t), "__ehdr_start");
+      }
+      return JIT->addIRModule(dylib,
+        orc::ThreadSafeModule{ std::move(IR.module), std::move(IR.context) });
+#else
+      return make_error<StringError>("Colt was built without the LLVM profile runtime: instrumented code cannot be run!",
+        inconvertibleErrorCode());
+#endif //COLT_PROFILE_LIBRARY
+    }
+
+    /// @brief Writes the profile collected by code added through addProfiledModule.
+    /// The path of the profile is 'default_<id>.profraw', or the one specified
+    /// by the 'LLVM_PROFILE_FILE' environment variable.
+    /// @param dylib The library containing the instrumented code
+    /// @return success if no error are encountered
+    llvm::Error writeProfile(llvm::orc::JITDylib& dylib) noexcept
+    {
+      using namespace llvm;
+
+      //The runtime registers the writing of the profile at exit in executables
+      auto initialize = lookup("__llvm_profile_initialize_file", &dylib);
+      if (!initialize)
+        return initialize.takeError();
+      auto write = lookup("__llvm_profile_write_file", &dylib);
+      if (!write)
+        return write.takeError();
+      reinterpret_cast<void(*)()>(initialize->getValue())();
+      if (reinterpret_cast<int(*)()>(write->getValue())() != 0)
+        return make_error<StringError>("Could not write the profile!", inconvertibleErrorCode());
+      return Error::success();
+    }
+
+    /// @brief Adds an object file (of an imported module) to link with the generated code
+    /// @param path The path of the object file
+    /// @param dylib The library in which to add the object, or nullptr for the main library
+    /// @return success if no error are encountered
+    llvm::Error addObjectFile(llvm::StringRef path, PTR<llvm::orc::JITDylib> dylib = nullptr) noexcept
+    {
+      auto buffer = llvm::MemoryBuffer::getFile(path);
+      if (!buffer)
+        return llvm::errorCodeToError(buffer.getError());
+      return JIT->addObjectFile(dylib ? *dylib : JIT->getMainJITDylib(), std::move(*buffer));
+    }
+
     /// @brief Lookups a symbol in the generated code
     /// @param str The name of the symbol
+    /// @param dylib The library in which to search, or nullptr for the main library
     /// @return The symbol if found or error
-    llvm::Expected<llvm::orc::ExecutorAddr> lookup(llvm::StringRef str) noexcept
+    llvm::Expected<llvm::orc::ExecutorAddr> lookup(llvm::StringRef str, PTR<llvm::orc::JITDylib> dylib = nullptr) noexcept
+    {
+      return JIT->lookup(dylib ? *dylib : JIT->getMainJITDylib(), str);
+    }
+
+    /// @brief Creates a library, which can use the symbols of the process.
+    /// Programs compiled in different libraries can define the same symbols,
+    /// which allows reusing the JIT for multiple programs.
+    /// @param name The unique name of the library
+    /// @return The library or error
+    llvm::Expected<llvm::orc::JITDylib&> createDylib(llvm::StringRef name) noexcept
     {
-      return JIT->lookup(str);
+      auto dylib = JIT->createJITDylib(name.str());
+      if (!dylib)
+        return dylib.takeError();
+      dylib->addToLinkOrder(JIT->getMainJITDylib());
+      return *dylib;
+    }
+
+    /// @brief Removes a library, freeing the code compiled in it
+    /// @param dylib The library to remove
+    /// @return success if no error are encountered
+    llvm::Error removeDylib(llvm::orc::JITDylib& dylib) noexcept
+    {
+      return JIT->getExecutionSession().removeJITDylib(dylib);
+    }
+
+    /// @brief Groups the globals of a section of the profile data in a single global,
+    /// and defines the symbols of the bounds of the section read by the profile runtime
+    /// ('__start_<section>' and '__stop_<section>' on ELF, 'section$start$...' on Mach-O).
+    /// @param mod The instrumented module
+    /// @param kind The kind of the section
+    static void DefineProfileSection(llvm::Module& mod, llvm::InstrProfSectKind kind) noexcept
+    {
+      using namespace llvm;
+
+      const Triple triple(mod.getTargetTriple());
+      const std::string section = getInstrProfSectionName(kind, triple.getObjectFormat());
+      SmallVector<GlobalVariable*, 16> globals;
+      for (auto& global : mod.globals())
+      {
+        if (global.getSection() == section)
+          globals.push_back(&global);
+      }
+      if (globals.empty())
+        return;
+
+      //The lists of used globals can only contain globals, not their elements
+      for (bool compiler_used : { false, true })
+      {
+        SmallVector<GlobalValue*, 16> used;
+        if (auto list = collectUsedGlobalVariables(mod, used, compiler_used))
+          list->eraseFromParent();
+        erase_if(used, [&](GlobalValue* value) { return is_contained(globals, value); });
+        if (used.empty())
+          continue;
+        if (compiler_used)
+          appendToCompilerUsed(mod, used);
+        else
+          appendToUsed(mod, used);
+      }
+
+      SmallVector<Type*, 16> types;
+      SmallVector<Constant*, 16> values;
+      Align alignment = Align(1);
+      bool is_constant = true;
+      for (auto global : globals)
+      {
+        types.push_back(global->getValueType());
+        values.push_back(global->getInitializer());
+        alignment = std::max(alignment, global->getAlign().valueOrOne());
+        is_constant &= global->isConstant();
+      }
+      auto section_t = StructType::get(mod.getContext(), types);
+      auto grouped = new GlobalVariable(mod, section_t, is_constant, GlobalValue::PrivateLinkage,
+        ConstantStruct::get(section_t, values), "__colt_prf");
+      grouped->setSection(section);
+      grouped->setAlignment(alignment);
+      appendToCompilerUsed(mod, { grouped });
+
+      auto i32_t = Type::getInt32Ty(mod.getContext());
+      for (size_t i = 0; i < globals.size(); i++)
+      {
+        Constant* indices[] = { ConstantInt::get(i32_t, 0), ConstantInt::get(i32_t, i) };
+        auto element = ConstantExpr::getInBoundsGetElementPtr(section_t, grouped, indices);
+        //Also replaces the uses in the initializer of 'grouped'
+        globals[i]->replaceAllUsesWith(
+          ConstantExpr::getPointerBitCastOrAddrSpaceCast(element, globals[i]->getType()));
+        globals[i]->eraseFromParent();
+      }
+
+      const std::string name = getInstrProfSectionName(kind, triple.getObjectFormat(), false);
+      const bool is_macho = triple.isOSBinFormatMachO();
+      auto end = ConstantExpr::getGetElementPtr(section_t, grouped,
+        ConstantInt::get(Type::getInt64Ty(mod.getContext()), 1));
+      GlobalAlias::create(section_t, 0, GlobalValue::ExternalLinkage,
+        is_macho ? "\1section$start$__DATA$" + name : "__start_" + name, grouped, &mod);
+      GlobalAlias::create(section_t, 0, GlobalValue::ExternalLinkage,
+        is_macho ? "\1section$end$__DATA$" + name : "__stop_" + name, end, &mod);
+    }
+
+    /// @brief Creates the layer linking the compiled objects.
+    /// The objects are registered to GDB (and perf if LLVM was built with
+    /// LLVM_USE_PERF) so that JITed code can be mapped back to the source.
+    /// @param ES The execution session
+    /// @param triple The target triple
+    /// @return The object linking layer
+    static llvm::Expected<std::unique_ptr<llvm::orc::ObjectLayer>> CreateObjectLayer(llvm::orc::ExecutionSession& ES, const llvm::Triple& triple) noexcept
+    {
+      using namespace llvm;
+
+      auto layer = std::make_unique<orc::RTDyldObjectLinkingLayer>(ES,
+        []() { return std::make_unique<SectionMemoryManager>(); });
+      //As done by the default layer of LLJIT: the flags of the symbols
+      //of COFF objects do not match the flags of their IR
+      if (triple.isOSBinFormatCOFF())
+      {
+        layer->setOverrideObjectFlagsWithResponsibilityFlags(true);
+        layer->setAutoClaimResponsibilityForObjectSymbols(true);
+      }
+      layer->registerJITEventListener(*JITEventListener::createGDBRegistrationListener());
+      if (auto perf = JITEventListener::createPerfJITEventListener())
+        layer->registerJITEventListener(*perf);
+      return std::unique_ptr<orc::ObjectLayer>(std::move(layer));
     }
 
     /// @brief Creates an instance of the JIT
@@ -66,7 +269,21 @@ namespace colt::gen
     {
       using namespace llvm;
 
-      auto JIT = orc::LLLazyJITBuilder().create();
+      auto JTMB = orc::JITTargetMachineBuilder::detectHost();
+      if (!JTMB)
+        return JTMB.takeError();
+      //The host features are already detected for 'native'
+      if (StringRef(args::TargetCPU) != "native" && StringRef(args::TargetCPU) != "generic")
+        JTMB->setCPU(args::TargetCPU);
+      SmallVector<StringRef, 8> features;
+      StringRef(args::TargetAttr).split(features, ',', -1, false);
+      for (auto feature : features)
+        JTMB->getFeatures().AddFeature(feature);
+
+      auto JIT = orc::LLLazyJITBuilder()
+        .setJITTargetMachineBuilder(std::move(*JTMB))
+        .setObjectLinkingLayerCreator(&CreateObjectLayer)
+        .create();
       if (!JIT)
         return JIT.takeError();
       const DataLayout& DL = (*JIT)->getDataLayout();
@@ -4,6 +4,19 @@
 
 using namespace colt;
 
+template<typename... Args>
+/// @brief Prints to 'stdout' followed by a new line.
+/// The runtime does not use 'io::Print', whose stream depends on the
+/// options of the compiler ('io::GetPrintStream'), which it is not linked with.
+/// @tparam ...Args Pack of types to format
+/// @param fmt The format string, using {fmt} syntax
+/// @param ...args The arguments to format
+static void RuntimePrint(fmt::format_string<Args...> fmt, Args&&... args) noexcept
+{
+  fmt::print(stdout, fmt, std::forward<Args>(args)...);
+  std::fputc('\n', stdout);
+}
+
 COLT_EXPORT i64 _ColtRand(i64 a, i64 b)
 {
   static std::mt19937 generator(std::random_device{}());
@@ -11,27 +24,27 @@ COLT_EXPORT i64 _ColtRand(i64 a, i64 b)
   return distr(generator);
 }
 
-COLT_EXPORT void _ColtPrinti8(i8 a)                 { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrinti16(i16 a)               { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrinti32(i32 a)               { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrinti64(i64 a)               { io::Print("{}", a); }
+COLT_EXPORT void _ColtPrinti8(i8 a)                 { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrinti16(i16 a)               { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrinti32(i32 a)               { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrinti64(i64 a)               { RuntimePrint("{}", a); }
 
-COLT_EXPORT void _ColtPrintu8(u8 a)                 { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrintu16(u16 a)               { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrintu32(u32 a)               { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrintu64(u64 a)               { io::Print("{}", a); }
+COLT_EXPORT void _ColtPrintu8(u8 a)                 { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrintu16(u16 a)               { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrintu32(u32 a)               { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrintu64(u64 a)               { RuntimePrint("{}", a); }
 
-COLT_EXPORT void _ColtPrintu8HEX(u8 a)              { io::Print("0x{:X}", a); }
-COLT_EXPORT void _ColtPrintu16HEX(u16 a)            { io::Print("0x{:X}", a); }
-COLT_EXPORT void _ColtPrintu32HEX(u32 a)            { io::Print("0x{:X}", a); }
-COLT_EXPORT void _ColtPrintu64HEX(u64 a)            { io::Print("0x{:X}", a); }
+COLT_EXPORT void _ColtPrintu8HEX(u8 a)              { RuntimePrint("0x{:X}", a); }
+COLT_EXPORT void _ColtPrintu16HEX(u16 a)            { RuntimePrint("0x{:X}", a); }
+COLT_EXPORT void _ColtPrintu32HEX(u32 a)            { RuntimePrint("0x{:X}", a); }
+COLT_EXPORT void _ColtPrintu64HEX(u64 a)            { RuntimePrint("0x{:X}", a); }
 
-COLT_EXPORT void _ColtPrintbool(bool a)             { io::Print("{}", a); }
+COLT_EXPORT void _ColtPrintbool(bool a)             { RuntimePrint("{}", a); }
 
-COLT_EXPORT void _ColtPrintf32(f32 a)               { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrintf64(f64 a)               { io::Print("{}", a); }
+COLT_EXPORT void _ColtPrintf32(f32 a)               { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrintf64(f64 a)               { RuntimePrint("{}", a); }
 
-COLT_EXPORT void _ColtPrintchar(char a)             { io::Print("{}", a); }
-COLT_EXPORT void _ColtPrintlstring(lstring a)       { io::Print("{}", a); }
+COLT_EXPORT void _ColtPrintchar(char a)             { RuntimePrint("{}", a); }
+COLT_EXPORT void _ColtPrintlstring(lstring a)       { RuntimePrint("{}", a); }
 
-COLT_EXPORT void _ColtPrintPTR(PTR<const void> a)   { io::Print("{}", a); }
+COLT_EXPORT void _ColtPrintPTR(PTR<const void> a)   { RuntimePrint("{}", a); }
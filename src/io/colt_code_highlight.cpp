@@ -19,7 +19,7 @@ namespace colt::io
     else if (tkn <= TKN_DOUBLE_L)
       return io::BrightGreenF;
     else if (tkn == TKN_BOOL_L
-      || (tkn == TKN_KEYWORD_EXTERN || tkn == TKN_KEYWORD_VAR)
+      || (tkn == TKN_KEYWORD_EXTERN || tkn == TKN_KEYWORD_VAR || tkn == TKN_KEYWORD_IMPORT)
       || (TKN_KEYWORD_CONST <= tkn && tkn <= TKN_KEYWORD_BIT_AS))
       return io::BlueF;
     else if ((TKN_KEYWORD_IF <= tkn && tkn <= TKN_KEYWORD_RETURN)
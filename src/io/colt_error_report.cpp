@@ -2,21 +2,277 @@
 #include "colt_error_report.h"
 #include "colt_code_highlight.h"
 
+namespace colt::lang
+{
+	/// @brief The active sink (shared by all threads), or nullptr
+	static std::atomic<PTR<ReportSink>> ActiveSink = nullptr;
+	/// @brief The count of reports generated, used to order reports on the same location
+	static std::atomic<u64> ReportOrder = 0;
+	/// @brief Protects against interleaving with reports written without sink, and 'ActiveCapture'
+	static std::mutex WriteMutex;
+	/// @brief The active capture, or nullptr
+	static PTR<ReportCapture> ActiveCapture = nullptr;
+
+	/// @brief Writes a buffer to 'stdout' in a single write
+	/// @param text The text to write
+	static void WriteReports(StringView text) noexcept
+	{
+		std::scoped_lock lock{ WriteMutex };
+		if (ActiveCapture != nullptr)
+			ActiveCapture->add(text);
+		std::fwrite(text.get_data(), 1, text.get_size(), stdout);
+	}
+
+	/// @brief Writes a string as a JSON string (with quotes)
+	/// @param out The buffer to which to write
+	/// @param str The string to escape
+	static void WriteJSONString(fmt::memory_buffer& out, StringView str) noexcept
+	{
+		auto out_it = std::back_inserter(out);
+		out.push_back('"');
+		for (size_t i = 0; i < str.get_size(); i++)
+		{
+			char chr = str[i];
+			switch (chr)
+			{
+			break; case '"': fmt::format_to(out_it, "\\\"");
+			break; case '\\': fmt::format_to(out_it, "\\\\");
+			break; case '\n': fmt::format_to(out_it, "\\n");
+			break; case '\r': fmt::format_to(out_it, "\\r");
+			break; case '\t': fmt::format_to(out_it, "\\t");
+			break; default:
+				if (static_cast<unsigned char>(chr) < 0x20)
+					fmt::format_to(out_it, "\\u{:04x}", static_cast<unsigned>(chr));
+				else
+					out.push_back(chr);
+			}
+		}
+		out.push_back('"');
+	}
+
+	/// @brief Returns the column (starting at 1) of a character of the source code
+	/// @param lines The lines containing the character
+	/// @param chr Pointer to the character
+	/// @return The column of the character
+	static size_t GetColumn(StringView lines, const char* chr) noexcept
+	{
+		const char* begin = lines.get_data();
+		//The expression may be outside of the lines (end of file)
+		if (chr < begin || chr > lines.end())
+			return 1;
+		const char* line_begin = chr;
+		while (line_begin != begin && line_begin[-1] != '\n')
+			--line_begin;
+		return static_cast<size_t>(chr - line_begin) + 1;
+	}
+
+	/// @brief Formats a report as a JSON object on a single line
+	/// @param out The buffer to which to write
+	/// @param kind The kind of the report
+	/// @param src_info The source information of the report
+	/// @param message The formatted message
+	static void FormatJSONReport(fmt::memory_buffer& out, ReportKind kind, const SourceCodeExprInfo& src_info, StringView message) noexcept
+	{
+		auto out_it = std::back_inserter(out);
+		fmt::format_to(out_it, "{{\"severity\":\"{}\",\"message\":",
+			kind == ReportKind::ERROR ? "error" : (kind == ReportKind::WARNING ? "warning" : "message"));
+		WriteJSONString(out, message);
+		if (src_info.is_valid())
+		{
+			//The end column is the one of the last character of the expression
+			auto expr = src_info.expression;
+			auto last = expr.get_data() + expr.get_size() - as<size_t>(expr.get_size() != 0);
+			fmt::format_to(out_it, ",\"line_begin\":{},\"column_begin\":{},\"line_end\":{},\"column_end\":{}",
+				src_info.line_begin, GetColumn(src_info.lines, expr.get_data()),
+				src_info.line_end, GetColumn(src_info.lines, last));
+		}
+		fmt::format_to(out_it, "}}\n");
+	}
+
+	ReportSink::ReportSink() noexcept
+		: error_limit(args::ErrorLimit), previous(ActiveSink.exchange(this)) {}
+
+	ReportSink::~ReportSink() noexcept
+	{
+		ActiveSink.store(previous);
+		flush();
+	}
+
+	void ReportSink::add(ReportKind kind, const SourceCodeExprInfo& src_info, std::string&& text) noexcept
+	{
+		if (kind == ReportKind::ERROR)
+		{
+			//Errors past the limit are not printed
+			auto count = error_count.fetch_add(1, std::memory_order_relaxed);
+			if (error_limit != 0 && count >= error_limit)
+				return;
+		}
+		if (text.empty())
+			return;
+
+		std::scoped_lock lock{ mutex };
+		records.push_back(Record{ src_info.line_begin, src_info.expression.get_data(),
+			ReportOrder.fetch_add(1, std::memory_order_relaxed), std::move(text) });
+	}
+
+	void ReportSink::flush() noexcept
+	{
+		std::scoped_lock lock{ mutex };
+		//Reports without source information come first, in generation order
+		std::sort(records.get_data(), records.get_data() + records.get_size(),
+			[](const Record& a, const Record& b)
+			{
+				if (a.line != b.line)
+					return a.line < b.line;
+				if (a.location != b.location)
+					return std::less<const char*>{}(a.location, b.location);
+				return a.order < b.order;
+			});
+
+		fmt::memory_buffer out;
+		for (size_t i = 0; i < records.get_size(); i++)
+			out.append(records[i].text.data(), records[i].text.data() + records[i].text.size());
+		if (is_limit_reached() && !args::NoError && args::DiagFormat == args::DiagnosticsFormat::JSON)
+		{
+			auto message = fmt::format("Error limit reached: stopped parsing after {} errors!", error_limit);
+			FormatJSONReport(out, ReportKind::ERROR, {}, StringView{ message.data(), message.data() + message.size() });
+		}
+		else if (is_limit_reached() && !args::NoError)
+		{
+			auto out_it = std::back_inserter(out);
+			if (!args::NoColor)
+				fmt::format_to(out_it, fg(fmt::color::red) | fmt::emphasis::bold, "Error: ");
+			else
+				fmt::format_to(out_it, "Error: ");
+			fmt::format_to(out_it, "Error limit reached: stopped parsing after {} errors!\n", error_limit);
+		}
+		records.clear();
+		WriteReports(StringView{ out.data(), out.data() + out.size() });
+	}
+
+	ReportCapture::ReportCapture(std::string& text) noexcept
+		: text(text)
+	{
+		std::scoped_lock lock{ WriteMutex };
+		previous = std::exchange(ActiveCapture, this);
+	}
+
+	ReportCapture::~ReportCapture() noexcept
+	{
+		std::scoped_lock lock{ WriteMutex };
+		ActiveCapture = previous;
+	}
+
+	void WriteCapturedReports(StringView reports) noexcept
+	{
+		WriteReports(reports);
+	}
+
+	bool IsErrorLimitReached() noexcept
+	{
+		auto sink = ActiveSink.load();
+		return sink != nullptr && sink->is_limit_reached();
+	}
+}
+
 namespace colt::lang::details
 {
-	void print_single_line(io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept
+	/// @brief Formats a report as text, with the source code highlighted
+	/// @param out The buffer to which to write
+	/// @param kind The kind of the report
+	/// @param src_info The source information to highlight
+	/// @param message The formatted message
+	static void FormatTextReport(fmt::memory_buffer& out, ReportKind kind, const SourceCodeExprInfo& src_info, StringView message) noexcept
+	{
+		auto out_it = std::back_inserter(out);
+		io::Color highlight = io::CyanF;
+		switch (kind)
+		{
+		break; case ReportKind::MESSAGE:
+			highlight = io::CyanF;
+			if (!args::NoColor)
+				fmt::format_to(out_it, fg(fmt::color::cornflower_blue) | fmt::emphasis::bold, "Message: ");
+			else
+				fmt::format_to(out_it, "Message: ");
+		break; case ReportKind::WARNING:
+			highlight = io::YellowF;
+			if (!args::NoColor)
+				fmt::format_to(out_it, fg(fmt::color::yellow) | fmt::emphasis::bold, "Warning: ");
+			else
+				fmt::format_to(out_it, "Warning: ");
+		break; case ReportKind::ERROR:
+			highlight = io::BrightRedB;
+			if (!args::NoColor)
+				fmt::format_to(out_it, fg(fmt::color::red) | fmt::emphasis::bold, "Error: ");
+			else
+				fmt::format_to(out_it, "Error: ");
+		}
+		out.append(message.get_data(), message.get_data() + message.get_size());
+		out.push_back('\n');
+
+		if (!src_info.is_valid())
+			return;
+
+		StringView begin_line = { src_info.lines.get_data(), src_info.expression.get_data() };
+		StringView end_line;
+
+		//If lexeme.get_size() == 0, then the lexeme will be outside of the line_strv:
+		//This is because the only case where the lexeme is empty is due to reaching
+		//the last lexeme.
+		if (src_info.expression.get_size() == 0)
+		{
+			end_line = StringView{ src_info.expression.get_data(), src_info.expression.get_data() };
+			begin_line = src_info.lines;
+		}
+		else
+			end_line = StringView{ src_info.expression.get_data() + src_info.expression.get_size(), src_info.lines.get_data() + src_info.lines.get_size() };
+
+		size_t line_nb_size = fmt::formatted_size("{}", src_info.line_end);
+		if (src_info.is_single_line())
+			print_single_line(out, highlight, src_info, begin_line, end_line, line_nb_size);
+		else
+			print_multiple_lines(out, highlight, src_info, begin_line, end_line, line_nb_size);
+	}
+
+	void Report(ReportKind kind, const SourceCodeExprInfo& src_info, std::string&& message) noexcept
+	{
+		if (kind == ReportKind::ERROR)
+			io::CountError();
+		auto sink = ActiveSink.load();
+		//Once the error limit is reached, reports are only counted
+		if (message.empty() || (sink != nullptr && sink->is_limit_reached()))
+		{
+			if (sink != nullptr && kind == ReportKind::ERROR)
+				sink->count_error();
+			return;
+		}
+
+		fmt::memory_buffer out;
+		auto msg = StringView{ message.data(), message.data() + message.size() };
+		if (args::DiagFormat == args::DiagnosticsFormat::JSON)
+			FormatJSONReport(out, kind, src_info, msg);
+		else
+			FormatTextReport(out, kind, src_info, msg);
+
+		if (sink != nullptr)
+			sink->add(kind, src_info, std::string{ out.data(), out.size() });
+		else
+			WriteReports(StringView{ out.data(), out.data() + out.size() });
+	}
+
+	void print_single_line(fmt::memory_buffer& out, io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept
 	{
-		io::Print(" {} | {}{}{}{}{}", src_info.line_begin, io::HighlightCode{ begin_line },
+		fmt::format_to(std::back_inserter(out), " {} | {}{}{}{}{}\n", src_info.line_begin, io::HighlightCode{ begin_line },
 			highlight, src_info.expression, io::Reset, io::HighlightCode{ end_line });
 
 		auto sz = src_info.expression.get_size();
 		//So no overflow happens when the expression is empty
 		sz += as<size_t>(sz == 0);
 		sz -= 1;
-		io::Print(" {: <{}} | {: <{}}{:~<{}}^", "", line_nb_size, "", begin_line.get_size(), "", sz);
+		fmt::format_to(std::back_inserter(out), " {: <{}} | {: <{}}{:~<{}}^\n", "", line_nb_size, "", begin_line.get_size(), "", sz);
 	}
 	
-	void print_multiple_lines(io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept
+	void print_multiple_lines(fmt::memory_buffer& out, io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept
 	{
 		size_t offset = StringView::npos; //will overflow on first add
 		size_t previous_offset = 0;
@@ -35,11 +291,11 @@ namespace colt::lang::details
 				break;
 			}
 
-			io::Print(" {: >{}} | {}", current_line, line_nb_size,
+			fmt::format_to(std::back_inserter(out), " {: >{}} | {}\n", current_line, line_nb_size,
 				io::HighlightCode{ StringView{ begin_line.get_data() + previous_offset, begin_line.get_data() + offset } });
 			++current_line;
 		}
-		io::Print(" {: >{}} | {}{}{}{}", current_line, line_nb_size,
+		fmt::format_to(std::back_inserter(out), " {: >{}} | {}{}{}{}\n", current_line, line_nb_size,
 			io::HighlightCode{ StringView{ begin_line.get_data() + previous_offset, begin_line.end() } }, highlight,
 			StringView{ src_info.expression.get_data(), src_info.expression.get_data() + offset }, io::Reset);
 		++current_line;
@@ -56,11 +312,11 @@ namespace colt::lang::details
 				break;
 			}
 
-			io::Print(" {: >{}} | {}{}{}", current_line, line_nb_size, highlight,
+			fmt::format_to(std::back_inserter(out), " {: >{}} | {}{}{}\n", current_line, line_nb_size, highlight,
 				StringView{ src_info.expression.get_data() + previous_offset, src_info.expression.get_data() + offset }, io::Reset);
 			++current_line;
 		}
-		io::Print(" {: >{}} | {}{}{}{}", current_line, line_nb_size, highlight,
+		fmt::format_to(std::back_inserter(out), " {: >{}} | {}{}{}{}\n", current_line, line_nb_size, highlight,
 			StringView{ src_info.expression.get_data() + previous_offset, src_info.expression.end() }, io::Reset,
 			io::HighlightCode{ StringView{ end_line.get_data(), end_line.get_data() + offset } });
 		++current_line;
@@ -73,13 +329,13 @@ namespace colt::lang::details
 			{
 				if (previous_offset < end_line.get_size())
 				{
-					io::Print(" {: >{}} | {}", current_line, line_nb_size,
+					fmt::format_to(std::back_inserter(out), " {: >{}} | {}\n", current_line, line_nb_size,
 						io::HighlightCode{ StringView{ end_line.get_data() + previous_offset, end_line.end() } });
 				}
 				break;
 			}
 
-			io::Print(" {: >{}} | {}", current_line, line_nb_size,
+			fmt::format_to(std::back_inserter(out), " {: >{}} | {}\n", current_line, line_nb_size,
 				io::HighlightCode{ StringView{ end_line.get_data() + previous_offset, end_line.get_data() + offset } });
 			++current_line;
 		}
@@ -30,6 +30,23 @@ namespace colt::lang
 		bool is_single_line() const noexcept { return line_begin == line_end; }
 	};
 
+	/// @brief The compact form of SourceCodeExprInfo stored by each expression.
+	/// The views are rebuilt from the source code when needed (see COLTContext::to_src_info).
+	struct SourceCodeLocation
+	{
+		/// @brief The offset of expressions that were not parsed from a source (deserialized)
+		static constexpr u32 NO_SOURCE = std::numeric_limits<u32>::max();
+
+		/// @brief The beginning line number of the expression
+		u32 line_begin = {};
+		/// @brief The end line number of the expression
+		u32 line_end = {};
+		/// @brief The offset of the expression in the sources of its COLTContext, or NO_SOURCE
+		u32 offset = NO_SOURCE;
+		/// @brief The size of the expression
+		u32 size = {};
+	};
+
 	template<typename... Args>
 	/// @brief Function pointer type of Generate* functions
 	/// @tparam ...Args The arguments type to format
@@ -59,104 +76,152 @@ namespace colt::lang
 	/// @param ...args The arguments to format
 	void GenerateError(const SourceCodeExprInfo& src_info, fmt::format_string<Args...> fmt, Args&&... args) noexcept;
 	
+	/// @brief The kind of a report
+	enum class ReportKind
+	{
+		/// @brief A message
+		MESSAGE,
+		/// @brief A warning
+		WARNING,
+		/// @brief An error
+		ERROR
+	};
+
+	/// @brief Records the reports generated during a compilation.
+	/// While a ReportSink exists, all the reports (generated by any thread) are
+	/// recorded into it instead of being printed. When destroyed, the reports are
+	/// sorted by location and written at once.
+	/// ReportSinks can be nested (for compiling imported modules): the previous
+	/// sink is restored on destruction.
+	class ReportSink
+	{
+		/// @brief A report to write
+		struct Record
+		{
+			/// @brief The line of the report (0 if no source information)
+			u32 line;
+			/// @brief The beginning of the highlighted expression
+			const char* location;
+			/// @brief The order in which the report was generated
+			u64 order;
+			/// @brief The formatted report
+			std::string text;
+		};
+
+		/// @brief Protects 'records'
+		std::mutex mutex;
+		/// @brief The reports recorded
+		Vector<Record> records = {};
+		/// @brief The count of errors reported (including the ones not printed)
+		std::atomic<u64> error_count = 0;
+		/// @brief The maximum count of errors to report, or 0 for no limit
+		u64 error_limit;
+		/// @brief The sink that was active before this one
+		PTR<ReportSink> previous;
+
+	public:
+		/// @brief Installs the sink, with '-error-limit' as limit
+		ReportSink() noexcept;
+		/// @brief Writes the reports, and restores the previous sink
+		~ReportSink() noexcept;
+		/// @brief No copy constructor
+		ReportSink(const ReportSink&) = delete;
+		/// @brief No move constructor
+		ReportSink(ReportSink&&) = delete;
+
+		/// @brief Records a formatted report
+		/// @param kind The kind of the report
+		/// @param src_info The source information of the report
+		/// @param text The formatted report
+		void add(ReportKind kind, const SourceCodeExprInfo& src_info, std::string&& text) noexcept;
+		
+		/// @brief Counts an error that is not printed ('-no-error')
+		void count_error() noexcept { error_count.fetch_add(1, std::memory_order_relaxed); }
+
+		/// @brief Check if the error limit was reached
+		/// @return True if parsing should stop
+		bool is_limit_reached() const noexcept
+		{
+			return error_limit != 0 && error_count.load(std::memory_order_relaxed) >= error_limit;
+		}
+
+		/// @brief Sorts the reports by location and writes them in a single write
+		void flush() noexcept;
+	};
+
+	/// @brief Copies the reports written while it exists (by any thread), in addition
+	/// to writing them. The daemon uses it to write again the diagnostics of a file
+	/// whose AST is reused.
+	/// ReportCaptures can be nested: the previous capture is restored on destruction.
+	class ReportCapture
+	{
+		/// @brief The string to which the reports are appended
+		std::string& text;
+		/// @brief The capture that was active before this one
+		PTR<ReportCapture> previous;
+
+	public:
+		/// @brief Installs the capture
+		/// @param text The string to which to append the reports
+		ReportCapture(std::string& text) noexcept;
+		/// @brief Restores the previous capture
+		~ReportCapture() noexcept;
+		/// @brief No copy constructor
+		ReportCapture(const ReportCapture&) = delete;
+		/// @brief No move constructor
+		ReportCapture(ReportCapture&&) = delete;
+
+		/// @brief Appends written reports to the captured text
+		/// @param reports The reports
+		void add(StringView reports) noexcept { text.append(reports.get_data(), reports.get_size()); }
+	};
+
+	/// @brief Writes reports captured by a ReportCapture
+	/// @param reports The captured reports
+	void WriteCapturedReports(StringView reports) noexcept;
+
+	/// @brief Check if the error limit ('-error-limit') of the current compilation was reached
+	/// @return True if a ReportSink is active and its error limit was reached
+	bool IsErrorLimitReached() noexcept;
+
 	namespace details
 	{
-		void print_single_line(io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept;
+		/// @brief Formats a report (with the source code highlighted) then records it
+		/// in the active ReportSink, or writes it if there is none.
+		/// @param kind The kind of the report
+		/// @param src_info The source information to highlight
+		/// @param message The formatted message (empty if the report is not printed)
+		void Report(ReportKind kind, const SourceCodeExprInfo& src_info, std::string&& message) noexcept;
+
+		void print_single_line(fmt::memory_buffer& out, io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept;
 
-		void print_multiple_lines(io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept;		
+		void print_multiple_lines(fmt::memory_buffer& out, io::Color highlight, const SourceCodeExprInfo& src_info, StringView begin_line, StringView end_line, size_t line_nb_size) noexcept;
 	}
 
 	template<typename ...Args>
 	void GenerateMessage(const SourceCodeExprInfo& src_info, fmt::format_string<Args...> fmt, Args&& ...args) noexcept
 	{
-		if (args::NoMessage)
-			return;
-		io::PrintMessage(fmt, std::forward<Args>(args)...);
-
-		if (!src_info.is_valid())
+		//Nothing is reported once the error limit is reached
+		if (args::NoMessage || IsErrorLimitReached())
 			return;
-		
-		StringView begin_line = { src_info.lines.get_data(), src_info.expression.get_data() };
-		StringView end_line = { src_info.lines.get_data() + src_info.expression.get_size(), src_info.lines.get_data() + src_info.lines.get_size() };
-
-		//If lexeme.get_size() == 0, then the lexeme will be outside of the line_strv:
-		//This is because the only case where the lexeme is empty is due to reaching
-		//the last lexeme.
-		if (src_info.expression.get_size() == 0)
-		{
-			end_line = StringView{ src_info.expression.get_data(), src_info.expression.get_data() };
-			begin_line = src_info.lines;
-		}
-		else
-			end_line = StringView{ src_info.expression.get_data() + src_info.expression.get_size(), src_info.lines.get_data() + src_info.lines.get_size() };
-		
-		size_t line_nb_size = fmt::formatted_size("{}", src_info.line_end);
-		if (src_info.is_single_line())
-			details::print_single_line(io::CyanF, src_info, begin_line, end_line, line_nb_size);
-		else
-			details::print_multiple_lines(io::CyanF, src_info, begin_line, end_line, line_nb_size);
+		details::Report(ReportKind::MESSAGE, src_info, fmt::format(fmt, std::forward<Args>(args)...));
 	}
 
 	template<typename ...Args>
 	void GenerateWarning(const SourceCodeExprInfo& src_info, fmt::format_string<Args...> fmt, Args&& ...args) noexcept
 	{
-		if (args::NoWarning)
+		if (args::NoWarning || IsErrorLimitReached())
 			return;
-		io::PrintWarning(fmt, std::forward<Args>(args)...);
-
-		if (!src_info.is_valid())
-			return;
-
-		StringView begin_line = { src_info.lines.get_data(), src_info.expression.get_data() };
-		StringView end_line = { src_info.lines.get_data() + src_info.expression.get_size(), src_info.lines.get_data() + src_info.lines.get_size() };
-
-		//If lexeme.get_size() == 0, then the lexeme will be outside of the line_strv:
-		//This is because the only case where the lexeme is empty is due to reaching
-		//the last lexeme.
-		if (src_info.expression.get_size() == 0)
-		{
-			end_line = StringView{ src_info.expression.get_data(), src_info.expression.get_data() };
-			begin_line = src_info.lines;
-		}
-		else
-			end_line = StringView{ src_info.expression.get_data() + src_info.expression.get_size(), src_info.lines.get_data() + src_info.lines.get_size() };
-		
-		size_t line_nb_size = fmt::formatted_size("{}", src_info.line_end);
-		if (src_info.is_single_line())
-			details::print_single_line(io::YellowF, src_info, begin_line, end_line, line_nb_size);
-		else
-			details::print_multiple_lines(io::YellowF, src_info, begin_line, end_line, line_nb_size);
+		details::Report(ReportKind::WARNING, src_info, fmt::format(fmt, std::forward<Args>(args)...));
 	}
 	
 	template<typename ...Args>
 	void GenerateError(const SourceCodeExprInfo& src_info, fmt::format_string<Args...> fmt, Args&&... args) noexcept
 	{
-		if (args::NoError)
-			return;
-		io::PrintError(fmt, std::forward<Args>(args)...);
-
-		if (!src_info.is_valid())
-			return;
-
-		StringView begin_line = { src_info.lines.get_data(), src_info.expression.get_data() };
-		StringView end_line = { src_info.lines.get_data() + src_info.expression.get_size(), src_info.lines.get_data() + src_info.lines.get_size() };
-
-		//If lexeme.get_size() == 0, then the lexeme will be outside of the line_strv:
-		//This is because the only case where the lexeme is empty is due to reaching
-		//the last lexeme.
-		if (src_info.expression.get_size() == 0)
-		{
-			end_line = StringView{ src_info.expression.get_data(), src_info.expression.get_data() };
-			begin_line = src_info.lines;
-		}
-		else
-			end_line = StringView{ src_info.expression.get_data() + src_info.expression.get_size(), src_info.lines.get_data() + src_info.lines.get_size() };
-
-		size_t line_nb_size = fmt::formatted_size("{}", src_info.line_end);
-		if (src_info.is_single_line())
-			details::print_single_line(io::BrightRedB, src_info, begin_line, end_line, line_nb_size);
-		else
-			details::print_multiple_lines(io::BrightRedB, src_info, begin_line, end_line, line_nb_size);
+		//Errors are counted even if not printed, for '-error-limit'
+		if (args::NoError || IsErrorLimitReached())
+			return details::Report(ReportKind::ERROR, src_info, {});
+		details::Report(ReportKind::ERROR, src_info, fmt::format(fmt, std::forward<Args>(args)...));
 	}
 }
 
@@ -1,4 +1,5 @@
 #include "colt_print.h"
+#include <util/colt_pch.h>
 #include <random>
 #include <cstdio>
 #ifndef COLT_WINDOWS
@@ -20,6 +21,29 @@ namespace colt
 
 namespace colt::io
 {
+  /// @brief The count of errors returned by GetErrorCount
+  static std::atomic<u64> ErrorCount = 0;
+
+  std::FILE* GetPrintStream() noexcept
+  {
+    return args::DiagFormat == args::DiagnosticsFormat::JSON ? stderr : stdout;
+  }
+
+  void CountError() noexcept
+  {
+    ErrorCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  u64 GetErrorCount() noexcept
+  {
+    return ErrorCount.load(std::memory_order_relaxed);
+  }
+
+  void ResetErrorCount() noexcept
+  {
+    ErrorCount.store(0, std::memory_order_relaxed);
+  }
+
   void PressToContinue() noexcept
   {
     fputs("Press any key to continue...", stdout);
@@ -28,36 +28,54 @@ namespace colt::io
 	/// @brief Prints 'Press any key to continue...' and waits for any key input.
 	void PressToContinue() noexcept;
 
+	/// @brief Returns the stream to which the printing functions write.
+	/// With '-diagnostics-format=json', this is 'stderr' so that 'stdout'
+	/// only contains the JSON records of the diagnostics.
+	/// This function is defined by the compiler: the runtime ('fn_exports.cpp')
+	/// does not use the printing functions, and prints to 'stdout' directly.
+	/// @return 'stdout' or 'stderr'
+	std::FILE* GetPrintStream() noexcept;
+
+	/// @brief Counts an error, for GetErrorCount
+	void CountError() noexcept;
+	/// @brief Returns the count of errors printed (PrintError, PrintFatal) or
+	/// reported (GenerateError) since the last call to ResetErrorCount.
+	/// The daemon sends the status of a request to its client using this count.
+	/// @return The count of errors
+	u64 GetErrorCount() noexcept;
+	/// @brief Resets the count returned by GetErrorCount
+	void ResetErrorCount() noexcept;
+
 	template<bool new_line = true, typename... Args>
-	/// @brief Prints to the standard output
+	/// @brief Prints to the standard output (see GetPrintStream)
 	/// @tparam ...Args Pack of types to format
 	/// @param fmt The format string, using {fmt} syntax
 	/// @param ...args The arguments to format
 	constexpr void Print(fmt::format_string<Args...> fmt, Args&&... args);
 
 	template<bool new_line = true, typename... Args>
-	/// @brief Prints a message to 'stdout'
+	/// @brief Prints a message to 'stdout' (see GetPrintStream)
 	/// @tparam ...Args Pack of types to format
 	/// @param fmt The format string, using {fmt} syntax
 	/// @param ...args The arguments to format
 	constexpr void PrintMessage(fmt::format_string<Args...> fmt, Args&&... args);
 
 	template<bool new_line = true, typename... Args>
-	/// @brief Prints a warning message to 'stdout'
+	/// @brief Prints a warning message to 'stdout' (see GetPrintStream)
 	/// @tparam ...Args Pack of types to format
 	/// @param fmt The format string, using {fmt} syntax
 	/// @param ...args The arguments to format
 	constexpr void PrintWarning(fmt::format_string<Args...> fmt, Args&&... args);
 
 	template<bool new_line = true, typename... Args>
-	/// @brief Prints an error message to 'stdout'
+	/// @brief Prints an error message to 'stdout' (see GetPrintStream)
 	/// @tparam ...Args Pack of types to format
 	/// @param fmt The format string, using {fmt} syntax
 	/// @param ...args The arguments to format
 	constexpr void PrintError(fmt::format_string<Args...> fmt, Args&&... args);
 
 	template<bool new_line = true, typename... Args>
-	/// @brief Prints a fatal error message to 'stdout'
+	/// @brief Prints a fatal error message to 'stdout' (see GetPrintStream)
 	/// @tparam ...Args Pack of types to format
 	/// @param fmt The format string, using {fmt} syntax
 	/// @param ...args The arguments to format
@@ -82,59 +100,66 @@ namespace colt::io
 	template<bool new_line, typename... Args>
 	constexpr void Print(fmt::format_string<Args...> fmt, Args && ...args)
 	{
-		fmt::print(fmt, std::forward<Args>(args)...);
+		auto stream = GetPrintStream();
+		fmt::print(stream, fmt, std::forward<Args>(args)...);
 		if constexpr (new_line)
-			std::fputc('\n', stdout);
+			std::fputc('\n', stream);
 	}
 
 	template<bool new_line, typename... Args>
 	constexpr void PrintMessage(fmt::format_string<Args...> fmt, Args && ...args)
 	{
+		auto stream = GetPrintStream();
 		if (!args::NoColor)
-			fmt::print(fg(fmt::color::cornflower_blue) | fmt::emphasis::bold, "Message: ");
+			fmt::print(stream, fg(fmt::color::cornflower_blue) | fmt::emphasis::bold, "Message: ");
 		else
-			fmt::print("Message: ");
+			fmt::print(stream, "Message: ");
 
-		fmt::print(fmt, std::forward<Args>(args)...);
+		fmt::print(stream, fmt, std::forward<Args>(args)...);
 		if constexpr (new_line)
-			std::fputc('\n', stdout);
+			std::fputc('\n', stream);
 	}
 
 	template<bool new_line, typename... Args>
 	constexpr void PrintWarning(fmt::format_string<Args...> fmt, Args && ...args)
 	{
+		auto stream = GetPrintStream();
 		if (!args::NoColor)
-			fmt::print(fg(fmt::color::yellow) | fmt::emphasis::bold, "Warning: ");
+			fmt::print(stream, fg(fmt::color::yellow) | fmt::emphasis::bold, "Warning: ");
 		else
-			fmt::print("Warning: ");
+			fmt::print(stream, "Warning: ");
 			
-		fmt::print(fmt, std::forward<Args>(args)...);
+		fmt::print(stream, fmt, std::forward<Args>(args)...);
 		if constexpr (new_line)
-			std::fputc('\n', stdout);
+			std::fputc('\n', stream);
 	}
 
 	template<bool new_line, typename... Args>
 	constexpr void PrintError(fmt::format_string<Args...> fmt, Args && ...args)
 	{
+		CountError();
+		auto stream = GetPrintStream();
 		if (!args::NoColor)
-			fmt::print(fg(fmt::color::red) | fmt::emphasis::bold, "Error: ");
+			fmt::print(stream, fg(fmt::color::red) | fmt::emphasis::bold, "Error: ");
 		else
-			fmt::print("Error: ");
+			fmt::print(stream, "Error: ");
 			
-		fmt::print(fmt, std::forward<Args>(args)...);
+		fmt::print(stream, fmt, std::forward<Args>(args)...);
 		if constexpr (new_line)
-			std::fputc('\n', stdout);
+			std::fputc('\n', stream);
 	}
 
 	template<bool new_line, typename... Args>
 	constexpr void PrintFatal(fmt::format_string<Args...> fmt, Args && ...args)
 	{
-		fmt::print("{}Fatal:{}{} ", io::BrightRedB, io::Reset, io::BrightRedF);
-		fmt::print(fmt, std::forward<Args>(args)...);
-		fmt::print("{}", io::Reset);
+		CountError();
+		auto stream = GetPrintStream();
+		fmt::print(stream, "{}Fatal:{}{} ", io::BrightRedB, io::Reset, io::BrightRedF);
+		fmt::print(stream, fmt, std::forward<Args>(args)...);
+		fmt::print(stream, "{}", io::Reset);
 
 		if constexpr (new_line)
-			std::fputc('\n', stdout);
+			std::fputc('\n', stream);
 	}
 }
 
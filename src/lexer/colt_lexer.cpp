@@ -21,6 +21,7 @@ namespace colt::lang
 	Token Lexer::get_next_token() noexcept
 	{
 		skipped_spaces = 0;
+		++token_count;
 		//We skip spaces
 		while (isSpace(current_char))
 		{
@@ -130,6 +131,21 @@ namespace colt::lang
 		current_char = ' ';
 	}
 	
+	void Lexer::seek(size_t lexeme_offset, u32 line_nb) noexcept
+	{
+		offset = lexeme_offset;
+		lexeme_begin = lexeme_offset;
+		current_line = line_nb;
+		cached_line_nb = 0;
+		//The beginning of the line is used for column informations
+		size_t line_begin = lexeme_offset;
+		while (line_begin > 0 && to_scan[line_begin - 1] != '\n')
+			--line_begin;
+		line_begin_old = line_begin_new = as<u32>(line_begin);
+		//'current_char' is the next character to parse: a space is skipped
+		current_char = ' ';
+	}
+
 	StringView Lexer::get_line_strv() const noexcept
 	{
 		//If the cached result is still valid, return it
@@ -206,7 +222,11 @@ namespace colt::lang
 
 		//Save the parsed identifier
 		parsed_identifier = { ident_start, to_scan.get_data() + offset - 1};
-		return get_identifier_or_keyword();
+		Token identifier = get_identifier_or_keyword();
+		//Interned once, so that the parser only compares integers
+		if (identifier == TKN_IDENTIFIER)
+			parsed_symbol = InternSymbol(parsed_identifier);
+		return identifier;
 	}
 	
 	Token Lexer::handle_digit() noexcept
@@ -909,6 +929,8 @@ namespace colt::lang
 				return TKN_KEYWORD_I32;
 			else if (temp_str == "i64")
 				return TKN_KEYWORD_I64;
+			else if (temp_str == "import")
+				return TKN_KEYWORD_IMPORT;
 		break; case 'l':
 			if (temp_str == "lstring")
 				return TKN_KEYWORD_LSTRING;
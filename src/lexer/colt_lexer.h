@@ -7,6 +7,7 @@
 
 #include <util/colt_pch.h>
 #include <lexer/colt_token.h>
+#include <lexer/colt_symbol.h>
 #include <io/colt_error_report.h>
 
 
@@ -19,6 +20,8 @@ namespace colt::lang
 		StringView to_scan = {};
 		/// @brief The currently parsed lexeme
 		StringView parsed_identifier = {};
+		/// @brief The symbol of the last parsed identifier
+		SymbolID parsed_symbol = {};
 		/// @brief The last parsed literal value
 		QWORD parsed_value = {};
 
@@ -42,6 +45,8 @@ namespace colt::lang
 		mutable StringView cached_line_strv = {};
 		/// @brief Number of skipped spaces
 		u64 skipped_spaces = 0;
+		/// @brief Number of tokens returned by 'get_next_token'
+		u64 token_count = 0;
 		/// @brief The current char, which is the one to parse next
 		char current_char = ' ';
 		/// @brief If false, then errors are not reported to the console
@@ -82,11 +87,19 @@ namespace colt::lang
 		/// @brief Returns the number of spaces skipped before hitting the lexeme
 		/// @return Number of spaces skipped
 		u64 get_skipped_spaces_count() const noexcept { return skipped_spaces; }
+
+		/// @brief Returns the number of tokens lexed since the construction of the Lexer
+		/// @return Number of tokens lexed
+		u64 get_token_count() const noexcept { return token_count; }
 		
 		/// @brief Returns the current offset into the StringView to parse
 		/// @return Byte offset from the beginning of the StringView
 		u64 get_current_offset() const noexcept { return offset; }
 
+		/// @brief Returns the offset of the current lexeme into the StringView to parse
+		/// @return Byte offset from the beginning of the StringView
+		u64 get_lexeme_offset() const noexcept { return lexeme_begin; }
+
 		/// @brief Returns line informations of the current lexeme
 		/// @return Line informations of the current lexeme
 		LineInformations get_line_info() const noexcept;
@@ -94,6 +107,10 @@ namespace colt::lang
 		/// @brief Get the last parsed identifier
 		/// @return String view over the identifier
 		StringView get_parsed_identifier() const noexcept { return parsed_identifier; }
+
+		/// @brief Get the symbol of the last parsed identifier
+		/// @return The interned identifier
+		SymbolID get_parsed_symbol() const noexcept { return parsed_symbol; }
 		
 		/// @brief Get the last parsed literal value
 		/// @return Union of the possible value
@@ -121,6 +138,16 @@ namespace colt::lang
 		/// @param to_scan The StringView to scan
 		void set_to_scan(StringView to_scan, bool report_errors = true) noexcept;
 
+		/// @brief Moves the scanner to the beginning of a lexeme previously returned
+		/// by get_lexeme_offset(), so that the next token returned is that lexeme.
+		/// @param lexeme_offset The offset of the lexeme
+		/// @param line_nb The line number of the lexeme
+		void seek(size_t lexeme_offset, u32 line_nb) noexcept;
+
+		/// @brief Activates or deactivates the reporting of errors
+		/// @param report True to report errors
+		void set_report_errors(bool report) noexcept { report_errors = report; }
+
 	private:
 		/// @brief Returns a string view over the current line
 		/// @return String view over the current line
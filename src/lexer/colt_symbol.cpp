@@ -0,0 +1,123 @@
+/** @file colt_symbol.cpp
+* Contains definition of functions declared in 'colt_symbol.h'.
+*/
+
+#include "colt_symbol.h"
+#include <cstring>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+namespace colt::lang
+{
+	/// @brief The count of names stored in a chunk
+	static constexpr u32 SYMBOL_CHUNK_SIZE = 4096;
+	/// @brief The maximum count of chunks (for 2^24 identifiers)
+	static constexpr u32 SYMBOL_MAX_CHUNKS = 4096;
+	/// @brief The size of the blocks in which the names are copied
+	static constexpr size_t SYMBOL_BLOCK_SIZE = 64 * 1024;
+
+	/// @brief The global table of interned identifiers
+	class SymbolTable
+	{
+		/// @brief Protects 'symbols' and the blocks.
+		/// Lookups are far more frequent than insertions, so a shared lock is used.
+		std::shared_mutex mutex;
+		/// @brief Maps a name to its ID
+		Map<StringView, SymbolID> symbols = {};
+		/// @brief The chunks mapping an ID to its name.
+		/// Chunks are never reallocated, so that names can be read without locking.
+		std::atomic<PTR<StringView>> chunks[SYMBOL_MAX_CHUNKS] = {};
+		/// @brief The count of IDs given
+		std::atomic<u32> count = 0;
+		/// @brief The blocks in which the names are copied
+		std::vector<std::unique_ptr<char[]>> blocks = {};
+		/// @brief The free space in the last block
+		size_t block_free = 0;
+
+		/// @brief Copies a name into the blocks, so that it outlives the source code
+		/// @param name The name to copy
+		/// @return The copied name
+		StringView copy_name(StringView name) noexcept
+		{
+			if (name.get_size() > block_free)
+			{
+				blocks.push_back(std::make_unique<char[]>(std::max(name.get_size(), SYMBOL_BLOCK_SIZE)));
+				block_free = std::max(name.get_size(), SYMBOL_BLOCK_SIZE);
+			}
+			//Blocks are filled from their end
+			block_free -= name.get_size();
+			char* copy = blocks.back().get() + block_free;
+			std::memcpy(copy, name.get_data(), name.get_size());
+			return StringView{ copy, copy + name.get_size() };
+		}
+
+	public:
+		/// @brief Interns an identifier
+		/// @param name The identifier
+		/// @return The ID of the identifier
+		SymbolID intern(StringView name) noexcept
+		{
+			{
+				std::shared_lock lock{ mutex };
+				if (auto ptr = symbols.find(name); ptr != nullptr)
+					return ptr->second;
+			}
+			std::unique_lock lock{ mutex };
+			//Another thread could have interned the name
+			if (auto ptr = symbols.find(name); ptr != nullptr)
+				return ptr->second;
+
+			SymbolID symbol = count.load(std::memory_order_relaxed);
+			assert_true(symbol < SYMBOL_CHUNK_SIZE * SYMBOL_MAX_CHUNKS, "Too many identifiers!");
+			auto copy = copy_name(name);
+			auto chunk = chunks[symbol / SYMBOL_CHUNK_SIZE].load(std::memory_order_relaxed);
+			if (chunk == nullptr)
+			{
+				chunk = new StringView[SYMBOL_CHUNK_SIZE];
+				chunks[symbol / SYMBOL_CHUNK_SIZE].store(chunk, std::memory_order_release);
+			}
+			chunk[symbol % SYMBOL_CHUNK_SIZE] = copy;
+			symbols.insert(copy, symbol);
+			count.store(symbol + 1, std::memory_order_release);
+			return symbol;
+		}
+
+		/// @brief Returns the name of an identifier
+		/// @param symbol The ID of the identifier
+		/// @return The name of the identifier
+		StringView get_name(SymbolID symbol) const noexcept
+		{
+			assert_true(symbol < count.load(std::memory_order_acquire), "Invalid SymbolID!");
+			return chunks[symbol / SYMBOL_CHUNK_SIZE].load(std::memory_order_acquire)[symbol % SYMBOL_CHUNK_SIZE];
+		}
+
+		/// @brief Returns the count of IDs given
+		/// @return The count of IDs
+		u32 get_count() const noexcept { return count.load(std::memory_order_acquire); }
+	};
+
+	/// @brief Returns the global table of identifiers
+	/// @return The table
+	static SymbolTable& GetSymbolTable() noexcept
+	{
+		//Never destroyed, as names may be read until the end of the program
+		static auto table = new SymbolTable();
+		return *table;
+	}
+
+	SymbolID InternSymbol(StringView name) noexcept
+	{
+		return GetSymbolTable().intern(name);
+	}
+
+	StringView GetSymbolName(SymbolID symbol) noexcept
+	{
+		return GetSymbolTable().get_name(symbol);
+	}
+
+	u32 GetSymbolCount() noexcept
+	{
+		return GetSymbolTable().get_count();
+	}
+}
@@ -0,0 +1,37 @@
+/** @file colt_symbol.h
+* Contains the global table of interned identifiers.
+* Each identifier parsed by the Lexer is interned, and is represented
+* by a dense integer ID: identifiers can then be compared, hashed, or
+* used as an index into an array as integers.
+*/
+
+#ifndef HG_COLT_SYMBOL
+#define HG_COLT_SYMBOL
+
+#include <util/colt_pch.h>
+
+namespace colt::lang
+{
+	/// @brief The ID of an interned identifier.
+	/// IDs are dense: they start at 0 and are given in order of interning.
+	using SymbolID = u32;
+
+	/// @brief Interns an identifier.
+	/// The same ID is returned for identifiers that are equal.
+	/// This function is thread-safe.
+	/// @param name The identifier to intern (which is copied)
+	/// @return The ID of the identifier
+	SymbolID InternSymbol(StringView name) noexcept;
+
+	/// @brief Returns the name of an interned identifier.
+	/// This function is thread-safe, and does not lock.
+	/// @param symbol The ID returned by InternSymbol
+	/// @return The name of the identifier, valid until the end of the program
+	StringView GetSymbolName(SymbolID symbol) noexcept;
+
+	/// @brief Returns the count of identifiers interned
+	/// @return The count of IDs given (the next ID)
+	u32 GetSymbolCount() noexcept;
+}
+
+#endif //!HG_COLT_SYMBOL
@@ -302,6 +302,9 @@ namespace colt::lang
 
 		/********* ADD NEW KEYWORDS BEGINNING HERE *******/
 
+		/// @brief import
+		TKN_KEYWORD_IMPORT,
+
 
 		/// @brief any identifier
 		TKN_IDENTIFIER,
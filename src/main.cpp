@@ -5,17 +5,35 @@ using namespace colt;
 
 int main(int argc, const char** argv)
 {
-  //Initialize code generators
-  InitializeCOLT();
   //Populates the global arguments
   args::ParseArguments(argc, argv);
 
-  //Compile a file or enter REPL
-  if (args::FileIn != nullptr)
-    CompileFile(args::FileIn);
+  int exit_code = EXIT_SUCCESS;
+  //The client of a daemon does not need to initialize the code generators
+  if (args::DaemonConnect != nullptr)
+  {
+    //The client exits with the status of the request
+    if (auto result = ConnectDaemon(args::DaemonConnect, argc, argv); result.is_error())
+    {
+      io::PrintError("{}", result.get_error());
+      exit_code = EXIT_FAILURE;
+    }
+    else
+      exit_code = result.get_value();
+  }
   else
-    REPL();
+  {
+    //Initialize code generators
+    InitializeCOLT();
+
+    //Serve requests, or link bitcode files, compile a file or enter REPL
+    if (args::Daemon != nullptr)
+      StartDaemon(args::Daemon);
+    else
+      RunCompiler();
+  }
 
   if (!args::NoWait)
     io::PressToContinue();
-}
\ No newline at end of file
+  return exit_code;
+}
@@ -3,14 +3,336 @@
 */
 
 #include "main_util.h"
+#include <cstdio>
+#include <unordered_map>
+#ifdef COLT_WINDOWS
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+#endif //COLT_WINDOWS
 
 using namespace colt::gen;
 using namespace colt::lang;
 
 namespace colt
 {
+  /// @brief An AST kept by the daemon, with the context owning its expressions and source
+  struct DaemonAST
+  {
+    /// @brief The time of the last modification of the file when it was parsed
+    std::filesystem::file_time_type last_write;
+    /// @brief The options affecting the parsing and the diagnostics when the file was parsed
+    std::string options;
+    /// @brief The diagnostics reported while parsing, written again when the AST is reused
+    std::string reports;
+    /// @brief The context owning the content of the AST
+    std::unique_ptr<COLTContext> ctx;
+    /// @brief The AST of the file
+    std::unique_ptr<lang::AST> ast;
+  };
+
+  /// @brief The ASTs of the files compiled by the daemon (keyed by absolute path),
+  /// or nullptr if not running as a daemon
+  static std::unique_ptr<std::unordered_map<std::string, DaemonAST>> daemon_asts = nullptr;
+
+  /// @brief The durations of the phases of a compilation, for '-stats'
+  struct PhaseTimes
+  {
+    /// @brief Parsing (or loading a serialized AST)
+    double parse = 0.0;
+    /// @brief Generation of the IR
+    double generate = 0.0;
+    /// @brief Optimization of the IR
+    double optimize = 0.0;
+    /// @brief Writing the output (object file, bitcode or executable)
+    double emit = 0.0;
+  };
+
+  /// @brief The durations of the phases of the current compilation
+  static PhaseTimes phase_times = {};
+
+  /// @brief Returns the seconds elapsed since a time point
+  /// @param begin The time point
+  /// @return The elapsed seconds
+  static double SecondsSince(std::chrono::steady_clock::time_point begin) noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - begin).count();
+  }
+
+#ifndef COLT_NO_LLVM
+  /// @brief The statistics of the IR before optimizations, for '-stats'
+  static gen::IRStats generated_ir_stats = {};
+  /// @brief The statistics of the IR after optimizations, for '-stats'
+  static gen::IRStats optimized_ir_stats = {};
+  /// @brief True if IR was generated since the last statistics were printed
+  static bool has_ir_stats = false;
+#endif //!COLT_NO_LLVM
+
+  /// @brief The names of the expressions, indexed by ExprID
+  static constexpr const char* ExprNames[] = {
+    "Expr", "ErrorExpr", "LiteralExpr", "UnaryExpr", "BinaryExpr", "ConvertExpr",
+    "VarDeclExpr", "VarReadExpr", "VarWriteExpr", "FnDeclExpr", "FnDefExpr",
+    "FnCallExpr", "FnReturnExpr", "ScopeExpr", "ConditionExpr", "SwitchExpr",
+    "ForLoopExpr", "WhileLoopExpr", "BreakContinueExpr", "NoOpExpr", "PtrStoreExpr",
+    "PtrLoadExpr", "IndexExpr", "SliceLenExpr", "ToSliceExpr", "VecIntrinsicExpr"
+  };
+  static_assert(std::size(ExprNames) == Expr::EXPR_VEC_INTRINSIC + 1, "Missing expression name!");
+
+  /// @brief Returns the peak resident set size of the process
+  /// @return The peak memory usage in bytes, or 0 if not available
+  static u64 GetPeakRSS() noexcept
+  {
+#ifdef COLT_WINDOWS
+    PROCESS_MEMORY_COUNTERS info;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info)))
+      return 0;
+    return info.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+  #ifdef COLT_APPLE
+    //In bytes on macOS
+    return static_cast<u64>(usage.ru_maxrss);
+  #else
+    //In kilobytes on Linux
+    return static_cast<u64>(usage.ru_maxrss) * 1024;
+  #endif //COLT_APPLE
+#endif //COLT_WINDOWS
+  }
+
+  /// @brief Prints the statistics of a compilation ('-stats')
+  /// @param stats The statistics of the context of the compilation
+  /// @param peak_rss The peak memory usage in bytes
+  static void PrintStatsText(const ContextStats& stats, u64 peak_rss) noexcept
+  {
+    u64 expr_count = 0;
+    u64 expr_bytes = 0;
+    for (size_t i = 0; i < std::size(ExprNames); i++)
+    {
+      expr_count += stats.expr_count[i];
+      expr_bytes += stats.expr_bytes[i];
+    }
+    io::Print("Statistics of the compilation:");
+    io::Print("  {:<22}{}", "Tokens:", stats.token_count);
+    io::Print("  {:<22}{} ({} bytes)", "Expressions:", expr_count, expr_bytes);
+    for (size_t i = 0; i < std::size(ExprNames); i++)
+    {
+      if (stats.expr_count[i] != 0)
+        io::Print("    {:<20}{} ({} bytes)", ExprNames[i], stats.expr_count[i], stats.expr_bytes[i]);
+    }
+    io::Print("  {:<22}{} bytes", "Arrays of children:", stats.array_bytes);
+    io::Print("  {:<22}{} bytes", "Expression blocks:", stats.block_bytes);
+    io::Print("  {:<22}{}", "Types:", stats.type_count);
+    io::Print("  {:<22}{} ({} bytes)", "Strings:", stats.str_count, stats.str_bytes);
+#ifndef COLT_NO_LLVM
+    if (has_ir_stats)
+    {
+      io::Print("  {:<22}{} functions, {} blocks, {} instructions", "Generated IR:",
+        generated_ir_stats.fn_count, generated_ir_stats.block_count, generated_ir_stats.inst_count);
+      io::Print("  {:<22}{} functions, {} blocks, {} instructions", "Optimized IR:",
+        optimized_ir_stats.fn_count, optimized_ir_stats.block_count, optimized_ir_stats.inst_count);
+    }
+#endif //!COLT_NO_LLVM
+    io::Print("  {:<22}{} bytes", "Peak RSS:", peak_rss);
+    io::Print("  {:<22}parse {:.6}s, generate {:.6}s, optimize {:.6}s, emit {:.6}s", "Time:",
+      phase_times.parse, phase_times.generate, phase_times.optimize, phase_times.emit);
+  }
+
+  /// @brief Writes the statistics of a compilation as JSON ('-json-stats')
+  /// @param path The path of the file to write
+  /// @param stats The statistics of the context of the compilation
+  /// @param peak_rss The peak memory usage in bytes
+  static void WriteStatsJSON(const char* path, const ContextStats& stats, u64 peak_rss) noexcept
+  {
+    fmt::memory_buffer out;
+    auto it = std::back_inserter(out);
+    fmt::format_to(it, "{{\n  \"tokens\": {},\n  \"expressions\": {{", stats.token_count);
+    bool first = true;
+    for (size_t i = 0; i < std::size(ExprNames); i++)
+    {
+      if (stats.expr_count[i] == 0)
+        continue;
+      fmt::format_to(it, "{}\n    \"{}\": {{ \"count\": {}, \"bytes\": {} }}",
+        first ? "" : ",", ExprNames[i], stats.expr_count[i], stats.expr_bytes[i]);
+      first = false;
+    }
+    fmt::format_to(it, "\n  }},\n  \"array_bytes\": {},\n  \"block_bytes\": {},\n"
+      "  \"types\": {},\n  \"strings\": {},\n  \"string_bytes\": {},\n",
+      stats.array_bytes, stats.block_bytes, stats.type_count, stats.str_count, stats.str_bytes);
+#ifndef COLT_NO_LLVM
+    if (has_ir_stats)
+    {
+      for (auto [name, ir] : { std::pair{ "generated_ir", generated_ir_stats }, std::pair{ "optimized_ir", optimized_ir_stats } })
+        fmt::format_to(it, "  \"{}\": {{ \"functions\": {}, \"blocks\": {}, \"instructions\": {} }},\n",
+          name, ir.fn_count, ir.block_count, ir.inst_count);
+    }
+#endif //!COLT_NO_LLVM
+    fmt::format_to(it, "  \"peak_rss_bytes\": {},\n", peak_rss);
+    fmt::format_to(it, "  \"seconds\": {{ \"parse\": {}, \"generate\": {}, \"optimize\": {}, \"emit\": {} }}\n}}\n",
+      phase_times.parse, phase_times.generate, phase_times.optimize, phase_times.emit);
+
+    auto file = std::fopen(path, "wb");
+    if (file == nullptr)
+    {
+      io::PrintError("Could not open file '{}' to write the statistics!", path);
+      return;
+    }
+    std::fwrite(out.data(), 1, out.size(), file);
+    std::fclose(file);
+  }
+
+  /// @brief Prints and writes the statistics of a compilation, depending on global arguments
+  /// @param ctx The context in which the compilation stored its expressions
+  static void ReportStats(const COLTContext& ctx) noexcept
+  {
+    if (args::PrintStats || args::StatsFile)
+    {
+      u64 peak_rss = GetPeakRSS();
+      if (args::PrintStats)
+        PrintStatsText(ctx.get_stats(), peak_rss);
+      if (args::StatsFile)
+        WriteStatsJSON(args::StatsFile, ctx.get_stats(), peak_rss);
+    }
+    phase_times = {};
+#ifndef COLT_NO_LLVM
+    has_ir_stats = false;
+#endif //!COLT_NO_LLVM
+  }
+
+  /// @brief Writes or compiles a valid AST, depending on global arguments
+  /// @param ast The valid AST
+  static void UseAST(const lang::AST& ast) noexcept
+  {
+    io::PrintMessage("Compilation successful!");
+    if (args::FileOut && args::EmitAST) //Write serialized AST
+    {
+      if (auto result = SerializeAST(ast, args::FileOut); result.is_error())
+        io::PrintError("{}", result.get_error());
+      else
+        io::PrintMessage("Successfully written AST file '{}'!", args::FileOut);
+    }
+    else
+      CompileAST(ast);
+  }
+
+  /// @brief Returns the options of the current request that affect the parsing of a file
+  /// or its diagnostics, which must match for its AST to be reused by the daemon
+  /// @return The options as a string
+  static std::string GetDaemonParseOptions() noexcept
+  {
+    //The import directory is relative to the working directory of the client
+    std::error_code ec;
+    auto import_dir = std::filesystem::absolute(args::ImportDir, ec).string();
+    return fmt::format("{} {} {} {} {} {} {} {} {}", args::NoBoundsCheck, args::ParallelParse,
+      args::ErrorLimit, static_cast<int>(args::DiagFormat), args::NoColor, args::NoError,
+      args::NoWarning, args::NoMessage, import_dir);
+  }
+
+  /// @brief Compiles a file, reusing its AST if it was not modified since the last request
+  /// @param path The path of the file to compile
+  static void CompileFileDaemon(const char* path) noexcept
+  {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    auto key = fs::absolute(path, ec).string();
+    auto last_write = fs::last_write_time(path, ec);
+    auto options = GetDaemonParseOptions();
+    if (auto it = daemon_asts->find(key); it != daemon_asts->end())
+    {
+      if (!ec && it->second.last_write == last_write && it->second.options == options)
+      {
+        io::PrintMessage("Reusing the AST of the unmodified file '{}'.", path);
+        const auto& reports = it->second.reports;
+        WriteCapturedReports(StringView{ reports.data(), reports.data() + reports.size() });
+        UseAST(*it->second.ast);
+        ReportStats(*it->second.ctx);
+        return;
+      }
+      daemon_asts->erase(it);
+    }
+
+    auto str = String::getFileContent(path);
+    if (str.is_error())
+    {
+      io::PrintError("Error reading file at path '{}'.", path);
+      return;
+    }
+    //The source is owned by the context, as the AST points into it
+    auto ctx = std::make_unique<COLTContext>();
+    StringView source = ctx->add_str(std::move(str.get_value()));
+    if (source.is_empty())
+      return;
+
+    auto begin_time = std::chrono::steady_clock::now();
+    std::string reports;
+    auto ast = [&]() noexcept
+    {
+      //The warnings are written again when the AST is reused
+      ReportCapture capture = { reports };
+      return CreateAST(source, *ctx);
+    }();
+    phase_times.parse = SecondsSince(begin_time);
+    io::PrintMessage("Finished compilation in {:.6}.",
+      std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - begin_time));
+    if (ast.is_error())
+    {
+      io::PrintWarning("Compilation failed with {} error{}", ast.get_error(), ast.get_error() == 1 ? "!" : "s!");
+      ReportStats(*ctx);
+      return;
+    }
+    UseAST(ast.get_value());
+    ReportStats(*ctx);
+    //Imported modules may be modified without modifying the file
+    if (!ec && ast->imported_modules.is_empty())
+      daemon_asts->emplace(std::move(key), DaemonAST{ last_write, std::move(options), std::move(reports),
+        std::move(ctx), std::make_unique<lang::AST>(std::move(ast.get_value())) });
+  }
+
+  /// @brief Serves a request sent to the daemon
+  /// @param argc The count of arguments of the client
+  /// @param argv The arguments of the client
+  /// @return The exit status of the client: failure if any error was reported
+  static int ServeDaemonRequest(int argc, const char** argv) noexcept
+  {
+    args::ResetArguments();
+    io::ResetErrorCount();
+    //Invalid arguments (or '-help') must not exit the daemon
+    if (auto result = args::TryParseArguments(argc, argv); result != args::ParseResult::PARSED)
+      return result == args::ParseResult::PRINTED_HELP ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (args::FileIn == nullptr && args::ThinLTOFiles == nullptr)
+      io::PrintError("The daemon cannot run the REPL: expected an input file!");
+    else
+      RunCompiler();
+#ifndef COLT_NO_LLVM
+    llvm::outs().flush();
+#endif //!COLT_NO_LLVM
+    return io::GetErrorCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
   void CompileFile(const char* path) noexcept
   {
+    if (std::filesystem::path(path).extension() == ".cast")
+    {
+      COLTContext ctx;
+      AST ast = { ctx };
+      auto begin_time = std::chrono::steady_clock::now();
+      auto result = DeserializeAST(path, ast);
+      phase_times.parse = SecondsSince(begin_time);
+      if (result.is_error())
+        io::PrintError("Error loading AST at path '{}': {}", path, result.get_error());
+      else
+        CompileAST(ast);
+      ReportStats(ctx);
+      return;
+    }
+    if (daemon_asts != nullptr)
+    {
+      CompileFileDaemon(path);
+      return;
+    }
+
     auto str = String::getFileContent(path);
     if (str.is_error())
       io::PrintError("Error reading file at path '{}'.", path);
@@ -18,6 +340,33 @@ namespace colt
       CompileStr(str.get_value());
   }
 
+  void RunCompiler() noexcept
+  {
+    //Instrumenting the code and optimizing it using a profile are exclusive
+    if (args::ProfileGenerate && args::ProfileUse)
+    {
+      io::PrintError("'-fprofile-generate' and '-fprofile-use' cannot be used together!");
+      return;
+    }
+#ifndef COLT_NO_LLVM
+    if (args::ThinLTOFiles != nullptr)
+      LinkBitcodeFiles(args::ThinLTOFiles);
+    else
+#endif //!COLT_NO_LLVM
+    if (args::FileIn != nullptr)
+      CompileFile(args::FileIn);
+    else
+      REPL();
+  }
+
+  void StartDaemon(const char* socket_path) noexcept
+  {
+    daemon_asts = std::make_unique<std::unordered_map<std::string, DaemonAST>>();
+    if (auto result = ListenDaemon(socket_path, &ServeDaemonRequest); result.is_error())
+      io::PrintError("{}", result.get_error());
+    daemon_asts = nullptr;
+  }
+
   void InitializeCOLT() noexcept
   {
 #if defined(COLT_MSVC) && defined(COLT_DEBUG)
@@ -34,6 +383,31 @@ namespace colt
     llvm::InitializeNativeTargetAsmParser();
     llvm::InitializeNativeTargetAsmPrinter();
     llvm::InitializeNativeTargetDisassembler();
+
+    //Imported modules are compiled to object files
+    lang::RegisterModuleCodeGenFn([](const lang::AST& module, const char* source_path, const char* object_path) noexcept
+      {
+        //The options of the importer do not apply to the module: its debug
+        //information refers to its own source, and it is always an object file
+        //(without instrumentation or profile, as it is shared by all importers)
+        ScopedSave file_in = { args::FileIn, source_path };
+        ScopedSave emit_bitcode = { args::EmitBitcode, false };
+        ScopedSave profile_generate = { args::ProfileGenerate, false };
+        ScopedSave profile_use = { args::ProfileUse, lstring{} };
+        auto IR = gen::GenerateIR(module);
+        if (IR.is_error())
+        {
+          io::PrintError("{}", IR.get_error());
+          return false;
+        }
+        IR->optimize(OptimizationLevel::O3);
+        if (auto result = IR->to_object_file(object_path); result.is_error())
+        {
+          io::PrintError("{}", result.get_error());
+          return false;
+        }
+        return true;
+      });
 #endif //!COLT_NO_LLVM
   }  
 
@@ -65,6 +439,8 @@ namespace colt
       //DO NOT REMOVE FOR NOW.
       ast.global_map.clear();
       ast.expressions.clear();
+      ast.imports.clear();
+      ast.imported_modules.clear();
       io::Print<false>("{}>{} ", io::BrightCyanF, io::Reset);
       auto line = get_str_repl();
       if (line.is_error())
@@ -127,7 +503,7 @@ namespace colt
         {
 #ifndef COLT_NO_LLVM
           if (auto result = GenerateIR(ast); result.is_expected())
-            RunMain(std::move(result.get_value()), false);
+            RunMain(std::move(result.get_value()), ast.module_objects, false);
 #endif //!COLT_NO_LLVM
         }
       }
@@ -137,7 +513,7 @@ namespace colt
         {
 #ifndef COLT_NO_LLVM
           if (auto result = GenerateIR(ast); result.is_expected())
-            RunMain(std::move(result.get_value()), false);
+            RunMain(std::move(result.get_value()), ast.module_objects, false);
 #endif //!COLT_NO_LLVM
         }
       }
@@ -155,78 +531,181 @@ namespace colt
     //Compile
     COLTContext ctx;
     auto AST = CreateAST(str, ctx);
+    phase_times.parse = SecondsSince(begin_time);
 
     //Record end of compilation
     io::PrintMessage("Finished compilation in {:.6}.",
       std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - begin_time));
 
     if (AST.is_expected())
-    {
-      io::PrintMessage("Compilation successful!");
-      CompileAST(AST.get_value());
-    }
+      UseAST(AST.get_value());
     else
       io::PrintWarning("Compilation failed with {} error{}", AST.get_error(), AST.get_error() == 1 ? "!" : "s!");
+    ReportStats(ctx);
   }
 
   void CompileAST(const lang::AST& ast) noexcept
   {
 #ifndef COLT_NO_LLVM
-    auto IR = gen::GenerateIR(ast);
+    //Instrumented code cannot be cached per function, as the counters are shared
+    std::unique_ptr<gen::IncrementalCache> cache = nullptr;
+    if (args::IncrementalDir && !args::ProfileGenerate)
+      cache = std::make_unique<gen::IncrementalCache>(ast, args::IncrementalDir);
+
+    auto begin_time = std::chrono::steady_clock::now();
+    auto IR = gen::GenerateIR(ast, cache.get());
+    phase_times.generate = SecondsSince(begin_time);
     if (IR.is_error())
     {
       io::PrintError("{}", IR.get_error());
       return;
     }
 
+    //Counting instructions visits the whole module
+    if (args::PrintStats || args::StatsFile)
+      generated_ir_stats = IR->get_stats();
     //Optimize resulting IR
+    begin_time = std::chrono::steady_clock::now();
     IR->optimize(OptimizationLevel::O3);
+    phase_times.optimize = SecondsSince(begin_time);
+    if (args::PrintStats || args::StatsFile)
+    {
+      optimized_ir_stats = IR->get_stats();
+      has_ir_stats = true;
+    }
+    //Only the modified functions were generated and optimized
+    if (cache)
+    {
+      if (auto result = cache->update(*IR->module); result.is_error())
+      {
+        io::PrintError("{}", result.get_error());
+        return;
+      }
+      io::PrintMessage("Reused {} of {} functions from the incremental cache.",
+        cache->get_cached_count(), cache->get_fn_count());
+    }
 
     if (args::PrintLLVMIR) //Print IR
       IR->print_module(llvm::errs());
-    if (args::FileOut) //Write object file
+    begin_time = std::chrono::steady_clock::now();
+    if (args::FileOut && args::EmitBitcode) //Write bitcode file
+    {
+      if (auto result = IR->to_bitcode_file(args::FileOut); result.is_error())
+        io::PrintError("{}", result.get_error());
+      else
+        io::PrintMessage("Successfully written bitcode file '{}'!", args::FileOut);
+    }
+    else if (args::FileOut && args::EmitExecutable) //Write executable
+    {
+      //The object file is only needed during linking
+      std::string object = std::string(args::FileOut) + ".o";
+      if (auto result = IR->to_object_file(object.c_str()); result.is_error())
+        io::PrintError("{}", result.get_error());
+      else if (auto link = LinkExecutable(object.c_str(), ast.module_objects, args::FileOut); link.is_error())
+        io::PrintError("{}", link.get_error());
+      else
+        io::PrintMessage("Successfully written executable '{}'!", args::FileOut);
+      std::error_code ec;
+      std::filesystem::remove(object, ec);
+    }
+    else if (args::FileOut) //Write object file
     {
       if (auto result = IR->to_object_file(args::FileOut); result.is_error())
         io::PrintError("{}", result.get_error());
       else
         io::PrintMessage("Successfully written object file '{}'!", args::FileOut);
     }
+    phase_times.emit = SecondsSince(begin_time);
 
     if (args::RunMain)
-      RunMain(std::move(*IR));
+      RunMain(std::move(*IR), ast.module_objects);
 #endif //!COLT_NO_LLVM
   }
 
 #ifndef COLT_NO_LLVM
-  void RunMain(gen::GeneratedIR&& IR, bool print) noexcept
+  /// @brief The JIT reused by RunMain
+  static std::unique_ptr<gen::ColtJIT> warm_jit = nullptr;
+  /// @brief The CPU and features for which 'warm_jit' was created
+  static std::string warm_jit_target = {};
+  /// @brief The count of libraries created in 'warm_jit', used to name them
+  static u64 warm_jit_dylib_count = 0;
+
+  void RunMain(gen::GeneratedIR&& IR, const Vector<String>& modules, bool print) noexcept
   {
-    if (auto JITError = gen::ColtJIT::Create(); !JITError)
+    std::string target = fmt::format("{};{}", args::TargetCPU, args::TargetAttr);
+    if (warm_jit == nullptr || warm_jit_target != target)
     {
-      io::PrintFatal("Could not initialize JIT compiler!");
-      abort();
+      auto JITError = gen::ColtJIT::Create();
+      if (!JITError)
+      {
+        io::PrintError("Could not initialize JIT compiler: {}", llvm::toString(JITError.takeError()));
+        return;
+      }
+      warm_jit = std::move(*JITError);
+      warm_jit_target = std::move(target);
     }
-    else
+
+    //Each program is compiled in its own library, removed after running it
+    auto dylib = warm_jit->createDylib(fmt::format("colt{}", warm_jit_dylib_count++));
+    if (!dylib)
     {
-      const auto& ColtJIT = std::move(*JITError);
-      if (auto AddError = ColtJIT->addModule(std::move(IR)); AddError)
+      io::PrintError("Could not initialize JIT compiler: {}", llvm::toString(dylib.takeError()));
+      return;
+    }
+    ON_EXIT{ llvm::consumeError(warm_jit->removeDylib(*dylib)); };
+
+    for (size_t i = 0; i < modules.get_size(); i++)
+    {
+      if (auto AddError = warm_jit->addObjectFile(modules[i].c_str(), &*dylib); AddError)
       {
-        io::PrintFatal("Could not JIT compile the code!");
-        abort();
+        io::PrintError("Could not load the object file '{}' of an imported module!", StringView{ modules[i] });
+        llvm::consumeError(std::move(AddError));
+        return;
       }
-      else if (auto main = ColtJIT->lookup("main"))
+    }
+    //Instrumented code is linked with the profile runtime
+    auto AddError = args::ProfileGenerate
+      ? warm_jit->addProfiledModule(std::move(IR), *dylib)
+      : warm_jit->addModule(std::move(IR), &*dylib);
+    if (AddError)
+    {
+      io::PrintError("Could not JIT compile the code: {}", llvm::toString(std::move(AddError)));
+      return;
+    }
+    else if (auto main = warm_jit->lookup("main", &*dylib))
+    {
+      if (print)
+        io::PrintMessage("Running 'main' function...");
+      
+      auto main_fn = reinterpret_cast<i64(*)()>(main->getValue());
+      i64 ret = main_fn();
+      if (args::ProfileGenerate)
       {
-        if (print)
-          io::PrintMessage("Running 'main' function...");
-        
-        auto main_fn = reinterpret_cast<i64(*)()>(main->getValue());
-        i64 ret = main_fn();
-        
-        if (print)
-          io::PrintMessage("'main' function returned '{}'!", ret);
+        if (auto WriteError = warm_jit->writeProfile(*dylib))
+          io::PrintError("Could not write the profile: {}", llvm::toString(std::move(WriteError)));
       }
-      else if (print)
+      
+      if (print)
+        io::PrintMessage("'main' function returned '{}'!", ret);
+    }
+    else
+    {
+      llvm::consumeError(main.takeError());
+      if (print)
         io::PrintWarning("'main' function was not found!");
     }
   }  
+
+  void LinkBitcodeFiles(const char* files) noexcept
+  {
+    llvm::SmallVector<llvm::StringRef, 8> paths;
+    llvm::StringRef(files).split(paths, ',', -1, false);
+    const char* prefix = args::FileOut ? args::FileOut : "colt_lto";
+
+    if (auto result = gen::LinkThinLTO(paths, prefix); result.is_error())
+      io::PrintError("{}", result.get_error());
+    else
+      io::PrintMessage("Successfully written object files '{}.<n>.o'!", prefix);
+  }
 #endif //!COLT_NO_LLVM
 }
\ No newline at end of file
@@ -9,11 +9,15 @@
 
 #include <util/colt_pch.h>
 #include <ast/colt_ast.h>
+#include <ast/colt_serialize.h>
+#include <ast/colt_module.h>
 #include <io/colt_code_highlight.h>
+#include <daemon/colt_daemon.h>
 
 #ifndef COLT_NO_LLVM
   #include <code_gen/llvm_ir_gen.h>
   #include <interpreter/colt_JIT.h>
+  #include <code_gen/linker.h>
 #endif //!COLT_NO_LLVM
 
 namespace colt
@@ -24,8 +28,19 @@ namespace colt
 
   /// @brief Enters REPL (Read Eval Print Loop) of Colt
   void REPL() noexcept;
+
+  /// @brief Depending on global arguments, links bitcode files, compiles
+  /// the input file or enters the REPL
+  void RunCompiler() noexcept;
+
+  /// @brief Stays resident and serves the compilation requests sent to a local socket.
+  /// The code generators and the JIT are only initialized once, and the ASTs
+  /// of the files that were not modified since the last request are reused.
+  /// @param socket_path The path of the socket on which to listen
+  void StartDaemon(const char* socket_path) noexcept;
   
   /// @brief Compiles a file, and depending on global arguments, uses the result.
+  /// Files with a '.cast' extension are loaded as serialized ASTs.
   /// @param path The path of the file to compile
   void CompileFile(const char* path) noexcept;
 
@@ -38,10 +53,18 @@ namespace colt
   void CompileAST(const lang::AST& ast) noexcept;
 
 #ifndef COLT_NO_LLVM
-  /// @brief Attempts to run the 'main' function from IR
+  /// @brief Attempts to run the 'main' function from IR.
+  /// The JIT is reused between calls (unless the target CPU changes),
+  /// each program being compiled in its own library.
   /// @param IR The IR to compile and in which to search for 'main' symbol
+  /// @param modules The object files of the imported modules
   /// @param print If true, prints messages
-  void RunMain(gen::GeneratedIR&& IR, bool print = true) noexcept;
+  void RunMain(gen::GeneratedIR&& IR, const Vector<String>& modules, bool print = true) noexcept;
+
+  /// @brief Links bitcode files using ThinLTO, writing the object files
+  /// to '<-o>.<n>.o' (or 'colt_lto.<n>.o').
+  /// @param files The comma separated paths of the bitcode files
+  void LinkBitcodeFiles(const char* files) noexcept;
 #endif //!COLT_NO_LLVM
 }
 
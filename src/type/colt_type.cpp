@@ -215,6 +215,64 @@ namespace colt::lang
       ));
   }
   
+  PTR<Type> ArrayType::CreateArray(PTR<const Type> array_of, u64 count, COLTContext& ctx) noexcept
+  {
+    char buffer[24];
+    auto buffer_end = fmt::format_to(buffer, "[{}]", count);
+    auto str = String{};
+    str += StringView{ buffer, buffer_end };
+    str += array_of->get_name();
+    return ctx.add_type(make_unique<ArrayType>(count * array_of->get_sizeof(), array_of->get_alignof(),
+      array_of->is_const(), array_of, count, ctx.add_str(std::move(str))
+      ));
+  }
+
+  PTR<Type> SliceType::CreateSlice(bool is_const, PTR<const Type> slice_of, COLTContext& ctx) noexcept
+  {
+    auto str = String{ "mut []" + (4 * as<u64>(is_const)) };
+    str += slice_of->get_name();
+    return ctx.add_type(make_unique<SliceType>(16, 8, is_const, slice_of,
+      ctx.add_str(std::move(str))
+      ));
+  }
+  
+  bool VecType::supports(BinaryOperator op) const noexcept
+  {
+    for (size_t i = 0; i < valid_op.get_size(); i++)
+    {
+      if (valid_op[i] == op)
+        return true;
+    }
+    return false;
+  }
+
+  bool VecType::isValidElement(PTR<const Type> type) noexcept
+  {
+    return type->is_bool() || type->is_floating()
+      || (type->is_semantically_integral() && type->get_sizeof() <= 8);
+  }
+
+  PTR<Type> VecType::CreateVec(PTR<const Type> vec_of, u64 count, COLTContext& ctx) noexcept
+  {
+    assert_true(isValidElement(vec_of) && isValidCount(count), "Invalid vector type!");
+    
+    auto valid_op = vec_of->is_floating()
+      ? ContiguousView<BinaryOperator>{ VecType::FloatingSupported, std::size(VecType::FloatingSupported) }
+      : vec_of->is_bool()
+        ? ContiguousView<BinaryOperator>{ VecType::BoolSupported, std::size(VecType::BoolSupported) }
+        : ContiguousView<BinaryOperator>{ VecType::IntegralSupported, std::size(VecType::IntegralSupported) };
+
+    auto str = String{ "vec<" };
+    str += vec_of->get_name();
+    char buffer[24];
+    auto buffer_end = fmt::format_to(buffer, ", {}>", count);
+    str += StringView{ buffer, buffer_end };
+    //Vectors are aligned on their size
+    return ctx.add_type(make_unique<VecType>(count * vec_of->get_sizeof(), count * vec_of->get_sizeof(),
+      vec_of->is_const(), as<PTR<const BuiltInType>>(vec_of), count, valid_op, ctx.add_str(std::move(str))
+      ));
+  }
+  
   PTR<Type> FnType::CreateFn(PTR<const Type> return_type, SmallVector<PTR<const Type>, 4>&& args_type, bool is_vararg, COLTContext& ctx) noexcept
   {
     auto str = String{ "fn(" };
@@ -272,8 +330,22 @@ namespace colt::lang
     case Type::TYPE_PTR:
       return PtrType::CreatePtr(true,
         as<PTR<const PtrType>>(this)->get_type_to(), ctx);
-
     case Type::TYPE_ARRAY:
+    {
+      auto arr = as<PTR<const ArrayType>>(this);
+      return ArrayType::CreateArray(arr->get_type_of()->clone_as_const(ctx),
+        arr->get_count(), ctx);
+    }
+    case Type::TYPE_SLICE:
+      return SliceType::CreateSlice(true,
+        as<PTR<const SliceType>>(this)->get_type_of(), ctx);
+    case Type::TYPE_VEC:
+    {
+      auto vec = as<PTR<const VecType>>(this);
+      return VecType::CreateVec(vec->get_type_of()->clone_as_const(ctx),
+        vec->get_count(), ctx);
+    }
+
     case Type::TYPE_CLASS:
     default:
       colt_unreachable("Invalid conversion!");
@@ -296,8 +368,22 @@ namespace colt::lang
     case Type::TYPE_PTR:
       return PtrType::CreatePtr(false,
         as<PTR<const PtrType>>(this)->get_type_to(), ctx);
-
     case Type::TYPE_ARRAY:
+    {
+      auto arr = as<PTR<const ArrayType>>(this);
+      return ArrayType::CreateArray(arr->get_type_of()->clone_as_mut(ctx),
+        arr->get_count(), ctx);
+    }
+    case Type::TYPE_SLICE:
+      return SliceType::CreateSlice(false,
+        as<PTR<const SliceType>>(this)->get_type_of(), ctx);
+    case Type::TYPE_VEC:
+    {
+      auto vec = as<PTR<const VecType>>(this);
+      return VecType::CreateVec(vec->get_type_of()->clone_as_mut(ctx),
+        vec->get_count(), ctx);
+    }
+
     case Type::TYPE_CLASS:
     default:
       colt_unreachable("Invalid conversion!");
@@ -447,6 +533,25 @@ namespace colt::lang
       return true;
     }
     case TYPE_ARRAY:
+    {
+      auto a = as<PTR<const ArrayType>>(type);
+      auto b = as<PTR<const ArrayType>>(this);
+      return a->get_count() == b->get_count()
+        && a->get_type_of()->is_equal(b->get_type_of());
+    }
+    case TYPE_SLICE:
+    {
+      auto a = as<PTR<const SliceType>>(type);
+      auto b = as<PTR<const SliceType>>(this);
+      return a->get_type_of()->is_equal(b->get_type_of());
+    }
+    case TYPE_VEC:
+    {
+      auto a = as<PTR<const VecType>>(type);
+      auto b = as<PTR<const VecType>>(this);
+      return a->get_count() == b->get_count()
+        && a->get_type_of()->is_equal(b->get_type_of());
+    }
     case TYPE_CLASS:
     default:
       colt_unreachable("Invalid type comparison!");
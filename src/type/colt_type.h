@@ -38,6 +38,10 @@ namespace colt::lang
       TYPE_FN,
       /// @brief ArrayType
       TYPE_ARRAY,
+      /// @brief SliceType
+      TYPE_SLICE,
+      /// @brief VecType
+      TYPE_VEC,
       /// @brief ClassType
       TYPE_CLASS
     };
@@ -103,6 +107,12 @@ namespace colt::lang
     /// @brief Check if the type is an array
     /// @return True if array
     bool is_array() const noexcept { return ID == TYPE_ARRAY; }
+    /// @brief Check if the type is a slice
+    /// @return True if slice
+    bool is_slice() const noexcept { return ID == TYPE_SLICE; }
+    /// @brief Check if the type is a SIMD vector
+    /// @return True if vector
+    bool is_vec() const noexcept { return ID == TYPE_VEC; }
     /// @brief Check if the type is built-in
     /// @return True if built-in
     bool is_builtin() const noexcept { return ID == TYPE_BUILTIN; }
@@ -462,6 +472,182 @@ namespace colt::lang
     static PTR<Type> CreateLString(bool is_const, COLTContext& ctx) noexcept;
   };
 
+  /// @brief Represents a fixed-size array of a type.
+  /// An array is const if its elements are const.
+  class ArrayType
+    final : public Type
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr TypeID classof_v = TYPE_ARRAY;
+
+  private:
+    /// @brief The type of the elements
+    PTR<const Type> array_of;
+    /// @brief The count of elements
+    u64 count;
+
+  public:
+    /// @brief No default constructor
+    ArrayType() = delete;
+    /// @brief Destructor
+    ~ArrayType() noexcept override = default;
+    /// @brief Creates an array type
+    /// @param is_const True if the elements are const
+    /// @param array_of The type of the elements
+    /// @param count The count of elements
+    /// @param name The type name
+    constexpr ArrayType(u64 sizeof_t, u64 alignof_t, bool is_const, PTR<const Type> array_of, u64 count, StringView name) noexcept
+      : Type(sizeof_t, alignof_t, TYPE_ARRAY, is_const, name), array_of(array_of), count(count) {}
+
+    /// @brief Returns the type of the elements of the array
+    /// @return The type of the elements
+    constexpr PTR<const Type> get_type_of() const noexcept { return array_of; }
+    /// @brief Returns the count of elements of the array
+    /// @return The count of elements
+    constexpr u64 get_count() const noexcept { return count; }
+
+    /// @brief Creates an array type
+    /// @param array_of The type of the elements
+    /// @param count The count of elements
+    /// @param ctx The COLTContext to store the resulting type
+    /// @return Pointer to the resulting type
+    static PTR<Type> CreateArray(PTR<const Type> array_of, u64 count, COLTContext& ctx) noexcept;
+  };
+
+  /// @brief Represents a view over contiguous elements (a pointer and a length)
+  class SliceType
+    final : public Type
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr TypeID classof_v = TYPE_SLICE;
+
+  private:
+    /// @brief The type of the elements
+    PTR<const Type> slice_of;
+
+  public:
+    /// @brief No default constructor
+    SliceType() = delete;
+    /// @brief Destructor
+    ~SliceType() noexcept override = default;
+    /// @brief Creates a slice type
+    /// @param is_const True if the slice is const
+    /// @param slice_of The type of the elements
+    /// @param name The type name
+    constexpr SliceType(u64 sizeof_t, u64 alignof_t, bool is_const, PTR<const Type> slice_of, StringView name) noexcept
+      : Type(sizeof_t, alignof_t, TYPE_SLICE, is_const, name), slice_of(slice_of) {}
+
+    /// @brief Returns the type of the elements of the slice
+    /// @return The type of the elements
+    constexpr PTR<const Type> get_type_of() const noexcept { return slice_of; }
+
+    /// @brief Creates a slice type
+    /// @param is_const True if the slice is const
+    /// @param slice_of The type of the elements
+    /// @param ctx The COLTContext to store the resulting type
+    /// @return Pointer to the resulting type
+    static PTR<Type> CreateSlice(bool is_const, PTR<const Type> slice_of, COLTContext& ctx) noexcept;
+  };
+
+  /// @brief Represents a SIMD vector of a built-in type.
+  /// Operators are applied element-wise, and comparisons result in a vector of 'bool'.
+  /// A vector is const if its elements are const.
+  class VecType
+    final : public Type
+  {
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr TypeID classof_v = TYPE_VEC;
+
+    /// @brief The maximum count of elements of a vector
+    static constexpr u64 MaxCount = 64;
+
+    /// @brief BinaryOperator supported by vectors of integral types
+    static constexpr BinaryOperator IntegralSupported[] = {
+      BinaryOperator::OP_SUM, BinaryOperator::OP_SUB,
+      BinaryOperator::OP_MUL, BinaryOperator::OP_DIV,
+      BinaryOperator::OP_MOD,
+      BinaryOperator::OP_EQUAL, BinaryOperator::OP_NOT_EQUAL,
+      BinaryOperator::OP_GREAT, BinaryOperator::OP_GREAT_EQUAL,
+      BinaryOperator::OP_LESS, BinaryOperator::OP_LESS_EQUAL,
+      BinaryOperator::OP_BIT_AND, BinaryOperator::OP_BIT_OR,
+      BinaryOperator::OP_BIT_XOR,
+      BinaryOperator::OP_BIT_LSHIFT, BinaryOperator::OP_BIT_RSHIFT
+    };
+
+    /// @brief BinaryOperator supported by vectors of floating point types
+    static constexpr BinaryOperator FloatingSupported[] = {
+      BinaryOperator::OP_SUM, BinaryOperator::OP_SUB,
+      BinaryOperator::OP_MUL, BinaryOperator::OP_DIV,
+      BinaryOperator::OP_EQUAL, BinaryOperator::OP_NOT_EQUAL,
+      BinaryOperator::OP_GREAT, BinaryOperator::OP_GREAT_EQUAL,
+      BinaryOperator::OP_LESS, BinaryOperator::OP_LESS_EQUAL
+    };
+
+    /// @brief BinaryOperator supported by vectors of booleans (masks).
+    /// As both sides are always evaluated, '&&' and '||' are not supported.
+    static constexpr BinaryOperator BoolSupported[] = {
+      BinaryOperator::OP_EQUAL, BinaryOperator::OP_NOT_EQUAL,
+      BinaryOperator::OP_BIT_AND, BinaryOperator::OP_BIT_OR,
+      BinaryOperator::OP_BIT_XOR
+    };
+
+  private:
+    /// @brief The type of the elements
+    PTR<const BuiltInType> vec_of;
+    /// @brief The count of elements
+    u64 count;
+    /// @brief View of array of possible binary operators
+    ContiguousView<BinaryOperator> valid_op;
+
+  public:
+    /// @brief No default constructor
+    VecType() = delete;
+    /// @brief Destructor
+    ~VecType() noexcept override = default;
+    /// @brief Creates a vector type
+    /// @param is_const True if the elements are const
+    /// @param vec_of The type of the elements
+    /// @param count The count of elements
+    /// @param valid_op Array of possible binary operator
+    /// @param name The type name
+    constexpr VecType(u64 sizeof_t, u64 alignof_t, bool is_const, PTR<const BuiltInType> vec_of, u64 count, ContiguousView<BinaryOperator> valid_op, StringView name) noexcept
+      : Type(sizeof_t, alignof_t, TYPE_VEC, is_const, name), vec_of(vec_of), count(count), valid_op(valid_op) {}
+
+    /// @brief Returns the type of the elements of the vector
+    /// @return The type of the elements
+    constexpr PTR<const BuiltInType> get_type_of() const noexcept { return vec_of; }
+    /// @brief Returns the count of elements of the vector
+    /// @return The count of elements
+    constexpr u64 get_count() const noexcept { return count; }
+
+    /// @brief Check if the current type supports 'op' BinaryOperator
+    /// @param op The operator to check for
+    /// @return True if the current type supports 'op'
+    bool supports(BinaryOperator op) const noexcept;
+
+    /// @brief Check if a type can be the type of the elements of a vector.
+    /// Only 'bool', integers of at most 64 bits, and floating points are valid.
+    /// @param type The type to check for
+    /// @return True if valid element type
+    static bool isValidElement(PTR<const Type> type) noexcept;
+
+    /// @brief Check if a count of elements is valid for a vector.
+    /// The count must be a power of 2 in the range [2, MaxCount].
+    /// @param count The count to check for
+    /// @return True if valid count
+    static constexpr bool isValidCount(u64 count) noexcept { return 2 <= count && count <= MaxCount && (count & (count - 1)) == 0; }
+
+    /// @brief Creates a vector type
+    /// @param vec_of The type of the elements (which must be valid)
+    /// @param count The count of elements (which must be valid)
+    /// @param ctx The COLTContext to store the resulting type
+    /// @return Pointer to the resulting type
+    static PTR<Type> CreateVec(PTR<const Type> vec_of, u64 count, COLTContext& ctx) noexcept;
+  };
+
   /// @brief Represents a function type
   class FnType
     final : public Type